@@ -20,6 +20,7 @@
 #include "smaug/operators/sigmoid_op.h"
 #include "smaug/operators/smv/smv_batch_norm_op.h"
 #include "smaug/operators/smv/smv_convolution_op.h"
+#include "smaug/operators/smv/smv_depthwise_convolution_op.h"
 #include "smaug/operators/smv/smv_eltwise_add_op.h"
 #include "smaug/operators/smv/smv_eltwise_mul_op.h"
 #include "smaug/operators/smv/smv_elu_op.h"
@@ -83,6 +84,7 @@ DEF_CREATE_OP(HardTanhOp, ReferenceBackend)
 DEF_CREATE_OP(PaddingOp, ReferenceBackend)
 
 DEF_CREATE_SMV_OP(ConvolutionOp)
+DEF_CREATE_SMV_OP(DepthwiseConvolutionOp)
 DEF_CREATE_SMV_OP(InnerProductOp)
 DEF_CREATE_SMV_OP(MaxPoolingOp)
 DEF_CREATE_SMV_OP(AvgPoolingOp)
@@ -101,7 +103,6 @@ DEF_CREATE_SMV_OP(LessEqualOp)
 DEF_CREATE_SMV_OP(GreaterOp)
 DEF_CREATE_SMV_OP(GreaterEqualOp)
 DEF_CREATE_OP(DataOp, SmvBackend)
-DEF_CREATE_OP(DepthwiseConvolutionOp, SmvBackend)
 DEF_CREATE_OP(ReorderOp, SmvBackend)
 DEF_CREATE_OP(ConcatOp, SmvBackend)
 DEF_CREATE_OP(SplitOp, SmvBackend)
@@ -153,6 +153,7 @@ extern float* spad2;
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 class SmvConvolutionOp;
+class SmvDepthwiseConvolutionOp;
 class SmvInnerProductOp;
 class SmvMaxPoolingOp;
 class SmvAvgPoolingOp;
@@ -216,6 +217,7 @@ class SmvBackend {
     }
 
     DECL_CREATE_SMV_OP(ConvolutionOp);
+    DECL_CREATE_SMV_OP(DepthwiseConvolutionOp);
     DECL_CREATE_SMV_OP(InnerProductOp);
     DECL_CREATE_SMV_OP(MaxPoolingOp);
     DECL_CREATE_SMV_OP(AvgPoolingOp);
@@ -234,7 +236,6 @@ class SmvBackend {
     DECL_CREATE_SMV_OP(GreaterOp);
     DECL_CREATE_SMV_OP(GreaterEqualOp);
     DECL_CREATE_OP(DataOp);
-    DECL_CREATE_OP(DepthwiseConvolutionOp);
     DECL_CREATE_OP(ReorderOp);
     DECL_CREATE_OP(ConcatOp);
     DECL_CREATE_OP(SplitOp);
@@ -22,12 +22,20 @@ BackEndConfigurator::BackEndConfigurator(int num_cpu, int num_smv){
         cpuConfs[i].memSize = DEFAULT_MEM_SIZE_CPU;
         cpuConfs[i].numPEs = DEFAULT_NUM_PE_CPU;
         cpuConfs[i].numMaccsPerPE = DEFAULT_NUM_MAC_PER_PE_CPU;
+        cpuConfs[i].clockFreq = DEFAULT_CLOCK_FREQ_CPU;
+        cpuConfs[i].memBandwidth = DEFAULT_MEM_BANDWIDTH_CPU;
+        cpuConfs[i].computeCalibration = 1;
+        cpuConfs[i].dmaCalibration = 1;
     }
 
     for (int i = 0; i < numSmv; i++) {
         smvConfs[i].memSize = (long int)DEFAULT_MEM_SIZE_SMV;
         smvConfs[i].numPEs = DEFAULT_NUM_PE_SMV;
         smvConfs[i].numMaccsPerPE = DEFAULT_NUM_MAC_PER_PE_SMV;
+        smvConfs[i].clockFreq = DEFAULT_CLOCK_FREQ_SMV;
+        smvConfs[i].memBandwidth = DEFAULT_MEM_BANDWIDTH_SMV;
+        smvConfs[i].computeCalibration = 1;
+        smvConfs[i].dmaCalibration = 1;
     }
 }
 
@@ -54,6 +62,30 @@ BackEndConfig * BackEndConfigurator::getBackEndConfig(smaug::BackEndName_t beTyp
     }
 }
 
+namespace {
+
+// Reads the PE geometry of a backend, keeping the current values if the keys
+// are not given or are not supported by the kernels.
+void parseGeometry(const boost::property_tree::ptree& pt,
+                   const std::string& section,
+                   BackEndConfig* conf) {
+    int numPEs = pt.get<int>(section + ".numPEs", conf->numPEs);
+    int numMaccsPerPE =
+            pt.get<int>(section + ".numMaccsPerPE", conf->numMaccsPerPE);
+    if (numPEs <= 0 || numPEs % VECTOR_SIZE != 0 || numMaccsPerPE <= 0 ||
+        numMaccsPerPE % VECTOR_SIZE != 0) {
+        std::cerr << "[WARNING]: " << section << ".numPEs and " << section
+                  << ".numMaccsPerPE must be multiples of " << VECTOR_SIZE
+                  << ", using " << conf->numPEs << " PEs with "
+                  << conf->numMaccsPerPE << " MACCs each.\n";
+        return;
+    }
+    conf->numPEs = numPEs;
+    conf->numMaccsPerPE = numMaccsPerPE;
+}
+
+}  // namespace
+
 void BackEndConfigurator::parseConfigFile(std::string config_file_path){
     boost::property_tree::ptree pt;
     boost::property_tree::read_ini(config_file_path, pt);
@@ -61,5 +93,38 @@ void BackEndConfigurator::parseConfigFile(std::string config_file_path){
     int mem_size = pt.get<int>("cpu.memSize");
     for (int i = 0; i < numCpu; i++) {
         cpuConfs[i].memSize = mem_size;
+        // The performance model keys are optional; keep the defaults if they
+        // are not given.
+        cpuConfs[i].clockFreq =
+                pt.get<double>("cpu.clockFreq", cpuConfs[i].clockFreq);
+        cpuConfs[i].memBandwidth =
+                pt.get<double>("cpu.memBandwidth", cpuConfs[i].memBandwidth);
+        // The Cpu backend picks the kernels that match the geometry, so the
+        // tiles and kernels agree for any multiple of the vector size.
+        parseGeometry(pt, "cpu", &cpuConfs[i]);
+    }
+    for (int i = 0; i < numSmv; i++) {
+        smvConfs[i].clockFreq =
+                pt.get<double>("smv.clockFreq", smvConfs[i].clockFreq);
+        smvConfs[i].memBandwidth =
+                pt.get<double>("smv.memBandwidth", smvConfs[i].memBandwidth);
+        smvConfs[i].computeCalibration = pt.get<double>(
+                "smv.computeCalibration", smvConfs[i].computeCalibration);
+        smvConfs[i].dmaCalibration = pt.get<double>(
+                "smv.dmaCalibration", smvConfs[i].dmaCalibration);
+        // The accelerator kernels are built for one geometry, so the tiling
+        // must use the same one.
+        parseGeometry(pt, "smv", &smvConfs[i]);
+        if (smvConfs[i].numPEs != DEFAULT_NUM_PE_SMV ||
+            smvConfs[i].numMaccsPerPE != DEFAULT_NUM_MAC_PER_PE_SMV) {
+            std::cerr << "[WARNING]: The SMV kernels are built for "
+                      << DEFAULT_NUM_PE_SMV << " PEs with "
+                      << DEFAULT_NUM_MAC_PER_PE_SMV
+                      << " MACCs each; rebuild with -DNUM_MACC_INSTS to "
+                         "change the number of MACCs. Ignoring smv.numPEs "
+                         "and smv.numMaccsPerPE.\n";
+            smvConfs[i].numPEs = DEFAULT_NUM_PE_SMV;
+            smvConfs[i].numMaccsPerPE = DEFAULT_NUM_MAC_PER_PE_SMV;
+        }
     }
 };
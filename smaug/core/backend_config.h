@@ -6,6 +6,7 @@
 #include <limits>
 
 #include "backend.h"
+#include "smaug/operators/smv/kernels/params.h"
 
 // #define DEFAULT_MEM_SIZE_CPU        ((unsigned long long)((unsigned long long)3*(unsigned long long)1024*(unsigned long long)1024*(unsigned long long)1024))
 // #define DEFAULT_MEM_SIZE_CPU        INT_MAX
@@ -15,15 +16,28 @@
 #define DEFAULT_MEM_SIZE_CPU        (128*1024)
 #define DEFAULT_NUM_PE_CPU          8
 #define DEFAULT_NUM_MAC_PER_PE_CPU  32
+#define DEFAULT_CLOCK_FREQ_CPU      2000    // MHz
+#define DEFAULT_MEM_BANDWIDTH_CPU   25.6    // GB/s
 
 #define DEFAULT_MEM_SIZE_SMV        (32*1024)
-#define DEFAULT_NUM_PE_SMV          8
-#define DEFAULT_NUM_MAC_PER_PE_SMV  32
+// The SMV kernels are built for a fixed geometry (see kernels/params.h).
+#define DEFAULT_NUM_PE_SMV          NUM_PE_INSTS
+#define DEFAULT_NUM_MAC_PER_PE_SMV  (DATA_PE_ALIGNMENT)
+#define DEFAULT_CLOCK_FREQ_SMV      1000    // MHz
+#define DEFAULT_MEM_BANDWIDTH_SMV   25.6    // GB/s
 
 struct BackEndConfig {
     unsigned long long memSize;
     int numPEs;
     int numMaccsPerPE;
+    // Clock frequency in MHz, used to derive the peak compute throughput.
+    double clockFreq;
+    // Host memory bandwidth in GB/s seen by the backend.
+    double memBandwidth;
+    // Ratios of measured (e.g. sampled gem5) to modeled cycles, applied to
+    // the compute and DMA cycles of --estimate.
+    double computeCalibration;
+    double dmaCalibration;
 };
 
 class BackEndConfigurator {
@@ -49,6 +49,10 @@ template <>
 struct ToDataType<bool> {
     static const DataType dataType = Bool;
 };
+template <>
+struct ToDataType<int8_t> {
+    static const DataType dataType = Int8;
+};
 
 /**
  * Provides compile-time conversion from SMAUG DataType to C type.
@@ -82,6 +86,10 @@ template<>
 struct FromDataType<Bool> {
     typedef bool type;
 };
+template<>
+struct FromDataType<Int8> {
+    typedef int8_t type;
+};
 
 }  // namespace smaug
 
@@ -3,8 +3,10 @@
 namespace smaug {
 bool runningInSimulation;
 bool fastForwardMode = true;
+bool estimateMode = false;
 int numAcceleratorsAvailable;
 int numThreads;
 ThreadPool* threadPool = nullptr;
 bool useSystolicArrayWhenAvailable;
+bool useInt8WhenAvailable = false;
 }  // namespace smaug
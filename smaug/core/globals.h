@@ -18,6 +18,13 @@ extern bool runningInSimulation;
 /** True if we are simulating in fast-forward mode. */
 extern bool fastForwardMode;
 
+/**
+ * If true, the SMV tile dispatchers walk the tiled schedule without invoking
+ * any kernels, and record modeled cycles instead. The output values of the
+ * network are meaningless in this mode.
+ */
+extern bool estimateMode;
+
 /**
  * The maximum number of accelerators an operator's work can be split across.
  * This limit exists to keep Aladdin simulation time and resources in check.
@@ -45,6 +52,12 @@ extern ThreadPool* threadPool;
  */
 extern bool useSystolicArrayWhenAvailable;
 
+/**
+ * If true, the Cpu backend runs convolutions and inner products with int8
+ * weights and activations, using per-channel weight scales.
+ */
+extern bool useInt8WhenAvailable;
+
 }  // namespace smaug
 
 #endif
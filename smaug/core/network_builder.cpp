@@ -37,6 +37,7 @@
 #include "smaug/operators/sigmoid_op.h"
 #include "smaug/operators/smv/smv_batch_norm_op.h"
 #include "smaug/operators/smv/smv_convolution_op.h"
+#include "smaug/operators/smv/smv_depthwise_convolution_op.h"
 #include "smaug/operators/smv/smv_eltwise_add_op.h"
 #include "smaug/operators/smv/smv_eltwise_mul_op.h"
 #include "smaug/operators/smv/smv_elu_op.h"
@@ -545,6 +546,50 @@ static void createAndAddOperator(const NodeProto& node,
     }
 }
 
+// Make the inputs of every concat views into their slices of its output
+// wherever the layouts allow it, so that the producers write the concatenated
+// output directly and the concat itself copies nothing. The concats are
+// visited from the end of the network back, so that nested concats alias all
+// the way into the outermost output. Inputs fed by data operators hold
+// weights or network inputs and are left as they are.
+template <typename Backend>
+static void aliasConcatInputs(Network* network) {
+    const Graph& graph = network->getGraph();
+    EdgeNameMap edges = get(boost::edge_name, graph);
+    std::vector<Vertex> vertices;
+    boost::topological_sort(graph, std::back_inserter(vertices));
+    for (auto v : vertices) {
+        Operator* op = get(boost::vertex_op, graph, v);
+        if (op->getOpType() != OpType::Concat)
+            continue;
+        auto concatOp = dynamic_cast<ConcatOp<Backend>*>(op);
+        if (!concatOp)
+            continue;
+        in_edge_iter inEdgeIt, inEdgeEnd;
+        for (boost::tie(inEdgeIt, inEdgeEnd) = in_edges(v, graph);
+             inEdgeIt != inEdgeEnd;
+             ++inEdgeIt) {
+            Operator* producer =
+                    get(boost::vertex_op, graph, source(*inEdgeIt, graph));
+            if (producer->getOpType() == OpType::Data)
+                continue;
+            concatOp->aliasInput(edges[*inEdgeIt].destIdx);
+        }
+    }
+}
+
+// Let every operator make its outputs views into its inputs where it can
+// (see Operator::aliasOutputs()). The operators are visited in topological
+// order, so that the input of a view is final by the time it is aliased. The
+// outputs that are already aliased into a concat keep being copied.
+static void aliasOperatorOutputs(Network* network) {
+    const Graph& graph = network->getGraph();
+    std::list<Vertex> vertices;
+    boost::topological_sort(graph, std::front_inserter(vertices));
+    for (auto v : vertices)
+        get(boost::vertex_op, graph, v)->aliasOutputs();
+}
+
 // Create the network by deserializing the graph stored in the
 // protobuf model.
 template <typename Backend>
@@ -596,6 +641,8 @@ static Network* createNetworkFromProto(const GraphProto& graphProto,
             child->setInput(op->getOutput(indices.srcIdx), indices.destIdx);
         }
     }
+    aliasConcatInputs<Backend>(network);
+    aliasOperatorOutputs(network);
 
     return network;
 }
@@ -663,6 +710,8 @@ static Network* createNetworkFromProto(const GraphProto& graphProto,
             child->setInput(op->getOutput(indices.srcIdx), indices.destIdx);
         }
     }
+    aliasConcatInputs<Backend>(network);
+    aliasOperatorOutputs(network);
 
     return network;
 }
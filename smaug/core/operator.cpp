@@ -13,6 +13,38 @@ bool Operator::isDead() {
     return anyInputDead;
 }
 
+int64_t Operator::getMinBytesMoved() const {
+    int64_t bytes = 0;
+    for (auto tensor : inputs) {
+        if (tensor)
+            bytes += static_cast<int64_t>(tensor->getShape().size()) *
+                     tensor->getDataTypeSize();
+    }
+    for (auto tensor : outputs) {
+        if (tensor)
+            bytes += static_cast<int64_t>(tensor->getShape().size()) *
+                     tensor->getDataTypeSize();
+    }
+    return bytes;
+}
+
+void Operator::recordKernelEstimate(int accelIdx, int64_t computeCycles) {
+    if (accelIdx >= accelEstimates.size())
+        accelEstimates.resize(accelIdx + 1);
+    AccelEstimate& estimate = accelEstimates[accelIdx];
+    estimate.numInvocations++;
+    estimate.computeCycles += computeCycles;
+    estimate.dmaBytes += pendingDmaBytes;
+    pendingDmaBytes = 0;
+}
+
+void Operator::resetPerfCounters() {
+    bytesMoved = 0;
+    pendingDmaBytes = 0;
+    accelEstimates.clear();
+    runTime = 0;
+}
+
 void Operator::printSummary(std::ostream& out) const {
     boost::format fmter(kLayerFormat);
     out << fmter % (this->name + " (" + OpType_Name(opType) + ")") %
@@ -25,14 +25,25 @@ class Workspace;
 
 constexpr const char* kLayerFormat = "%-40s %-25s %=15d\n";
 
+/** The modeled work of one accelerator during an Operator run (--estimate). */
+struct AccelEstimate {
+    int numInvocations = 0;
+    int64_t computeCycles = 0;
+    /** Bytes transferred by the DMA of this accelerator. */
+    int64_t dmaBytes = 0;
+};
+
 /**
  * Operator is the base class for all graph operators supported by SMAUG.
  */
 class Operator {
    public:
     Operator(const std::string& _name, OpType _opType, Workspace* _workspace)
-            : name(_name), opType(_opType), workspace(_workspace),
-              numPendingInputs(-1) {}
+            : name(_name), opType(_opType), backEnd(Smv), numCores(1),
+              memSize(DEFAULT_MEM_SIZE_SMV), numPEs(DEFAULT_NUM_PE_SMV),
+              numMaccsPerPE(DEFAULT_NUM_MAC_PER_PE_SMV), workspace(_workspace),
+              numPendingInputs(-1), bytesMoved(0), pendingDmaBytes(0),
+              runTime(0) {}
     virtual ~Operator() {}
 
     virtual void tile() {};
@@ -72,6 +83,17 @@ class Operator {
      */
     virtual void createAllTensors() {}
 
+    /**
+     * Makes the outputs of this Operator views into the storage of its inputs
+     * wherever the layouts allow it, so that run() has nothing to copy for
+     * them.
+     *
+     * The network builder calls this once all the Tensors are allocated and
+     * connected. Operators that only move data around, like reshapes and
+     * splits, override it; it does nothing by default.
+     */
+    virtual void aliasOutputs() {}
+
     /**
      * Returns true if the Operator is dead.
      *
@@ -90,10 +112,62 @@ class Operator {
 
     /** This returns the number of parameterizable weights in the operator. */
     virtual int getNumParameters() const { return 0; }
+
+    /**
+     * Returns the number of arithmetic operations performed by one run of the
+     * operator, where a multiply-accumulate counts as two.
+     */
+    virtual int64_t getNumFlops() const { return 0; }
+
+    /**
+     * Returns the compulsory memory traffic of the operator in bytes, i.e. all
+     * the input and output Tensors moved exactly once.
+     */
+    virtual int64_t getMinBytesMoved() const;
+
     virtual bool isSamplingSupported() const { return false; }
     virtual void setSamplingInfo(const SamplingInfo& sampling) {}
 
     void printSummary(std::ostream& out) const;
+
+    /**
+     * Accounts for a tile sent to or received from the backend by a tile
+     * dispatcher. Tiles that are read more than once must be recorded on every
+     * read, so halo regions and re-reads show up in getBytesMoved().
+     */
+    void recordTileTransfer(const Tensor* tile) {
+        int64_t bytes = static_cast<int64_t>(tile->getShape().storageSize()) *
+                        tile->getDataTypeSize();
+        bytesMoved += bytes;
+        pendingDmaBytes += bytes;
+    }
+    /**
+     * Returns the bytes recorded by recordTileTransfer(). This is zero if the
+     * operator does not dispatch tiles.
+     */
+    int64_t getBytesMoved() const { return bytesMoved; }
+
+    /**
+     * Returns true if the kernels of this operator are modeled instead of run,
+     * i.e. we are in --estimate mode and the operator runs on the SMV backend.
+     */
+    bool isEstimating() const { return estimateMode && backEnd == Smv; }
+    /**
+     * Called by tile dispatchers in place of invoking a kernel in --estimate
+     * mode. The tiles recorded by recordTileTransfer() since the previous
+     * invocation are charged to the DMA of the same accelerator.
+     */
+    void recordKernelEstimate(int accelIdx, int64_t computeCycles);
+    /** Returns the modeled work of every accelerator used by the last run(). */
+    const std::vector<AccelEstimate>& getAccelEstimates() const {
+        return accelEstimates;
+    }
+    /** Clears the traffic, estimates and run time of the previous run(). */
+    void resetPerfCounters();
+    /** Sets the measured wall-clock time of the last run() in seconds. */
+    void setRunTime(double seconds) { runTime = seconds; }
+    double getRunTime() const { return runTime; }
+
     void setInput(TensorBase* op, int index) { inputs[index] = op; }
     void setOutput(TensorBase* op, int index) { outputs[index] = op; }
 
@@ -174,6 +248,14 @@ class Operator {
     MemoryType weightsMemType;
     /** The memory interface over which outputs are expected to be delivered. */
     MemoryType outputsMemType;
+    /** Bytes moved between the host and the backend in the last run(). */
+    int64_t bytesMoved;
+    /** Bytes recorded since the last recordKernelEstimate(). */
+    int64_t pendingDmaBytes;
+    /** Per-accelerator modeled work of the last run(), indexed by accelIdx. */
+    std::vector<AccelEstimate> accelEstimates;
+    /** Wall-clock time of the last run() in seconds. */
+    double runTime;
 };
 
 }  // namespace smaug
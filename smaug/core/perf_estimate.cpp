@@ -0,0 +1,85 @@
+#include <cmath>
+#include <list>
+#include <string>
+#include <boost/format.hpp>
+
+#include "smaug/core/perf_estimate.h"
+
+namespace smaug {
+
+namespace {
+
+constexpr const char* kEstimateFormat =
+        "%-40s %-8s %6d %8d %14d %14d %12.4f\n";
+constexpr const char* kEstimateHeaderFormat =
+        "%-40s %-8s %6s %8s %14s %14s %12s\n";
+
+}  // namespace
+
+LayerEstimate getLayerEstimate(Operator* op,
+                               BackEndConfigurator* backEndConfig) {
+    LayerEstimate estimate;
+    const std::vector<AccelEstimate>& accels = op->getAccelEstimates();
+    if (accels.empty()) {
+        estimate.latency = op->getRunTime();
+        return estimate;
+    }
+    BackEndConfig* config = backEndConfig->getBackEndConfig(op->getBackEnd(), 0);
+    double cyclesPerSec = config->clockFreq * 1e6;
+    double bytesPerCycle = config->memBandwidth * 1e9 / cyclesPerSec;
+    estimate.modeled = true;
+    for (const AccelEstimate& accel : accels) {
+        if (accel.numInvocations == 0)
+            continue;
+        estimate.numAccels++;
+        estimate.numInvocations += accel.numInvocations;
+        int64_t computeCycles = std::llround(accel.computeCycles *
+                                             config->computeCalibration);
+        int64_t dmaCycles = std::llround(accel.dmaBytes / bytesPerCycle *
+                                         config->dmaCalibration);
+        if (computeCycles + dmaCycles > estimate.getCycles()) {
+            estimate.computeCycles = computeCycles;
+            estimate.dmaCycles = dmaCycles;
+        }
+    }
+    estimate.latency = estimate.getCycles() / cyclesPerSec;
+    return estimate;
+}
+
+void printEstimateReport(const Network* network,
+                         BackEndConfigurator* backEndConfig,
+                         std::ostream& out) {
+    static const std::string hline(std::string(110, '_'));
+    const Graph& graph = network->getGraph();
+    std::list<Vertex> vertices;
+    boost::topological_sort(graph, std::front_inserter(vertices));
+    out << hline << "\n";
+    out << boost::format(kEstimateHeaderFormat) % "Layer (type)" % "Source" %
+                    "Accels" % "Invokes" % "Compute cyc" % "DMA cyc" %
+                    "Time (ms)";
+    out << hline << "\n";
+    double totalLatency = 0, modeledLatency = 0;
+    for (auto vertex : vertices) {
+        Operator* op = get(boost::vertex_op, graph, vertex);
+        if (op->getOpType() == OpType::Data)
+            continue;
+        LayerEstimate estimate = getLayerEstimate(op, backEndConfig);
+        out << boost::format(kEstimateFormat) %
+                        (op->getName() + " (" + OpType_Name(op->getOpType()) +
+                         ")") %
+                        (estimate.modeled ? "model" : "measured") %
+                        estimate.numAccels % estimate.numInvocations %
+                        estimate.computeCycles % estimate.dmaCycles %
+                        (estimate.latency * 1e3);
+        totalLatency += estimate.latency;
+        if (estimate.modeled)
+            modeledLatency += estimate.latency;
+    }
+    out << hline << "\n";
+    out << boost::format("Estimated total latency: %.4f ms (%.4f ms modeled, "
+                         "%.4f ms measured)\n") %
+                   (totalLatency * 1e3) % (modeledLatency * 1e3) %
+                   ((totalLatency - modeledLatency) * 1e3);
+}
+
+}  // namespace smaug
@@ -0,0 +1,54 @@
+#ifndef _CORE_PERF_ESTIMATE_H_
+#define _CORE_PERF_ESTIMATE_H_
+
+#include <iostream>
+
+#include "smaug/core/backend_config.h"
+#include "smaug/core/network.h"
+#include "smaug/core/operator.h"
+
+namespace smaug {
+
+/**
+ * The estimated latency of one Operator run in --estimate mode.
+ *
+ * Every SMV kernel invocation is modeled as its DMA transfers followed by its
+ * compute, as the kernels do not overlap the two. Invocations on the same
+ * accelerator are serialized, while the accelerators of the pool run in
+ * parallel, so the latency of the layer is that of the busiest accelerator.
+ *
+ * Operators without a model (e.g. on the reference backend) report their
+ * measured run time instead.
+ */
+struct LayerEstimate {
+    /** True if the latency comes from the cycle model. */
+    bool modeled = false;
+    int numAccels = 0;
+    int numInvocations = 0;
+    /** Calibrated compute and DMA cycles of the busiest accelerator. */
+    int64_t computeCycles = 0;
+    int64_t dmaCycles = 0;
+    /** Estimated latency in seconds. */
+    double latency = 0;
+
+    int64_t getCycles() const { return computeCycles + dmaCycles; }
+};
+
+/**
+ * Computes the estimate of an Operator after it has run, using the clock,
+ * bandwidth and calibration factors of its backend.
+ */
+LayerEstimate getLayerEstimate(Operator* op,
+                               BackEndConfigurator* backEndConfig);
+
+/**
+ * Prints the per-layer and total latency estimates of the Network in
+ * topological order.
+ */
+void printEstimateReport(const Network* network,
+                         BackEndConfigurator* backEndConfig,
+                         std::ostream& out = std::cout);
+
+}  // namespace smaug
+
+#endif
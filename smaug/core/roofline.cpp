@@ -0,0 +1,99 @@
+#include <list>
+#include <string>
+#include <boost/format.hpp>
+
+#include "smaug/core/roofline.h"
+
+namespace smaug {
+
+namespace {
+
+constexpr const char* kRooflineFormat =
+        "%-36s %-4s %10.4f %10.3f %10.3f %8.2f %8.2f %10.3f %9.2f %9.2f "
+        "%9.2f %6.1f %-7s\n";
+constexpr const char* kRooflineHeaderFormat =
+        "%-36s %-4s %10s %10s %10s %8s %8s %10s %9s %9s %9s %6s %-7s\n";
+
+std::string backEndToStr(BackEndName_t backEnd) {
+    switch (backEnd) {
+        case Reference:
+            return "REF";
+        case Smv:
+            return "SMV";
+        case Cpu:
+            return "CPU";
+        default:
+            return "?";
+    }
+}
+
+}  // namespace
+
+RooflinePoint getRooflinePoint(Operator* op,
+                               BackEndConfigurator* backEndConfig) {
+    BackEndConfig* config = backEndConfig->getBackEndConfig(op->getBackEnd(), 0);
+    RooflinePoint point;
+    point.flops = op->getNumFlops();
+    point.minBytes = op->getMinBytesMoved();
+    // Operators that don't dispatch tiles move their tensors exactly once.
+    point.actualBytes = op->getBytesMoved() > 0 ? op->getBytesMoved()
+                                                : point.minBytes;
+    double maccsPerCycle = static_cast<double>(op->getNumCores()) *
+                           op->getNumPEs() * op->getNumMaccsPerPE();
+    point.peakFlops = 2 * maccsPerCycle * config->clockFreq * 1e6;
+    point.peakBandwidth = config->memBandwidth * 1e9;
+    point.runTime = op->getRunTime();
+    return point;
+}
+
+void printRooflineReport(const Network* network,
+                         BackEndConfigurator* backEndConfig,
+                         std::ostream& out) {
+    static const std::string hline(std::string(152, '_'));
+    const Graph& graph = network->getGraph();
+    std::list<Vertex> vertices;
+    boost::topological_sort(graph, std::front_inserter(vertices));
+    out << hline << "\n";
+    out << boost::format(kRooflineHeaderFormat) % "Layer (type)" % "BE" %
+                    "GFLOP" % "Min MB" % "Actual MB" % "AI min" % "AI" %
+                    "Time (ms)" % "GFLOP/s" % "Roof" % "Peak" % "Eff %" %
+                    "Bound";
+    out << hline << "\n";
+    int64_t totalFlops = 0, totalMinBytes = 0, totalBytes = 0;
+    double totalTime = 0;
+    for (auto vertex : vertices) {
+        Operator* op = get(boost::vertex_op, graph, vertex);
+        if (op->getOpType() == OpType::Data)
+            continue;
+        RooflinePoint point = getRooflinePoint(op, backEndConfig);
+        double attainable = point.getAttainableFlops();
+        double achieved = point.getAchievedFlops();
+        out << boost::format(kRooflineFormat) %
+                        (op->getName() + " (" + OpType_Name(op->getOpType()) +
+                         ")") %
+                        backEndToStr(op->getBackEnd()) % (point.flops / 1e9) %
+                        (point.minBytes / 1e6) % (point.actualBytes / 1e6) %
+                        point.getMinIntensity() % point.getIntensity() %
+                        (point.runTime * 1e3) % (achieved / 1e9) %
+                        (attainable / 1e9) % (point.peakFlops / 1e9) %
+                        (attainable > 0 ? 100 * achieved / attainable : 0) %
+                        (point.isMemoryBound() ? "memory" : "compute");
+        totalFlops += point.flops;
+        totalMinBytes += point.minBytes;
+        totalBytes += point.actualBytes;
+        totalTime += point.runTime;
+    }
+    out << hline << "\n";
+    out << boost::format(
+                   "Total: %.4f GFLOP, %.3f MB compulsory, %.3f MB actual "
+                   "(%.2fx), %.3f ms, %.2f GFLOP/s\n") %
+                   (totalFlops / 1e9) % (totalMinBytes / 1e6) %
+                   (totalBytes / 1e6) %
+                   (totalMinBytes > 0
+                            ? static_cast<double>(totalBytes) / totalMinBytes
+                            : 0) %
+                   (totalTime * 1e3) %
+                   (totalTime > 0 ? totalFlops / totalTime / 1e9 : 0);
+}
+
+}  // namespace smaug
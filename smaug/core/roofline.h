@@ -0,0 +1,76 @@
+#ifndef _CORE_ROOFLINE_H_
+#define _CORE_ROOFLINE_H_
+
+#include <iostream>
+
+#include "smaug/core/backend_config.h"
+#include "smaug/core/network.h"
+#include "smaug/core/operator.h"
+
+namespace smaug {
+
+/**
+ * The position of one Operator on the roofline of the backend it ran on.
+ *
+ * The compulsory traffic (minBytes) assumes every input and output is moved
+ * exactly once. The actual traffic is what the tile dispatcher sent to and
+ * received from the backend, so it includes tile re-reads and halo overlap
+ * caused by the chosen tiling.
+ */
+struct RooflinePoint {
+    int64_t flops;
+    int64_t minBytes;
+    int64_t actualBytes;
+    /** Peak compute throughput of the backend in FLOP/s. */
+    double peakFlops;
+    /** Peak host memory bandwidth of the backend in bytes/s. */
+    double peakBandwidth;
+    /** Measured time of the operator in seconds. */
+    double runTime;
+
+    /** Arithmetic intensity (FLOP/byte) under compulsory traffic only. */
+    double getMinIntensity() const {
+        return minBytes > 0 ? static_cast<double>(flops) / minBytes : 0;
+    }
+    /** Arithmetic intensity (FLOP/byte) under the actual tile traffic. */
+    double getIntensity() const {
+        return actualBytes > 0 ? static_cast<double>(flops) / actualBytes : 0;
+    }
+    /** The throughput attainable under the roofline at getIntensity(). */
+    double getAttainableFlops() const {
+        return std::min(peakFlops, getIntensity() * peakBandwidth);
+    }
+    /** The throughput actually achieved by the measured run. */
+    double getAchievedFlops() const {
+        return runTime > 0 ? flops / runTime : 0;
+    }
+    /**
+     * Returns true if the actual traffic puts the operator left of the ridge
+     * point, i.e. better tiling rather than a faster kernel would help.
+     */
+    bool isMemoryBound() const {
+        return getIntensity() * peakBandwidth < peakFlops;
+    }
+};
+
+/**
+ * Computes the roofline point of an Operator after it has run.
+ *
+ * The peak compute throughput is numCores * numPEs * numMaccsPerPE MACCs per
+ * cycle at the backend's clock frequency; the peak bandwidth and clock come
+ * from the BackEndConfigurator.
+ */
+RooflinePoint getRooflinePoint(Operator* op,
+                               BackEndConfigurator* backEndConfig);
+
+/**
+ * Prints a per-layer roofline table of the Network (in topological order)
+ * with arithmetic intensity and achieved vs. attainable throughput.
+ */
+void printRooflineReport(const Network* network,
+                         BackEndConfigurator* backEndConfig,
+                         std::ostream& out = std::cout);
+
+}  // namespace smaug
+
+#endif
@@ -0,0 +1,96 @@
+#include "catch.hpp"
+#include "smaug/core/backend.h"
+#include "smaug/core/backend_config.h"
+#include "smaug/core/roofline.h"
+#include "smaug/core/smaug_test.h"
+#include "smaug/core/tensor.h"
+#include "smaug/operators/smv/smv_convolution_op.h"
+#include "smaug/operators/smv/smv_test_common.h"
+
+using namespace smaug;
+
+namespace smaug {
+
+class RooflineTest : public SmaugTest {
+   public:
+    using SmaugTest::SmaugTest;
+
+    SmvConvolutionOp* buildConvOp(std::vector<int> inputDims,
+                                  std::vector<int> kernelDims) {
+        auto convOp = new SmvConvolutionOp("conv", workspace());
+        convOp->setBackEnd(Cpu);
+        convOp->setNumCores(1);
+        convOp->setMemSize(DEFAULT_MEM_SIZE_SMV);
+        convOp->setNumPEs(DEFAULT_NUM_PE_SMV);
+        convOp->setNumMaccsPerPE(DEFAULT_NUM_MAC_PER_PE_SMV);
+        convOp->setStride(1, 1);
+        convOp->setPadding(SamePadding);
+        TensorShape inputShape(inputDims, NHWC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("input", inputShape);
+        inputs->allocateStorage<float16>();
+        workspace()->addTensor(inputs);
+        convOp->setInput(inputs, 0);
+        convOp->setWeightDims(kernelDims[1], kernelDims[2], kernelDims[0]);
+        createAndFillTensorsWithData<float16>(convOp, fillTensorWithRandomData);
+        return convOp;
+    }
+};
+
+}  // namespace smaug
+
+TEST_CASE_METHOD(RooflineTest, "Roofline accounting", "[roofline]") {
+    SECTION("Convolution without tiling moves every byte once") {
+        auto convOp = buildConvOp({ 1, 8, 8, 8 }, { 8, 3, 3, 8 });
+        convOp->tile();
+        convOp->run();
+        REQUIRE(convOp->getNumFlops() == 2 * (8 * 8 * 8) * (3 * 3 * 8));
+        // Inputs, weights and outputs, all in fp16.
+        REQUIRE(convOp->getMinBytesMoved() == 2 * (512 + 576 + 512));
+        REQUIRE(convOp->getBytesMoved() == convOp->getMinBytesMoved());
+    }
+
+    SECTION("Rowwise tiling re-reads the halo rows") {
+        // 3x3 stride-1 layers take the Winograd path on the Cpu backend,
+        // which does not tile, so use a 5x5 kernel here.
+        auto convOp = buildConvOp({ 1, 32, 32, 32 }, { 32, 5, 5, 32 });
+        convOp->tile();
+        convOp->run();
+        REQUIRE(convOp->getBytesMoved() > convOp->getMinBytesMoved());
+    }
+
+    SECTION("Peak throughput comes from the backend configuration") {
+        auto convOp = buildConvOp({ 1, 8, 8, 8 }, { 8, 3, 3, 8 });
+        convOp->tile();
+        convOp->run();
+        convOp->setRunTime(1e-3);
+        BackEndConfigurator backEndConfig(1, 1);
+        RooflinePoint point = getRooflinePoint(convOp, &backEndConfig);
+        REQUIRE(point.flops == convOp->getNumFlops());
+        REQUIRE(point.actualBytes == convOp->getBytesMoved());
+        REQUIRE(point.peakFlops ==
+                Approx(2.0 * DEFAULT_NUM_PE_SMV * DEFAULT_NUM_MAC_PER_PE_SMV *
+                       DEFAULT_CLOCK_FREQ_CPU * 1e6));
+        REQUIRE(point.peakBandwidth == Approx(DEFAULT_MEM_BANDWIDTH_CPU * 1e9));
+        REQUIRE(point.getAchievedFlops() ==
+                Approx(convOp->getNumFlops() / 1e-3));
+    }
+
+    SECTION("Attainable throughput is capped by bandwidth or compute") {
+        RooflinePoint point;
+        point.flops = 1000000000;
+        point.minBytes = 50000000;
+        point.actualBytes = 100000000;
+        point.peakFlops = 512e9;
+        point.peakBandwidth = 25.6e9;
+        point.runTime = 0.01;
+        REQUIRE(point.getMinIntensity() == Approx(20));
+        REQUIRE(point.getIntensity() == Approx(10));
+        REQUIRE(point.isMemoryBound());
+        REQUIRE(point.getAttainableFlops() == Approx(256e9));
+        REQUIRE(point.getAchievedFlops() == Approx(100e9));
+
+        point.actualBytes = point.minBytes / 2;
+        REQUIRE_FALSE(point.isMemoryBound());
+        REQUIRE(point.getAttainableFlops() == Approx(512e9));
+    }
+}
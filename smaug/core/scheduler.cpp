@@ -1,3 +1,4 @@
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -71,7 +72,12 @@ Tensor* Scheduler::scheduleReady() {
 
 void Scheduler::maybeRunOperator(Operator* op) {
     if (!op->isDead()) {
+        op->resetPerfCounters();
+        auto start = std::chrono::steady_clock::now();
         op->run();
+        std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+        op->setRunTime(elapsed.count());
     } else {
         for (auto output : op->getOutputs())
             output->setDead();
@@ -55,6 +55,13 @@ TensorProto* Tensor::asTensorProto() {
             memcpy(protoData->mutable_bool_data()->mutable_data(), rawPtr,
                    shape.storageSize() * sizeof(bool));
             break;
+        case Int8:
+            // Round up to cover storage sizes that are not a multiple of 4.
+            protoData->mutable_int8_data()->Resize(
+                    (shape.storageSize() + 3) / 4, 0);
+            memcpy(protoData->mutable_int8_data()->mutable_data(), rawPtr,
+                   shape.storageSize() * sizeof(int8_t));
+            break;
         default:
             assert(false && "Unknown data type!");
     }
@@ -69,7 +76,7 @@ Tensor* TiledTensor::getTileWithData(int index) {
 }
 
 void TiledTensor::setTile(int index,
-                          const std::vector<int>& origin,
+                          const TensorDims& origin,
                           Tensor* tensor,
                           bool copyData) {
     Tile* tile = &tiles[index];
@@ -143,7 +150,7 @@ void TiledTensor::copyDataToTile(Tile* tile) {
         copyRawTensorData(tile->tensor, origTensor, 0, tile->origin[0],
                           tile->tensor->getShape().storageSize());
     } else {
-        std::vector<int> dstOrigin(tile->tensor->ndims(), 0);
+        TensorDims dstOrigin(tile->tensor->ndims(), 0);
         copyTensorRegion(tile->tensor, origTensor, dstOrigin, tile->origin,
                          tile->tensor->getShape().dims());
     }
@@ -177,7 +184,7 @@ void TiledTensor::gatherDataFromTile(Tile* tile) {
         copyRawTensorData(origTensor, tile->tensor, tile->origin[0], 0,
                           tile->tensor->getShape().storageSize());
     } else {
-        std::vector<int> srcOrigin(tile->tensor->ndims(), 0);
+        TensorDims srcOrigin(tile->tensor->ndims(), 0);
         copyTensorRegion(origTensor,
                          tile->tensor,
                          tile->origin,
@@ -1,6 +1,7 @@
 #ifndef _CORE_TENSOR_H_
 #define _CORE_TENSOR_H_
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cmath>
@@ -17,6 +18,89 @@
 
 namespace smaug {
 
+/**
+ * A small array of up to kMaxRank ints, used for the dimensions, padding and
+ * coordinates of a Tensor.
+ *
+ * The elements are stored inline, so unlike std::vector, creating or copying
+ * a TensorDims never allocates memory. Tiling creates and copies shapes and
+ * iterators for every tile, which otherwise shows up as allocator traffic on
+ * networks with many tiles. TensorDims converts to and from std::vector<int>
+ * implicitly.
+ */
+class TensorDims {
+   public:
+    /** The maximum number of dimensions of a Tensor. */
+    static constexpr int kMaxRank = 6;
+
+    typedef int value_type;
+    typedef int* iterator;
+    typedef const int* const_iterator;
+
+    TensorDims() : rank(0) {}
+    /** Creates a TensorDims of the given rank, with all elements at value. */
+    explicit TensorDims(int _rank, int value = 0) : rank(_rank) {
+        assert(rank <= kMaxRank && "Tensors of this rank are not supported!");
+        for (int i = 0; i < rank; i++)
+            elems[i] = value;
+    }
+    TensorDims(std::initializer_list<int> values) : rank(0) {
+        for (int value : values)
+            push_back(value);
+    }
+    TensorDims(const std::vector<int>& values) : rank(0) {
+        for (int value : values)
+            push_back(value);
+    }
+
+    operator std::vector<int>() const { return { begin(), end() }; }
+
+    int size() const { return rank; }
+    bool empty() const { return rank == 0; }
+    int operator[](int index) const { return elems[index]; }
+    int& operator[](int index) { return elems[index]; }
+    int back() const { return elems[rank - 1]; }
+    iterator begin() { return elems; }
+    iterator end() { return elems + rank; }
+    const_iterator begin() const { return elems; }
+    const_iterator end() const { return elems + rank; }
+
+    void push_back(int value) {
+        assert(rank < kMaxRank && "Tensors of this rank are not supported!");
+        elems[rank++] = value;
+    }
+
+    /** Changes the rank. New elements are set to value. */
+    void resize(int _rank, int value = 0) {
+        assert(_rank <= kMaxRank && "Tensors of this rank are not supported!");
+        for (int i = rank; i < _rank; i++)
+            elems[i] = value;
+        rank = _rank;
+    }
+
+    bool operator==(const TensorDims& other) const {
+        return rank == other.rank && std::equal(begin(), end(), other.begin());
+    }
+    bool operator!=(const TensorDims& other) const { return !(*this == other); }
+    bool operator==(const std::vector<int>& other) const {
+        return rank == (int)other.size() &&
+               std::equal(begin(), end(), other.begin());
+    }
+    bool operator!=(const std::vector<int>& other) const {
+        return !(*this == other);
+    }
+    friend bool operator==(const std::vector<int>& a, const TensorDims& b) {
+        return b == a;
+    }
+    friend bool operator!=(const std::vector<int>& a, const TensorDims& b) {
+        return b != a;
+    }
+
+   protected:
+    int elems[kMaxRank];
+    int rank;
+};
+
 /**
  * TensorShape describes the shape of a Tensor.
  *
@@ -35,7 +119,9 @@ namespace smaug {
 class TensorShape {
    public:
     TensorShape() : layout(DataLayout::UnknownLayout) {}
-    TensorShape(std::vector<int> _dims, DataLayout _layout, int _alignment = 0)
+    TensorShape(const TensorDims& _dims,
+                DataLayout _layout,
+                int _alignment = 0)
             : dims_(_dims), padding_(dims_.size()), layout(_layout),
               alignment(_alignment) {
         computePadding();
@@ -51,18 +137,17 @@ class TensorShape {
             : dims_(shape.dims_), padding_(shape.padding_),
               layout(shape.layout), alignment(shape.alignment) {}
     TensorShape(const TensorShapeProto& shapeProto) {
-        std::copy(shapeProto.dims().begin(),
-                  shapeProto.dims().end(),
-                  std::back_inserter(dims_));
+        for (int dim : shapeProto.dims())
+            dims_.push_back(dim);
         padding_.resize(shapeProto.dims_size());
         layout = shapeProto.layout();
         alignment = shapeProto.alignment();
         computePadding();
     }
 
-    const std::vector<int>& dims() const { return dims_; }
+    const TensorDims& dims() const { return dims_; }
     /** Returns a vector of padding along each dimension. */
-    const std::vector<int>& padding() const { return padding_; }
+    const TensorDims& padding() const { return padding_; }
     int operator[](int index) const { return dims_[getIndex(index)]; }
     int& operator[](int index) { return dims_[getIndex(index)]; }
     /** Returns the alignment-padded size of the specified dimension. */
@@ -75,7 +160,12 @@ class TensorShape {
     DataLayout getLayout() const { return layout; }
     int ndims() const { return dims_.size(); }
     int size() const { return product(dims_); }
-    int storageSize() const { return product(sum(dims_, padding_)); }
+    int storageSize() const {
+        int size = 1;
+        for (int i = 0; i < dims_.size(); i++)
+            size *= dims_[i] + padding_[i];
+        return size;
+    }
     int getAlignment() const { return alignment; }
     int getPadding(int index) const { return padding_[index]; }
 
@@ -94,9 +184,9 @@ class TensorShape {
         for (int i = 0; i < ndims - 1; i++)
             padding_[i] = 0;
     }
-    std::vector<int> dims_;
+    TensorDims dims_;
     /** Padding along each dimension. Only the last element be nonzero. */
-    std::vector<int> padding_;
+    TensorDims padding_;
     DataLayout layout;
     int alignment;
 };
@@ -128,9 +218,14 @@ class TensorShape {
 class TensorIndexIterator {
    public:
     TensorIndexIterator(const TensorShape& shape, bool _atEnd = false)
-            : dims(shape.dims()), padding(shape.padding()), atEnd(_atEnd),
-              advanceOne(std::vector<int>(dims.size(), 1)) {
-        state.resize(dims.size(), 0);
+            : state(shape.ndims(), 0), dims(shape.dims()),
+              padding(shape.padding()), strides(shape.ndims()),
+              atEnd(_atEnd), advanceOne(shape.ndims(), 1) {
+        int stride = 1;
+        for (int i = dims.size() - 1; i >= 0; i--) {
+            strides[i] = stride;
+            stride *= dims[i] + padding[i];
+        }
     }
 
     operator int() const { return getIndex(state); }
@@ -139,7 +234,7 @@ class TensorIndexIterator {
 
     void operator++() { advanceRegion(advanceOne); }
 
-    void operator+=(const std::vector<int>& region) {
+    void operator+=(const TensorDims& region) {
         assert(region.size() == state.size());
         advanceRegion(region);
     }
@@ -171,12 +266,11 @@ class TensorIndexIterator {
      * the specified coordinates.
      */
     template <typename Container>
-    int getIndex(Container indices) const {
-        int linearIndex = 0, stride = 1;
-        for (int i = (int)indices.size() - 1; i >= 0; i--) {
-            linearIndex += indices[i] * stride;
-            stride *= (dims.at(i) + padding.at(i));
-        }
+    int getIndex(const Container& indices) const {
+        assert((int)indices.size() == dims.size());
+        int linearIndex = 0;
+        for (int i = 0; i < dims.size(); i++)
+            linearIndex += indices[i] * strides[i];
         return linearIndex;
     }
 
@@ -187,7 +281,7 @@ class TensorIndexIterator {
      * dimension, if the previous dimension overflowed and caused a carry-over
      * into the next dimension.
      */
-    virtual void advanceRegion(const std::vector<int>& region) {
+    virtual void advanceRegion(const TensorDims& region) {
         bool carry = true;
         for (int i = (int)state.size() - 1; i >= 0 && carry; i--) {
             int currValue = state[i] + region[i];
@@ -201,15 +295,17 @@ class TensorIndexIterator {
     }
 
     /** The current location of the iterator. */
-    std::vector<int> state;
+    TensorDims state;
     /** The dimensions of this iterator's Tensor. */
-    std::vector<int> dims;
+    TensorDims dims;
     /** Alignment padding of the Tensor. */
-    std::vector<int> padding;
+    TensorDims padding;
+    /** The linear distance between two neighbours along each dimension. */
+    TensorDims strides;
     /** If true, we've reached the end of the Tensor. */
     bool atEnd;
     /** A vector of all ones, used to implement operator++. */
-    const std::vector<int> advanceOne;
+    const TensorDims advanceOne;
 };
 
 /**
@@ -231,8 +327,8 @@ class TensorIndexIterator {
 class TensorRegionIndexIterator : public TensorIndexIterator {
    public:
     TensorRegionIndexIterator(const TensorShape& shape,
-                              const std::vector<int>& _origin,
-                              const std::vector<int>& _regionSize)
+                              const TensorDims& _origin,
+                              const TensorDims& _regionSize)
             : TensorIndexIterator(shape, false), origin(_origin),
               regionSize(_regionSize) {
         state = origin;
@@ -240,7 +336,7 @@ class TensorRegionIndexIterator : public TensorIndexIterator {
 
    protected:
     /** Advance the tensor region index with the specified region size. */
-    virtual void advanceRegion(const std::vector<int>& advanceRegionSize) {
+    virtual void advanceRegion(const TensorDims& advanceRegionSize) {
         bool carry = true;
         for (int i = (int)state.size() - 1; i >= 0 && carry; i--) {
             int currValue = state[i] + advanceRegionSize[i];
@@ -254,8 +350,8 @@ class TensorRegionIndexIterator : public TensorIndexIterator {
             atEnd = true;
     }
 
-    std::vector<int> origin;
-    std::vector<int> regionSize;
+    TensorDims origin;
+    TensorDims regionSize;
 };
 
 /**
@@ -303,6 +399,8 @@ class TensorBase {
                 return sizeof(double);
             case Bool:
                 return sizeof(bool);
+            case Int8:
+                return sizeof(int8_t);
             default:
                 assert(false && "UnknownDataType has no size!");
                 return 0;
@@ -343,11 +441,11 @@ class TensorBase {
  */
 class Tensor : public TensorBase {
    public:
-    Tensor() : TensorBase(), tensorData(NULL) {}
+    Tensor() : TensorBase(), tensorData(NULL), view(false) {}
 
     /** Construct a Tensor with the given name and shape. */
     Tensor(const std::string& _name, const TensorShape& _shape)
-            : TensorBase(_name, _shape), tensorData(NULL) {}
+            : TensorBase(_name, _shape), tensorData(NULL), view(false) {}
     virtual ~Tensor() {}
 
     /**
@@ -357,7 +455,7 @@ class Tensor : public TensorBase {
      * @param tensorData The data contents of the Tensor.
      */
     Tensor(const TensorProto& tensorProto, const TensorData& tensorData)
-            : TensorBase(tensorProto), tensorData(NULL) {
+            : TensorBase(tensorProto), tensorData(NULL), view(false) {
         DataType dataType = tensorProto.data_type();
         switch (dataType) {
             case Float16:
@@ -378,6 +476,9 @@ class Tensor : public TensorBase {
             case Bool:
                 fillData<bool>(tensorData.bool_data());
                 break;
+            case Int8:
+                fillInt8Data(tensorData.int8_data());
+                break;
             default:
                 assert(false && "Unknown data format!");
         }
@@ -464,6 +565,25 @@ class Tensor : public TensorBase {
 #endif
     }
 
+    /**
+     * Fill the tensor with int8 data.
+     *
+     * Like fillHalfData(), this unpacks four int8 values from each int32 in
+     * the TensorProto.
+     */
+    void fillInt8Data(
+            const google::protobuf::RepeatedField<int>& externalData) {
+        allocateStorage<int8_t>();
+        int8_t* rawPtr = data<int8_t>();
+#ifdef USE_PEDANTIC_COPY
+        for (int i = 0; i < shape.storageSize(); i++)
+            rawPtr[i] = externalData[i / 4] >> (8 * (i % 4));
+#else
+        const int* externalPtr = externalData.data();
+        memcpy(rawPtr, externalPtr, shape.storageSize() * sizeof(int8_t));
+#endif
+    }
+
     /**
      * Allocates memory to store Tensor data.
      *
@@ -506,11 +626,54 @@ class Tensor : public TensorBase {
             case Bool:
                 allocateStorage<bool>();
                 return;
+            case Int8:
+                allocateStorage<int8_t>();
+                return;
             default:
                 assert(false && "Unknown data type!");
         }
     }
 
+    /**
+     * Makes this Tensor a view into the storage of another Tensor, starting
+     * at the given element offset, so that writing to one writes to the
+     * other. Its own storage, if any, is released, and the two share the
+     * ownership of the buffer. The caller is responsible for this Tensor's
+     * storage fitting within the other one's.
+     */
+    void setStorageView(Tensor* base, int offset) {
+        assert(base->containsData() && "The base Tensor has no storage!");
+        assert(offset + shape.storageSize() <=
+                       base->getShape().storageSize() &&
+               "The view does not fit in the base Tensor!");
+        dataType = base->getDataType();
+        tensorData = std::shared_ptr<void>(
+                base->tensorData,
+                reinterpret_cast<char*>(base->tensorData.get()) +
+                        (size_t)offset * getDataTypeSize());
+        view = true;
+    }
+
+    /** Returns true if the storage of this Tensor is a view into another. */
+    bool isView() const { return view; }
+
+    /**
+     * Returns true if the storage of this Tensor is shared with any other
+     * Tensor, i.e. it is a view or something is a view into it.
+     */
+    bool isStorageShared() const { return tensorData.use_count() > 1; }
+
+    /**
+     * Returns true if this Tensor is a view into the storage of base at the
+     * given element offset.
+     */
+    bool isViewOf(const Tensor* base, int offset) const {
+        return view && base->containsData() &&
+               tensorData.get() ==
+                       reinterpret_cast<char*>(base->tensorData.get()) +
+                               (size_t)offset * base->getDataTypeSize();
+    }
+
     /** Serializes this Tensor to a TensorProto. */
     TensorProto* asTensorProto();
 
@@ -539,6 +702,8 @@ class Tensor : public TensorBase {
 
    protected:
     std::shared_ptr<void> tensorData;
+    /** True if tensorData points into the storage of another Tensor. */
+    bool view;
 };
 
 /**
@@ -608,7 +773,7 @@ class TiledTensor : public TensorBase {
     * into it.
     */
    void setTile(int index,
-                const std::vector<int>& origin,
+                const TensorDims& origin,
                 Tensor* tensor,
                 bool copyData);
 
@@ -631,7 +796,7 @@ class TiledTensor : public TensorBase {
        /** The new smaller Tensor of this tile. */
        Tensor* tensor;
        /** The tile's coordinate origins in the original tensor. */
-       std::vector<int> origin;
+       TensorDims origin;
        /** True if the tile has its origin set. */
        bool hasOrigin;
        /** True if we have copied data to this tile. */
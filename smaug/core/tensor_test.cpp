@@ -1,8 +1,13 @@
+#include <chrono>
+
 #include "catch.hpp"
 #include "smaug/core/backend.h"
+#include "smaug/core/globals.h"
 #include "smaug/core/tensor.h"
+#include "smaug/core/tensor_utils.h"
 #include "smaug/core/smaug_test.h"
 #include "smaug/operators/data_op.h"
+#include "smaug/utility/thread_pool.h"
 
 using namespace smaug;
 
@@ -52,3 +57,172 @@ TEST_CASE_METHOD(SmaugTest, "Unpacking of float16 tensor data", "[fp16]") {
     }
 }
 
+
+TEST_CASE_METHOD(SmaugTest, "Tensor dimensions and indices", "[tensor]") {
+    SECTION("Conversions to and from vectors") {
+        TensorDims dims = { 1, 2, 3 };
+        REQUIRE(dims.size() == 3);
+        REQUIRE(dims == std::vector<int>{ 1, 2, 3 });
+        REQUIRE(std::vector<int>{ 1, 2, 4 } != dims);
+        std::vector<int> vector = dims;
+        REQUIRE(TensorDims(vector) == dims);
+        dims.push_back(4);
+        REQUIRE(dims.back() == 4);
+        dims.resize(6, 7);
+        REQUIRE(dims == std::vector<int>{ 1, 2, 3, 4, 7, 7 });
+        REQUIRE(TensorDims(2, 5) == TensorDims{ 5, 5 });
+    }
+    SECTION("Indices of a padded tensor") {
+        TensorShape shape({ 2, 3, 5 }, DataLayout::NCT, 8);
+        REQUIRE(shape.padding() == std::vector<int>{ 0, 0, 3 });
+        REQUIRE(shape.storageSize() == 2 * 3 * 8);
+        auto it = TensorIndexIterator(shape);
+        REQUIRE(it(1, 2, 4) == 1 * 24 + 2 * 8 + 4);
+        int count = 0;
+        int lastIndex = -1;
+        for (; !it.end(); ++it, ++count) {
+            // The padding is skipped.
+            REQUIRE(it % 8 < 5);
+            REQUIRE((int)it > lastIndex);
+            lastIndex = it;
+        }
+        REQUIRE(count == shape.size());
+    }
+    SECTION("Indices of a region") {
+        TensorShape shape({ 3, 3 }, DataLayout::NC);
+        auto it = TensorRegionIndexIterator(shape, { 0, 1 }, { 2, 2 });
+        std::vector<int> indices;
+        for (; !it.end(); ++it)
+            indices.push_back(it);
+        REQUIRE(indices == std::vector<int>{ 1, 2, 4, 5 });
+    }
+}
+
+// Copies a region element by element, for reference.
+void copyRegionReference(Tensor* dest,
+                         Tensor* src,
+                         const TensorDims& destOrigin,
+                         const TensorDims& srcOrigin,
+                         const TensorDims& regionSize) {
+    auto destIt = TensorRegionIndexIterator(
+            dest->getShape(), destOrigin, regionSize);
+    auto srcIt =
+            TensorRegionIndexIterator(src->getShape(), srcOrigin, regionSize);
+    float* destData = dest->data<float>();
+    float* srcData = src->data<float>();
+    for (; !srcIt.end(); ++srcIt, ++destIt)
+        destData[destIt] = srcData[srcIt];
+}
+
+void doCopyRegionTest(Workspace* workspace,
+                      DataLayout layout,
+                      const TensorDims& srcDims,
+                      const TensorDims& destDims,
+                      const TensorDims& destOrigin,
+                      const TensorDims& srcOrigin,
+                      const TensorDims& regionSize,
+                      bool parallel = false) {
+    TensorShape srcShape(srcDims, layout, 8);
+    TensorShape destShape(destDims, layout, 8);
+    Tensor* src = new Tensor("src", srcShape);
+    Tensor* dest = new Tensor("dest", destShape);
+    Tensor* expected = new Tensor("expected", destShape);
+    workspace->addTensor(src);
+    workspace->addTensor(dest);
+    workspace->addTensor(expected);
+    float* srcData = src->allocateStorage<float>();
+    for (int i = 0; i < srcShape.storageSize(); i++)
+        srcData[i] = i;
+    std::vector<float> zeros(destShape.storageSize(), 0);
+    dest->allocateStorage<float>();
+    dest->fillData(zeros.data(), zeros.size());
+    expected->allocateStorage<float>();
+    expected->fillData(zeros.data(), zeros.size());
+    if (parallel)
+        parallelCopyTensorRegion(dest, src, destOrigin, srcOrigin, regionSize);
+    else
+        copyTensorRegion(dest, src, destOrigin, srcOrigin, regionSize);
+    copyRegionReference(expected, src, destOrigin, srcOrigin, regionSize);
+    float* destData = dest->data<float>();
+    float* expectedData = expected->data<float>();
+    for (auto it = dest->startIndex(); !it.end(); ++it)
+        REQUIRE(destData[it] == expectedData[it]);
+}
+
+TEST_CASE_METHOD(SmaugTest, "Tensor region copies", "[tensor]") {
+    SECTION("Rank 2") {
+        doCopyRegionTest(workspace(), DataLayout::NC, { 8, 32 }, { 4, 16 },
+                         { 0, 0 }, { 2, 8 }, { 4, 16 });
+    }
+    SECTION("Rank 3, whole tensor") {
+        doCopyRegionTest(workspace(), DataLayout::NCT, { 6, 10, 16 },
+                         { 6, 10, 16 }, { 0, 0, 0 }, { 0, 0, 0 },
+                         { 6, 10, 16 });
+    }
+    SECTION("Rank 3, inner block") {
+        doCopyRegionTest(workspace(), DataLayout::NCT, { 6, 10, 16 },
+                         { 6, 10, 16 }, { 2, 5, 0 }, { 1, 2, 0 },
+                         { 3, 4, 16 });
+    }
+    SECTION("Rank 4, channel slice") {
+        doCopyRegionTest(workspace(), DataLayout::NHWC, { 2, 16, 16, 64 },
+                         { 2, 16, 16, 8 }, { 0, 0, 0, 0 }, { 0, 0, 0, 24 },
+                         { 2, 16, 16, 8 });
+    }
+    SECTION("Rank 4, padded channels") {
+        doCopyRegionTest(workspace(), DataLayout::NHWC, { 1, 8, 8, 5 },
+                         { 1, 4, 8, 5 }, { 0, 0, 0, 0 }, { 0, 4, 0, 0 },
+                         { 1, 4, 8, 5 });
+    }
+    SECTION("Rank 5") {
+        doCopyRegionTest(workspace(), DataLayout::X, { 2, 3, 4, 5, 16 },
+                         { 2, 3, 4, 5, 8 }, { 0, 0, 0, 0, 0 },
+                         { 0, 0, 0, 0, 8 }, { 2, 3, 4, 5, 8 });
+    }
+    SECTION("Multithreaded") {
+        ThreadPool* savedThreadPool = threadPool;
+        threadPool = new ThreadPool(4);
+        threadPool->initThreadPool();
+        doCopyRegionTest(workspace(), DataLayout::NHWC, { 1, 128, 128, 64 },
+                         { 1, 128, 128, 32 }, { 0, 0, 0, 0 },
+                         { 0, 0, 0, 16 }, { 1, 128, 128, 32 }, true);
+        delete threadPool;
+        threadPool = savedThreadPool;
+    }
+}
+
+// Not run by default. This times the tiling and untiling of a tensor into
+// many small tiles, which create and copy a shape, an origin and a few index
+// iterators per tile:
+//   tensor_test "[benchmark]"
+TEST_CASE_METHOD(SmaugTest, "Tiling and copy benchmark", "[.][benchmark]") {
+    const int kIters = 20;
+    TensorShape shape({ 1, 64, 64, 64 }, DataLayout::NHWC, 8);
+    Tensor* tensor = new Tensor("tensor", shape);
+    workspace()->addTensor(tensor);
+    float* data = tensor->allocateStorage<float>();
+    for (int i = 0; i < shape.storageSize(); i++)
+        data[i] = i;
+    DataOp<ReferenceBackend> dataOp("data", workspace());
+    for (int tileDim : { 4, 8, 16 }) {
+        TensorShape tileShape(
+                { 1, tileDim, tileDim, tileDim }, DataLayout::NHWC, 8);
+        std::chrono::duration<double> tiling(0), untiling(0);
+        int numTiles = 0;
+        for (int i = 0; i < kIters; i++) {
+            auto start = std::chrono::steady_clock::now();
+            TiledTensor tiledTensor =
+                    generateTiledTensor(tensor, tileShape, &dataOp, true);
+            tiling += std::chrono::steady_clock::now() - start;
+            start = std::chrono::steady_clock::now();
+            tiledTensor.untile();
+            untiling += std::chrono::steady_clock::now() - start;
+            numTiles = tiledTensor.size();
+        }
+        std::cout << numTiles << " tiles of " << tileShape << ": tiling "
+                  << tiling.count() / kIters * 1e6 << " us, untiling "
+                  << untiling.count() / kIters * 1e6 << " us\n";
+        for (int i = 0; i < shape.storageSize(); i++)
+            REQUIRE(data[i] == i);
+    }
+}
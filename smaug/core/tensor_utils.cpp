@@ -1,10 +1,12 @@
 #include <iostream>
 
 #include "fp16.h"
+#include "smaug/core/globals.h"
 #include "smaug/core/tensor.h"
 #include "smaug/core/tensor_utils.h"
 #include "smaug/core/workspace.h"
 #include "smaug/utility/debug_stream.h"
+#include "smaug/utility/thread_pool.h"
 
 namespace smaug {
 
@@ -15,6 +17,13 @@ void printTensorElement<float16>(std::ostream& os,
     os << fp16_ieee_to_fp32_value(data[index]);
 }
 
+template <>
+void printTensorElement<int8_t>(std::ostream& os,
+                                const int8_t* data,
+                                int index) {
+    os << static_cast<int>(data[index]);
+}
+
 std::ostream& operator<<(std::ostream& os, const TensorShape& shape) {
     os << "(";
     for (int i = 0; i < shape.ndims(); i++) {
@@ -26,6 +35,14 @@ std::ostream& operator<<(std::ostream& os, const TensorShape& shape) {
     return os;
 }
 
+std::ostream& operator<<(std::ostream& os, const TensorDims& dims) {
+    os << "{ ";
+    for (int dim : dims)
+        os << dim << " ";
+    os << "}";
+    return os;
+}
+
 std::ostream& operator<<(std::ostream& os, const TensorIndexIterator& iter) {
     os << "( ";
     for (int i = 0; i < iter.dims.size(); ++i) {
@@ -56,6 +73,9 @@ std::ostream& operator<<(std::ostream& os, const Tensor& tensor) {
         case Bool:
             writeTensorToOstream<bool>(os, tensor);
             break;
+        case Int8:
+            writeTensorToOstream<int8_t>(os, tensor);
+            break;
         default:
             assert(false && "Unknown data type!");
     }
@@ -64,9 +84,9 @@ std::ostream& operator<<(std::ostream& os, const Tensor& tensor) {
 
 void copyTensorRegion(Tensor* dest,
                       Tensor* src,
-                      std::vector<int> destOrigin,
-                      std::vector<int> srcOrigin,
-                      std::vector<int> regionSize) {
+                      const TensorDims& destOrigin,
+                      const TensorDims& srcOrigin,
+                      const TensorDims& regionSize) {
     assert(dest->ndims() == src->ndims());
     assert(dest->getDataType() == src->getDataType());
     switch (dest->getDataType()) {
@@ -94,15 +114,147 @@ void copyTensorRegion(Tensor* dest,
             internal::copyTensorRegion<bool>(
                     dest, src, destOrigin, srcOrigin, regionSize);
             break;
+        case Int8:
+            internal::copyTensorRegion<int8_t>(
+                    dest, src, destOrigin, srcOrigin, regionSize);
+            break;
         default:
             assert(false && "Unknown data type!");
     }
 }
 
+namespace internal {
+
+/**
+ * A region smaller than this many bytes per thread is not worth splitting
+ * across the thread pool.
+ */
+constexpr int kMinParallelCopyBytes = 256 * 1024;
+
+struct CopyRegionArgs {
+    Tensor* dest;
+    Tensor* src;
+    TensorDims destOrigin;
+    TensorDims srcOrigin;
+    TensorDims regionSize;
+};
+
+void* copyRegionWorker(void* _args) {
+    auto args = reinterpret_cast<CopyRegionArgs*>(_args);
+    copyTensorRegion(args->dest, args->src, args->destOrigin, args->srcOrigin,
+                     args->regionSize);
+    delete args;
+    return nullptr;
+}
+
+}  // namespace internal
+
+void parallelCopyTensorRegion(Tensor* dest,
+                              Tensor* src,
+                              const TensorDims& destOrigin,
+                              const TensorDims& srcOrigin,
+                              const TensorDims& regionSize) {
+    // Split along the outermost dimension that has more than one element.
+    int splitDim = 0;
+    while (splitDim < regionSize.size() - 1 && regionSize[splitDim] == 1)
+        splitDim++;
+    int numThreads = 1;
+    if (!fastForwardMode && threadPool && regionSize.size() > 0) {
+        long long bytes = (long long)product(regionSize) *
+                          dest->getDataTypeSize();
+        numThreads = std::min(
+                { (long long)threadPool->size(),
+                  (long long)regionSize[splitDim],
+                  bytes / internal::kMinParallelCopyBytes });
+    }
+    if (numThreads <= 1) {
+        copyTensorRegion(dest, src, destOrigin, srcOrigin, regionSize);
+        return;
+    }
+    int sliceSize = FRAC_CEIL(regionSize[splitDim], numThreads);
+    for (int start = 0; start < regionSize[splitDim]; start += sliceSize) {
+        auto args = new internal::CopyRegionArgs{
+            dest, src, destOrigin, srcOrigin, regionSize
+        };
+        args->destOrigin[splitDim] += start;
+        args->srcOrigin[splitDim] += start;
+        args->regionSize[splitDim] =
+                std::min(sliceSize, regionSize[splitDim] - start);
+        int cpuid = threadPool->dispatchThread(
+                internal::copyRegionWorker, (void*)args);
+        assert(cpuid != -1 && "Failed to dispatch thread!");
+    }
+    threadPool->joinThreadPool();
+}
+
+int getSliceViewOffset(const Tensor* tensor,
+                       const Tensor* slice,
+                       int axis,
+                       int start) {
+    const TensorShape& shape = tensor->getShape();
+    const TensorShape& sliceShape = slice->getShape();
+    int ndims = shape.ndims();
+    if (slice->getDataType() != tensor->getDataType() ||
+        sliceShape.ndims() != ndims)
+        return -1;
+    for (int i = 0; i < axis; i++) {
+        if (shape[i] != 1 || sliceShape[i] != 1)
+            return -1;
+    }
+    int rowSize = 1;
+    for (int i = axis + 1; i < ndims; i++) {
+        if (sliceShape.getStorageDim(i) != shape.getStorageDim(i))
+            return -1;
+        rowSize *= shape.getStorageDim(i);
+    }
+    // The padding of a slice along the innermost dimension would overlap the
+    // elements that follow it.
+    if (axis == ndims - 1 && sliceShape.getPadding(axis) != 0 &&
+        start + sliceShape[axis] != shape[axis])
+        return -1;
+    int offset = start * rowSize;
+    if (offset + sliceShape.storageSize() > shape.storageSize())
+        return -1;
+    if ((offset * tensor->getDataTypeSize()) % CACHELINE_SIZE != 0)
+        return -1;
+    return offset;
+}
+
+bool aliasTensorSlice(Tensor* slice, Tensor* tensor, int axis, int start) {
+    assert(slice->containsData() && tensor->containsData());
+    if (slice == tensor || slice->isView())
+        return false;
+    int offset = getSliceViewOffset(tensor, slice, axis, start);
+    if (offset < 0)
+        return false;
+    slice->setStorageView(tensor, offset);
+    return true;
+}
+
+bool aliasTensorStorage(Tensor* dest, Tensor* src) {
+    assert(dest->containsData() && src->containsData());
+    if (dest == src || dest->isView() ||
+        dest->getDataType() != src->getDataType())
+        return false;
+    const TensorShape& destShape = dest->getShape();
+    const TensorShape& srcShape = src->getShape();
+    int destInnermost = destShape.ndims() - 1;
+    int srcInnermost = srcShape.ndims() - 1;
+    bool unpadded = destShape.getPadding(destInnermost) == 0 &&
+                    srcShape.getPadding(srcInnermost) == 0;
+    bool sameRows = destShape[destInnermost] == srcShape[srcInnermost] &&
+                    destShape.getStorageDim(destInnermost) ==
+                            srcShape.getStorageDim(srcInnermost);
+    if (destShape.size() != srcShape.size() || !(unpadded || sameRows))
+        return false;
+    dest->setStorageView(src, 0);
+    return true;
+}
+
 void copyTensorData(Tensor* dest,
                     Tensor* src,
-                    std::vector<int> destOrigin,
-                    std::vector<int> srcOrigin,
+                    const TensorDims& destOrigin,
+                    const TensorDims& srcOrigin,
                     int copySize) {
     assert(dest->getDataType() == src->getDataType());
     switch (dest->getDataType()) {
@@ -130,6 +282,10 @@ void copyTensorData(Tensor* dest,
             internal::copyTensorData<bool>(
                     dest, src, destOrigin, srcOrigin, copySize);
             break;
+        case Int8:
+            internal::copyTensorData<int8_t>(
+                    dest, src, destOrigin, srcOrigin, copySize);
+            break;
         default:
             assert(false && "Unknown data type!");
     }
@@ -166,6 +322,10 @@ void copyRawTensorData(Tensor* dest,
             internal::copyRawTensorData<bool>(
                     dest, src, destOffset, srcOffset, copySize);
             break;
+        case Int8:
+            internal::copyRawTensorData<int8_t>(
+                    dest, src, destOffset, srcOffset, copySize);
+            break;
         default:
             assert(false && "Unknown data type!");
     }
@@ -286,7 +446,7 @@ TiledTensor generateTiledTensorWithStrideAndPadding(
                 remaining += tilingHalos[i];
         }
     }
-    std::vector<int> numBlocksInDim(ndims, 0);
+    TensorDims numBlocksInDim(ndims, 0);
     for (int i = 0; i < ndims; i++)
         numBlocksInDim[i] = tilesInDim[i].size();
     TiledTensor tiledTensor(
@@ -296,10 +456,10 @@ TiledTensor generateTiledTensorWithStrideAndPadding(
         // So directly use it as the tile.
         tiledTensor[0] = tensor;
     } else {
-        std::vector<int> currentOrigin(ndims, 0);
+        TensorDims currentOrigin(ndims, 0);
         for (auto tileIndex = tiledTensor.startIndex(); !tileIndex.end();
              ++tileIndex) {
-            std::vector<int> currentTileShape(ndims);
+            TensorDims currentTileShape(ndims);
             for (int i = 0; i < ndims; i++)
                 currentTileShape[i] = tilesInDim[i][tileIndex.currentIndex(i)];
             TensorShape currentShape(currentTileShape,
@@ -359,7 +519,7 @@ Tensor* concatTensors(std::vector<Tensor*> inputTensors,
                       Workspace* workspace) {
     std::string outputName = inputTensors[0]->getName();
     TensorShape inputShape = inputTensors[0]->getShape();
-    std::vector<int> outputDims = inputShape.dims();
+    TensorDims outputDims = inputShape.dims();
     // Calculate the shape for the output tensor.
     for (int i = 1; i < inputTensors.size(); i++) {
         outputName += ("-" + inputTensors[i]->getName());
@@ -372,15 +532,15 @@ Tensor* concatTensors(std::vector<Tensor*> inputTensors,
     outputTensor->allocateStorage(inputTensors[0]->getDataType());
     // Copy data into the output tensor.
     int ndims = inputShape.ndims();
-    std::vector<int> currentOrigin(ndims, 0);
-    std::vector<int> srcOrigin(ndims, 0);
+    TensorDims currentOrigin(ndims, 0);
+    TensorDims srcOrigin(ndims, 0);
     for (int i = 0; i < inputTensors.size(); i++) {
         TensorShape srcShape = inputTensors[i]->getShape();
-        copyTensorRegion(outputTensor,
-                         inputTensors[i],
-                         currentOrigin,
-                         srcOrigin,
-                         srcShape.dims());
+        parallelCopyTensorRegion(outputTensor,
+                                 inputTensors[i],
+                                 currentOrigin,
+                                 srcOrigin,
+                                 srcShape.dims());
         currentOrigin[concatDim] += srcShape[concatDim];
     }
     return outputTensor;
@@ -6,6 +6,7 @@
 #ifndef _CORE_TENSOR_UTILS_H_
 #define _CORE_TENSOR_UTILS_H_
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <vector>
@@ -17,6 +18,7 @@ namespace smaug {
 class Workspace;
 class Operator;
 
+std::ostream& operator<<(std::ostream& os, const TensorDims& dims);
 std::ostream& operator<<(std::ostream& os, const TensorIndexIterator& iter);
 std::ostream& operator<<(std::ostream& os, const TensorShape& shape);
 std::ostream& operator<<(std::ostream& os, const Tensor& tensor);
@@ -31,6 +33,11 @@ void printTensorElement<float16>(std::ostream& os,
                                  const float16* data,
                                  int index);
 
+template <>
+void printTensorElement<int8_t>(std::ostream& os,
+                                const int8_t* data,
+                                int index);
+
 /**
  * Pretty-print a Tensor's name, shape, and contents to the provided ostream.
  */
@@ -68,27 +75,69 @@ void writeTensorToOstream(std::ostream& os, const Tensor& tensor) {
 
 namespace internal {
 
+/**
+ * Copies a region as a nested loop over its outer dimensions, with one
+ * memcpy per contiguous run of runSize elements. Levels is the number of
+ * loops, and counts/strides hold the trip count and the linear strides of
+ * each of them.
+ */
+template <typename DType, int Levels>
+struct RegionCopier {
+    static void copy(DType* dest,
+                     const DType* src,
+                     const int* counts,
+                     const int* destStrides,
+                     const int* srcStrides,
+                     int runSize) {
+        for (int i = 0; i < counts[0]; i++) {
+            RegionCopier<DType, Levels - 1>::copy(dest + i * destStrides[0],
+                                                  src + i * srcStrides[0],
+                                                  counts + 1,
+                                                  destStrides + 1,
+                                                  srcStrides + 1,
+                                                  runSize);
+        }
+    }
+};
+
+template <typename DType>
+struct RegionCopier<DType, 0> {
+    static void copy(DType* dest,
+                     const DType* src,
+                     const int* counts,
+                     const int* destStrides,
+                     const int* srcStrides,
+                     int runSize) {
+        memcpy(dest, src, runSize * sizeof(DType));
+    }
+};
+
+/** The highest rank that copyTensorRegion has a specialized loop for. */
+constexpr int kMaxSpecializedCopyRank = 4;
+
 template <typename DType>
 void copyTensorRegion(Tensor* dest,
                       Tensor* src,
-                      const std::vector<int>& destOrigin,
-                      const std::vector<int>& srcOrigin,
-                      const std::vector<int>& regionSize) {
+                      const TensorDims& destOrigin,
+                      const TensorDims& srcOrigin,
+                      const TensorDims& regionSize) {
     const TensorShape& srcShape = src->getShape();
     const TensorShape& destShape = dest->getShape();
     TensorShape regionShape(
             regionSize, srcShape.getLayout(), srcShape.getAlignment());
     const int ndims = srcShape.ndims();
-    auto destIt = TensorRegionIndexIterator(destShape, destOrigin, regionSize);
-    auto srcIt = TensorRegionIndexIterator(srcShape, srcOrigin, regionSize);
+    DType* destPtr = dest->template data<DType>();
+    DType* srcPtr = src->template data<DType>();
 
     // We know where to copy data from and how much data we should copy (the
     // data region), now starting from the last dimension, we figure out how
     // much contiguous data there exists such that we can apply more efficient
     // data copy mechanisms (memcpy).
-    std::vector<int> contiguousRegion(ndims, 1);
+    TensorDims contiguousRegion(ndims, 1);
     int contiguousSize = 1;
-    for (int i = ndims - 1; i >= 0; i--) {
+    int contiguousDim = ndims - 1;
+    for (; contiguousDim >= 0; contiguousDim--) {
+        int i = contiguousDim;
         contiguousSize *= regionShape.getStorageDim(i);
         contiguousRegion[i] = regionShape[i];
         // If we find a region dimension smaller than that of either src or
@@ -97,9 +146,53 @@ void copyTensorRegion(Tensor* dest,
             break;
     }
 
-    // Copy the data region from the src tensor to the dest tensor.
-    DType* destPtr = dest->template data<DType>();
-    DType* srcPtr = src->template data<DType>();
+#ifndef PEDANTIC
+    if (ndims >= 2 && ndims <= kMaxSpecializedCopyRank) {
+        // Loop over the dimensions outside of the contiguous run, clipped to
+        // both tensors. The ones inside of it are looped over once.
+        int counts[kMaxSpecializedCopyRank];
+        int destStrides[kMaxSpecializedCopyRank];
+        int srcStrides[kMaxSpecializedCopyRank];
+        int destStride = 1, srcStride = 1;
+        for (int i = ndims - 1; i >= 0; i--) {
+            destStrides[i] = destStride;
+            srcStrides[i] = srcStride;
+            destPtr += destOrigin[i] * destStride;
+            srcPtr += srcOrigin[i] * srcStride;
+            destStride *= destShape.getStorageDim(i);
+            srcStride *= srcShape.getStorageDim(i);
+            counts[i] = 1;
+            if (i < contiguousDim) {
+                counts[i] = std::min(regionSize[i],
+                                     std::min(srcShape[i] - srcOrigin[i],
+                                              destShape[i] - destOrigin[i]));
+            }
+        }
+        // The innermost dimension is part of the contiguous run.
+        switch (ndims) {
+            case 2:
+                RegionCopier<DType, 1>::copy(destPtr, srcPtr, counts,
+                                             destStrides, srcStrides,
+                                             contiguousSize);
+                break;
+            case 3:
+                RegionCopier<DType, 2>::copy(destPtr, srcPtr, counts,
+                                             destStrides, srcStrides,
+                                             contiguousSize);
+                break;
+            case 4:
+                RegionCopier<DType, 3>::copy(destPtr, srcPtr, counts,
+                                             destStrides, srcStrides,
+                                             contiguousSize);
+                break;
+        }
+        return;
+    }
+#endif
+
+    // The generic path, for the other ranks.
+    auto destIt = TensorRegionIndexIterator(destShape, destOrigin, regionSize);
+    auto srcIt = TensorRegionIndexIterator(srcShape, srcOrigin, regionSize);
     while (!srcIt.end() && !destIt.end()) {
 #ifdef PEDANTIC
         destPtr[destIt] = srcPtr[srcIt];
@@ -130,8 +223,8 @@ void copyRawTensorData(Tensor* dest,
 template <typename DType>
 void copyTensorData(Tensor* dest,
                     Tensor* src,
-                    std::vector<int> destOrigin,
-                    std::vector<int> srcOrigin,
+                    const TensorDims& destOrigin,
+                    const TensorDims& srcOrigin,
                     int copySize) {
     TensorIndexIterator destIdx = dest->startIndex();
     TensorIndexIterator srcIdx = src->startIndex();
@@ -167,9 +260,23 @@ void copyTensorData(Tensor* dest,
  */
 void copyTensorRegion(Tensor* dest,
                       Tensor* src,
-                      std::vector<int> destOrigin,
-                      std::vector<int> srcOrigin,
-                      std::vector<int> regionSize);
+                      const TensorDims& destOrigin,
+                      const TensorDims& srcOrigin,
+                      const TensorDims& regionSize);
+
+/**
+ * Same as copyTensorRegion, but splits a large region along its outermost
+ * dimension and copies the pieces on the threads of the thread pool. Small
+ * regions, and any region when there is no thread pool, are copied on the
+ * calling thread.
+ *
+ * This must be called from the main thread, not from a worker of the pool.
+ */
+void parallelCopyTensorRegion(Tensor* dest,
+                              Tensor* src,
+                              const TensorDims& destOrigin,
+                              const TensorDims& srcOrigin,
+                              const TensorDims& regionSize);
 
 /**
  * Similar to copyTensorRegion, but the region is a contiguous block of
@@ -177,8 +284,8 @@ void copyTensorRegion(Tensor* dest,
  */
 void copyTensorData(Tensor* dest,
                     Tensor* src,
-                    std::vector<int> destOffset,
-                    std::vector<int> srcOffset,
+                    const TensorDims& destOffset,
+                    const TensorDims& srcOffset,
                     int copySize);
 
 /**
@@ -196,6 +303,37 @@ void copyTensorData(Tensor* dest,
 void copyRawTensorData(
         Tensor* dest, Tensor* src, int destOffset, int srcOffset, int copySize);
 
+/**
+ * Returns the offset, in elements, at which a slice of a Tensor can be a view
+ * into its storage, or -1 if it cannot.
+ *
+ * The slice spans the whole Tensor along every dimension but the given axis,
+ * along which it starts at the given index. It can be a view if it is a
+ * contiguous block of the Tensor, laid out with the same padding and starting
+ * on a cacheline.
+ */
+int getSliceViewOffset(const Tensor* tensor,
+                       const Tensor* slice,
+                       int axis,
+                       int start);
+
+/**
+ * Makes a slice of a Tensor a view into its storage, if getSliceViewOffset()
+ * allows it. Both Tensors must be allocated.
+ *
+ * @return true if the slice is now a view into the Tensor.
+ */
+bool aliasTensorSlice(Tensor* slice, Tensor* tensor, int axis, int start);
+
+/**
+ * Makes dest a view into the whole storage of src, if the two store their
+ * elements in the same order, i.e. neither is padded or both have the same
+ * innermost dimension. Both Tensors must be allocated.
+ *
+ * @return true if dest is now a view into src.
+ */
+bool aliasTensorStorage(Tensor* dest, Tensor* src);
+
 /**
  * Tile the provided NC Tensor per batch.
  *
@@ -101,6 +101,11 @@ class BatchNormOp : public FusedActivationOp {
         return kNumInputs * inputs.at(Mean)->getShape().size();
     }
 
+    int64_t getNumFlops() const override {
+        // Subtract the mean, scale by the variance and gamma, add beta.
+        return 4 * static_cast<int64_t>(outputs.at(Outputs)->getShape().size());
+    }
+
     std::vector<TensorBase*> getParameterizableInputs() override {
         return { inputs[Mean], inputs[Variance], inputs[Gamma], inputs[Beta] };
     }
@@ -346,6 +346,18 @@ typedef uint8_t v8bl_t
  */
 #define VEC256_MASK(input, mask) ((v8fp_t)((v8sfx_t)input & mask))
 
+/**
+ * Selects, for each lane of two 256-bit packed single precision FP vectors,
+ * the lane of the first one where the mask is -1 and of the second one where
+ * it is 0.
+ *
+ * @param mask A v8sfx_t vector of either 0s or -1s.
+ * @param a A v8fp_t vector.
+ * @param b A v8fp_t vector.
+ */
+#define VEC256_SELECT(mask, a, b)                                              \
+    ((v8fp_t)(((v8sfx_t)(a) & (mask)) | ((v8sfx_t)(b) & ~(mask))))
+
 /**
  * @}
  */
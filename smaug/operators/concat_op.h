@@ -10,7 +10,9 @@ namespace smaug {
 /** \ingroup Operators
  * \brief Concatenates N Tensors along a specified axis.
  *
- * This has a software-based implementation.
+ * This has a software-based implementation. When the network is built, the
+ * inputs whose slices of the output are contiguous become views into them
+ * (see aliasInput()), and are not copied at all.
  *
  * @tparam Backend The Backend that sets Alignment.
  */
@@ -67,17 +69,37 @@ class ConcatOp : public Operator {
         createOutputTensor();
     }
 
+    /**
+     * Makes an input a view into its slice of the output, so that its
+     * producer writes the slice directly and run() has nothing to copy for
+     * it. This is only possible when the slice is contiguous in the output
+     * (see getSliceViewOffset()). Both Tensors must already be allocated.
+     *
+     * @return true if the input is now a view into the output.
+     */
+    bool aliasInput(int index) {
+        int start = 0;
+        for (int i = 0; i < index; i++)
+            start += getInput(i)->dim(concatAxis);
+        return aliasTensorSlice(
+                getInput(index), getOutput(0), concatAxis, start);
+    }
+
     void run() override {
         Tensor* output = getOutput(0);
         int ndims = output->ndims();
-        std::vector<int> dstOrigin(ndims, 0);
+        TensorDims dstOrigin(ndims, 0);
         for (int i = 0; i < getInputs().size(); i++) {
             Tensor* input = getInput(i);
-            copyTensorRegion(output,
-                             input,
-                             dstOrigin,
-                             std::vector<int>(ndims, 0),
-                             input->getShape().dims());
+            int offset = getSliceViewOffset(
+                    output, input, concatAxis, dstOrigin[concatAxis]);
+            if (offset < 0 || !input->isViewOf(output, offset)) {
+                parallelCopyTensorRegion(output,
+                                         input,
+                                         dstOrigin,
+                                         TensorDims(ndims, 0),
+                                         input->getShape().dims());
+            }
             dstOrigin[concatAxis] += input->dim(concatAxis);
         }
     }
@@ -106,3 +106,100 @@ TEST_CASE_METHOD(SmaugTest, "Concatenate 2 tensors", "[refop]") {
         verifyOutputs(outputsTensor, expectedValues);
     }
 }
+
+TEST_CASE_METHOD(SmaugTest, "Concatenate into aliased inputs", "[refop]") {
+    // Concatenates inputs of the given shapes twice, once with the inputs
+    // aliased into the output wherever possible, and once with copies, and
+    // checks that the outputs match.
+    auto doTest = [&](const std::vector<TensorShape>& shapes,
+                      int axis,
+                      const std::vector<bool>& expectedAliased) {
+        int num = shapes.size();
+        auto aliasedOp = new ConcatOp<ReferenceBackend>(
+                "aliased", workspace(), num, axis);
+        auto copyingOp = new ConcatOp<ReferenceBackend>(
+                "copying", workspace(), num, axis);
+        for (int i = 0; i < num; i++) {
+            for (auto op : { aliasedOp, copyingOp }) {
+                Tensor* input = new Tensor(
+                        op->getName() + std::to_string(i), shapes[i]);
+                input->allocateStorage<float>();
+                workspace()->addTensor(input);
+                op->setInput(input, i);
+            }
+        }
+        for (auto op : { aliasedOp, copyingOp }) {
+            op->createAllTensors();
+            op->getOutput(0)->allocateStorage<float>();
+        }
+        for (int i = 0; i < num; i++) {
+            INFO("Input " << i);
+            REQUIRE(aliasedOp->aliasInput(i) == expectedAliased[i]);
+            REQUIRE(aliasedOp->getInput(i)->isView() == expectedAliased[i]);
+        }
+        // The producers fill the inputs only once they are aliased.
+        for (int i = 0; i < num; i++) {
+            for (auto op : { aliasedOp, copyingOp }) {
+                Tensor* input = op->getInput(i);
+                float* data = input->data<float>();
+                for (int j = 0; j < input->getShape().storageSize(); j++)
+                    data[j] = i * 1000 + j;
+            }
+        }
+        aliasedOp->run();
+        copyingOp->run();
+        verifyOutputs<float>(aliasedOp->getOutput(0), copyingOp->getOutput(0));
+    };
+
+    SECTION("Outermost dimension") {
+        doTest({ TensorShape({ 1, 8 }, DataLayout::NC),
+                 TensorShape({ 2, 8 }, DataLayout::NC),
+                 TensorShape({ 1, 8 }, DataLayout::NC) },
+               0, { true, true, true });
+    }
+    SECTION("Channels of a single image") {
+        doTest({ TensorShape({ 1, 2, 2, 4 }, DataLayout::NCHW),
+                 TensorShape({ 1, 3, 2, 4 }, DataLayout::NCHW) },
+               1, { true, true });
+    }
+    SECTION("Time steps of a single sequence") {
+        doTest({ TensorShape({ 1, 1, 16 }, DataLayout::NTC),
+                 TensorShape({ 1, 1, 16 }, DataLayout::NTC),
+                 TensorShape({ 1, 1, 16 }, DataLayout::NTC) },
+               1, { true, true, true });
+    }
+    SECTION("Innermost dimension of a single row") {
+        doTest({ TensorShape({ 1, 8 }, DataLayout::NC),
+                 TensorShape({ 1, 8 }, DataLayout::NC) },
+               1, { true, true });
+    }
+    SECTION("Channels of a batch are not contiguous") {
+        doTest({ TensorShape({ 2, 2, 2, 4 }, DataLayout::NCHW),
+                 TensorShape({ 2, 3, 2, 4 }, DataLayout::NCHW) },
+               1, { false, false });
+    }
+    SECTION("Slices that do not start on a cacheline") {
+        doTest({ TensorShape({ 1, 3 }, DataLayout::NC),
+                 TensorShape({ 1, 3 }, DataLayout::NC) },
+               0, { true, false });
+    }
+    SECTION("Input used twice") {
+        auto op = new ConcatOp<ReferenceBackend>("twice", workspace(), 2, 0);
+        Tensor* input =
+                new Tensor("input", TensorShape({ 1, 8 }, DataLayout::NC));
+        input->allocateStorage<float>();
+        workspace()->addTensor(input);
+        op->setInput(input, 0);
+        op->setInput(input, 1);
+        op->createAllTensors();
+        op->getOutput(0)->allocateStorage<float>();
+        REQUIRE(op->aliasInput(0));
+        REQUIRE_FALSE(op->aliasInput(1));
+        for (int i = 0; i < 8; i++)
+            input->data<float>()[i] = i;
+        op->run();
+        verifyOutputs(op->getOutput(0),
+                      std::vector<float>{ 0, 1, 2, 3, 4, 5, 6, 7,
+                                          0, 1, 2, 3, 4, 5, 6, 7 });
+    }
+}
@@ -13,7 +13,8 @@ namespace smaug {
  *
  * The switch operator copies an input Tensor to one of two output tensors,
  * depending on whether the specified predicate is true. The other tensor is
- * marked as dead.
+ * marked as dead. Once the network is built, both outputs are views into the
+ * input wherever possible, and nothing is copied.
  *
  * This is an integral component of implementing control flow in networks.
  *
@@ -61,6 +62,13 @@ class SwitchOp : public Operator {
         outputs.at(OutputTrue) = outputTrue;
     }
 
+    /** Makes both outputs views into the input, as only one is ever live. */
+    void aliasOutputs() override {
+        Tensor* input = getInput(Input);
+        aliasTensorStorage(getOutput(OutputFalse), input);
+        aliasTensorStorage(getOutput(OutputTrue), input);
+    }
+
     void run() override {
         Tensor* input = getInput(Input);
         Tensor* outputFalse = getOutput(OutputFalse);
@@ -68,15 +76,16 @@ class SwitchOp : public Operator {
         const TensorShape& inputShape = input->getShape();
         Tensor* predTensor = getInput(Pred);
         bool* pred = predTensor->data<bool>();
+        Tensor* output = nullptr;
         if (pred[0]) {
             outputFalse->setDead();
-            copyRawTensorData(
-                    outputTrue, input, 0, 0, inputShape.storageSize());
+            output = outputTrue;
         } else {
             outputTrue->setDead();
-            copyRawTensorData(
-                    outputFalse, input, 0, 0, inputShape.storageSize());
+            output = outputFalse;
         }
+        if (!output->isViewOf(input, 0))
+            copyRawTensorData(output, input, 0, 0, inputShape.storageSize());
     }
 };
 
@@ -85,13 +94,17 @@ class SwitchOp : public Operator {
  * \brief Forwards the first live input to its output.
  *
  * The merge operator takes multiple tensors, all but one of which should be
- * dead, and copies the one live Tensor to its output.
+ * dead, and forwards the one live Tensor to its output. The output simply
+ * becomes a view into the storage of the live Tensor, unless other Tensors
+ * were made views into the output when the network was built (see
+ * Operator::aliasOutputs()), in which case the live Tensor is copied.
  */
 template <typename Backend>
 class MergeOp : public Operator {
    public:
     MergeOp(const std::string& name, Workspace* workspace)
-            : Operator(name, OpType::Merge, workspace) {
+            : Operator(name, OpType::Merge, workspace),
+              forwardsStorage(false) {
         outputs.resize(1, nullptr);
     }
 
@@ -118,8 +131,15 @@ class MergeOp : public Operator {
         for (int i = 0; i < getInputs().size(); i++) {
             Tensor* input = getInput(i);
             if (!input->isDead()) {
-                copyRawTensorData(
-                        output, input, 0, 0, input->getShape().storageSize());
+                // Once the output is a view that this operator made, nothing
+                // else can be a view into it.
+                if (forwardsStorage || !output->isStorageShared()) {
+                    output->setStorageView(input, 0);
+                    forwardsStorage = true;
+                } else {
+                    copyRawTensorData(output, input, 0, 0,
+                                      input->getShape().storageSize());
+                }
                 forwarded = true;
                 break;
             }
@@ -129,6 +149,10 @@ class MergeOp : public Operator {
             exit(1);
         }
     }
+
+   protected:
+    /** True once the output has been made a view into a live input. */
+    bool forwardsStorage;
 };
 
 }  // namespace smaug
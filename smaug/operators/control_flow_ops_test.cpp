@@ -73,4 +73,74 @@ TEST_CASE_METHOD(SmaugTest, "Control flow operators", "[contrlop]") {
         REQUIRE(output->getShape().dims() == inputShape.dims());
         verifyOutputs<float>(output, input2);
     }
+
+    SECTION("Switch operator with views") {
+        auto switchOp = new SwitchOp<ReferenceBackend>("switch", workspace());
+        TensorShape inputShape({ 1, 2, 2, 2 }, DataLayout::NCHW);
+        Tensor* input = new Tensor("input", inputShape);
+        Tensor* pred = new Tensor("pred", TensorShape({ 1 }, DataLayout::N));
+        input->allocateStorage<float>();
+        pred->allocateStorage<bool>();
+        std::vector<float> inputValues{ 1, 2, 3, 4, 5, 6, 7, 8 };
+        input->fillData(inputValues.data(), inputValues.size());
+        pred->fillData({ false });
+        workspace()->addTensor(input);
+        workspace()->addTensor(pred);
+        switchOp->setInput(input, 0);
+        switchOp->setInput(pred, 1);
+        switchOp->createAllTensors();
+        allocateAllTensors<float>(switchOp);
+        switchOp->aliasOutputs();
+        auto outputFalse = switchOp->getOutput(0);
+        auto outputTrue = switchOp->getOutput(1);
+        REQUIRE(outputFalse->isViewOf(input, 0));
+        REQUIRE(outputTrue->isViewOf(input, 0));
+        switchOp->run();
+        REQUIRE(outputFalse->isDead() == false);
+        REQUIRE(outputTrue->isDead() == true);
+        verifyOutputs<float>(outputFalse, input);
+    }
+
+    SECTION("Merge operator forwarding the live input") {
+        auto mergeOp = new MergeOp<ReferenceBackend>("merge", workspace());
+        mergeOp->setNumInputs(2);
+        TensorShape inputShape({ 1, 2, 2, 2 }, DataLayout::NCHW);
+        Tensor* input0 =
+                workspace()->addTensor(new Tensor("input0", inputShape));
+        Tensor* input1 =
+                workspace()->addTensor(new Tensor("input1", inputShape));
+        input0->allocateStorage<float>();
+        input1->allocateStorage<float>();
+        std::vector<float> input0Values{ 1, 2, 3, 4, 5, 6, 7, 8 };
+        std::vector<float> input1Values{ 8, 7, 6, 5, 4, 3, 2, 1 };
+        input0->fillData(input0Values.data(), input0Values.size());
+        input1->fillData(input1Values.data(), input1Values.size());
+        mergeOp->setInput(input0, 0);
+        mergeOp->setInput(input1, 1);
+        mergeOp->createAllTensors();
+        allocateAllTensors<float>(mergeOp);
+        auto output = mergeOp->getOutput(0);
+        SECTION("The output takes over the live storage") {
+            input0->setDead();
+            mergeOp->run();
+            REQUIRE(output->isViewOf(input1, 0));
+            verifyOutputs(output, input1Values);
+            // Runs again with the other input live.
+            input0->setDead(false);
+            input1->setDead();
+            mergeOp->run();
+            REQUIRE(output->isViewOf(input0, 0));
+            verifyOutputs(output, input0Values);
+        }
+        SECTION("The output is copied to when it has views") {
+            Tensor* view = workspace()->addTensor(
+                    new Tensor("view", TensorShape({ 8 }, DataLayout::N)));
+            view->setStorageView(output, 0);
+            input1->setDead();
+            mergeOp->run();
+            REQUIRE_FALSE(output->isView());
+            verifyOutputs(output, input0Values);
+            verifyOutputs(view, input0Values);
+        }
+    }
 }
@@ -126,6 +126,13 @@ class ConvolutionOp : public FusedActivationOp {
         return inputs.at(Kernels)->getShape().size();
     }
 
+    int64_t getNumFlops() const override {
+        // Every output pixel is a dot product with one full kernel.
+        const TensorShape& weightsShape = inputs.at(Kernels)->getShape();
+        int64_t outputSize = outputs.at(Outputs)->getShape().size();
+        return 2 * outputSize * (weightsShape.size() / weightsShape[0]);
+    }
+
     std::vector<TensorBase*> getParameterizableInputs() override {
         return { inputs[Kernels] };
     }
@@ -67,6 +67,13 @@ class DepthwiseConvolutionOp : public ConvolutionOp<Backend> {
                     layout, Backend::Alignment);
         }
     }
+
+    int64_t getNumFlops() const override {
+        // Each output channel only sees its own input channel.
+        int64_t outputSize =
+                this->outputs.at(Parent::Outputs)->getShape().size();
+        return 2 * outputSize * this->weightRows * this->weightCols;
+    }
 };
 
 REGISTER_SPECIAL_OP(DepthwiseConvolutionOp, ReferenceBackend);
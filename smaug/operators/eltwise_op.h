@@ -28,6 +28,10 @@ class EltwiseOp : public Operator {
         workspace->addTensor(output);
     }
 
+    int64_t getNumFlops() const override {
+        return outputs.at(Outputs)->getShape().size();
+    }
+
    protected:
     enum { Input0, Input1, kNumInputs };
     enum { Outputs, kNumOutputs };
@@ -84,6 +84,11 @@ class InnerProductOp : public FusedActivationOp {
         return inputs.at(Weights)->getShape().size();
     }
 
+    int64_t getNumFlops() const override {
+        int64_t batches = getInput(Inputs)->getShape()[0];
+        return 2 * batches * inputs.at(Weights)->getShape().size();
+    }
+
     std::vector<TensorBase*> getParameterizableInputs() override {
         return { inputs[Weights] };
     }
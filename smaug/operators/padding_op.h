@@ -43,20 +43,21 @@ class PaddingOp : public Operator {
         Tensor* input = getInput(kInput);
         Tensor* output = getOutput(kOutput);
         int ndims = input->ndims();
-        const std::vector<int>& inputDims = input->getShape().dims();
-        const std::vector<int>& outputDims = output->getShape().dims();
+        const TensorDims& inputDims = input->getShape().dims();
+        const TensorDims& outputDims = output->getShape().dims();
         int total_dim = 1;
         for (int i : outputDims) {
             total_dim *= i;
         }
         std::vector<float> vf(total_dim, 0);
         output->fillData(vf.data(), vf.size());
-        std::vector<int> paddingBegin, srcOrigin;
+        TensorDims paddingBegin, srcOrigin;
         for (int i = 0; i < ndims; i++) {
             paddingBegin.push_back(paddingSize.at(2 * i));
             srcOrigin.push_back(0);
         }
-        copyTensorRegion(output, input, paddingBegin, srcOrigin, inputDims);
+        parallelCopyTensorRegion(
+                output, input, paddingBegin, srcOrigin, inputDims);
     }
 
     // Optional override for testing purposes.
@@ -92,6 +92,13 @@ class PoolingOp : public Operator {
 
     void createAllTensors() override { createOutputTensors(); }
 
+    int64_t getNumFlops() const override {
+        // One compare (max) or add (average) per element of the pooling
+        // window.
+        int64_t outputSize = outputs.at(Outputs)->getShape().size();
+        return outputSize * poolingRowSize * poolingColSize;
+    }
+
     bool isSamplingSupported() const override { return true; }
     void setSamplingInfo(const SamplingInfo& _sampling) override {
         sampling = _sampling;
@@ -32,11 +32,25 @@ class ReorderOp : public Operator {
     DataLayout getTargetDataLayout() const { return targetLayout; }
     void setTargetLayout(DataLayout layout) { targetLayout = layout; }
 
+    /**
+     * Makes the output of a flatten to NC a view into the input, which keeps
+     * the elements in storage order, if both store the same rows.
+     */
+    void aliasOutputs() override {
+        Tensor* input = getInput(Inputs);
+        Tensor* output = getOutput(Outputs);
+        if (input->ndims() == 4 && output->ndims() == 2 &&
+            targetLayout == DataLayout::NC)
+            aliasTensorStorage(output, input);
+    }
+
     void run() override {
         auto stats = gem5::ScopedStats(
                 stats::kReorderingStart, stats::kReorderingEnd);
         Tensor* input = getInput(Inputs);
         Tensor* output = getOutput(Outputs);
+        if (output->isViewOf(input, 0))
+            return;
         DataLayout srcLayout = input->getShape().getLayout();
         if (srcLayout == DataLayout::NCHW) {
             if (targetLayout == DataLayout::NHWC) {
@@ -1,126 +1,205 @@
+#include <algorithm>
+
+#include "smaug/core/globals.h"
 #include "smaug/core/tensor.h"
+#include "smaug/operators/common.h"
 #include "smaug/operators/reorder_op_impl.h"
+#include "smaug/utility/thread_pool.h"
 
 namespace smaug {
 
+namespace {
+
+/**
+ * A tensor smaller than this many bytes per thread is not worth splitting
+ * across the thread pool.
+ */
+constexpr int kMinParallelReorderBytes = 64 * 1024;
+
+typedef void (*ReorderImpl)(Tensor*, Tensor*, int, int);
+
+struct ReorderArgs {
+    ReorderImpl impl;
+    Tensor* input;
+    Tensor* output;
+    int start;
+    int end;
+};
+
+void* reorderWorker(void* _args) {
+    auto args = reinterpret_cast<ReorderArgs*>(_args);
+    args->impl(args->input, args->output, args->start, args->end);
+    delete args;
+    return nullptr;
+}
+
+/**
+ * Runs the reordering implementation over numUnits units of work, split
+ * across the threads of the thread pool when the tensor is large enough.
+ */
+void runReorder(ReorderImpl impl,
+                Tensor* input,
+                Tensor* output,
+                int numUnits) {
+    int numThreads = 1;
+    if (!fastForwardMode && threadPool) {
+        long long bytes = (long long)input->getShape().storageSize() *
+                          input->getDataTypeSize();
+        numThreads = std::min({ (long long)threadPool->size(),
+                                (long long)numUnits,
+                                bytes / kMinParallelReorderBytes });
+    }
+    if (numThreads <= 1) {
+        impl(input, output, 0, numUnits);
+        return;
+    }
+    int unitsPerThread = FRAC_CEIL(numUnits, numThreads);
+    for (int start = 0; start < numUnits; start += unitsPerThread) {
+        auto args = new ReorderArgs{ impl, input, output, start,
+                                     std::min(start + unitsPerThread,
+                                              numUnits) };
+        int cpuid = threadPool->dispatchThread(reorderWorker, (void*)args);
+        assert(cpuid != -1 && "Failed to dispatch thread!");
+    }
+    threadPool->joinThreadPool();
+}
+
+}  // namespace
+
 void convertNchwToNhwc(Tensor* input, Tensor* output) {
     DataType datatype = input->getDataType();
     assert(input->ndims() == output->ndims() && input->ndims() == 4);
+    ReorderImpl impl = nullptr;
     switch (datatype) {
         case Float16:
-            convertNchwToNhwcImpl<float16>(input, output);
-            return;
+            impl = convertNchwToNhwcImpl<float16>;
+            break;
         case Float32:
-            convertNchwToNhwcImpl<float>(input, output);
-            return;
+            impl = convertNchwToNhwcImpl<float>;
+            break;
         case Float64:
-            convertNchwToNhwcImpl<double>(input, output);
-            return;
+            impl = convertNchwToNhwcImpl<double>;
+            break;
         case Int32:
-            convertNchwToNhwcImpl<int>(input, output);
-            return;
+            impl = convertNchwToNhwcImpl<int>;
+            break;
         case Int64:
-            convertNchwToNhwcImpl<int64_t>(input, output);
-            return;
+            impl = convertNchwToNhwcImpl<int64_t>;
+            break;
         default:
             assert(false && "Unknown data format!");
+            return;
     }
+    runReorder(impl, input, output, input->dim(0) * input->dim(2));
 }
 
 void convertNhwcToNchw(Tensor* input, Tensor* output) {
     DataType datatype = input->getDataType();
     assert(input->ndims() == output->ndims() && input->ndims() == 4);
+    ReorderImpl impl = nullptr;
     switch (datatype) {
         case Float16:
-            convertNhwcToNchwImpl<float16>(input, output);
-            return;
+            impl = convertNhwcToNchwImpl<float16>;
+            break;
         case Float32:
-            convertNhwcToNchwImpl<float>(input, output);
-            return;
+            impl = convertNhwcToNchwImpl<float>;
+            break;
         case Float64:
-            convertNhwcToNchwImpl<double>(input, output);
-            return;
+            impl = convertNhwcToNchwImpl<double>;
+            break;
         case Int32:
-            convertNhwcToNchwImpl<int>(input, output);
-            return;
+            impl = convertNhwcToNchwImpl<int>;
+            break;
         case Int64:
-            convertNhwcToNchwImpl<int64_t>(input, output);
-            return;
+            impl = convertNhwcToNchwImpl<int64_t>;
+            break;
         default:
             assert(false && "Unknown data format!");
+            return;
     }
+    runReorder(impl, input, output, input->dim(0) * input->dim(1));
 }
 
 void flatten(Tensor* input, Tensor* output) {
     DataType datatype = input->getDataType();
     assert(input->ndims() == 4 && output->ndims() == 2);
+    ReorderImpl impl = nullptr;
     switch (datatype) {
         case Float16:
-            flattenImpl<float16>(input, output);
-            return;
+            impl = flattenImpl<float16>;
+            break;
         case Float32:
-            flattenImpl<float>(input, output);
-            return;
+            impl = flattenImpl<float>;
+            break;
         case Float64:
-            flattenImpl<double>(input, output);
-            return;
+            impl = flattenImpl<double>;
+            break;
         case Int32:
-            flattenImpl<int>(input, output);
-            return;
+            impl = flattenImpl<int>;
+            break;
         case Int64:
-            flattenImpl<int64_t>(input, output);
-            return;
+            impl = flattenImpl<int64_t>;
+            break;
         default:
             assert(false && "Unknown data format!");
+            return;
     }
+    runReorder(impl, input, output, input->dim(0));
 }
 
 void transpose3D(Tensor* input, Tensor* output) {
     DataType datatype = input->getDataType();
     assert(input->ndims() == 3 && output->ndims() == 3);
+    ReorderImpl impl = nullptr;
     switch (datatype) {
         case Float16:
-            transpose3DImpl<float16>(input, output);
-            return;
+            impl = transpose3DImpl<float16>;
+            break;
         case Float32:
-            transpose3DImpl<float>(input, output);
-            return;
+            impl = transpose3DImpl<float>;
+            break;
         case Float64:
-            transpose3DImpl<double>(input, output);
-            return;
+            impl = transpose3DImpl<double>;
+            break;
         case Int32:
-            transpose3DImpl<int>(input, output);
-            return;
+            impl = transpose3DImpl<int>;
+            break;
         case Int64:
-            transpose3DImpl<int64_t>(input, output);
-            return;
+            impl = transpose3DImpl<int64_t>;
+            break;
         default:
             assert(false && "Unknown data format!");
+            return;
     }
+    runReorder(impl, input, output, input->dim(0));
 }
 
 void transpose2D(Tensor* input, Tensor* output) {
     DataType datatype = input->getDataType();
     assert(input->ndims() == 2 && output->ndims() == 2);
+    ReorderImpl impl = nullptr;
     switch (datatype) {
         case Float16:
-            transpose2DImpl<float16>(input, output);
-            return;
+            impl = transpose2DImpl<float16>;
+            break;
         case Float32:
-            transpose2DImpl<float>(input, output);
-            return;
+            impl = transpose2DImpl<float>;
+            break;
         case Float64:
-            transpose2DImpl<double>(input, output);
-            return;
+            impl = transpose2DImpl<double>;
+            break;
         case Int32:
-            transpose2DImpl<int>(input, output);
-            return;
+            impl = transpose2DImpl<int>;
+            break;
         case Int64:
-            transpose2DImpl<int64_t>(input, output);
-            return;
+            impl = transpose2DImpl<int64_t>;
+            break;
         default:
             assert(false && "Unknown data format!");
+            return;
     }
+    runReorder(impl, input, output,
+               FRAC_CEIL(input->dim(0), kTransposeBlock));
 }
 
 }  // namespace smaug
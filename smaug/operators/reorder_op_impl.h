@@ -1,104 +1,213 @@
+#include <algorithm>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "smaug/core/tensor.h"
 #include "smaug/core/tensor_utils.h"
 
 namespace smaug {
 
+/** The layout transforms transpose square blocks of this many elements. */
+constexpr int kTransposeBlock = 8;
+
+/**
+ * Transposes a full 8x8 block. Returns false if there is no specialized
+ * version for the data type, in which case nothing is done.
+ */
 template <typename DType>
-void convertNchwToNhwcImpl(Tensor* input, Tensor* output) {
-    TensorIndexIterator inputIdx = input->startIndex();
-    TensorIndexIterator outputIdx = output->startIndex();
-    const TensorShape& inputShape = input->getShape();
-    DType* inputData = input->template data<DType>();
-    DType* outputData = output->template data<DType>();
-    for (int n = 0; n < inputShape[0]; n++) {
-        for (int c = 0; c < inputShape[1]; c++) {
-            for (int h = 0; h < inputShape[2]; h++) {
-                for (int w = 0; w < inputShape[3]; w++) {
-                    outputData[outputIdx(n, h, w, c)] =
-                            inputData[inputIdx(n, c, h, w)];
-                }
+bool transposeBlock8x8(const DType* src,
+                       DType* dst,
+                       int srcStride,
+                       int dstStride) {
+    return false;
+}
+
+#ifdef __SSE2__
+/** Transposes an 8x8 block of 16-bit (e.g. fp16) elements in registers. */
+inline bool transposeBlock8x8(const uint16_t* src,
+                              uint16_t* dst,
+                              int srcStride,
+                              int dstStride) {
+    __m128i r[8];
+    for (int i = 0; i < 8; i++)
+        r[i] = _mm_loadu_si128((const __m128i*)(src + i * srcStride));
+    __m128i t[8];
+    for (int i = 0; i < 4; i++) {
+        t[2 * i] = _mm_unpacklo_epi16(r[2 * i], r[2 * i + 1]);
+        t[2 * i + 1] = _mm_unpackhi_epi16(r[2 * i], r[2 * i + 1]);
+    }
+    __m128i u[8];
+    for (int i = 0; i < 2; i++) {
+        u[4 * i] = _mm_unpacklo_epi32(t[4 * i], t[4 * i + 2]);
+        u[4 * i + 1] = _mm_unpackhi_epi32(t[4 * i], t[4 * i + 2]);
+        u[4 * i + 2] = _mm_unpacklo_epi32(t[4 * i + 1], t[4 * i + 3]);
+        u[4 * i + 3] = _mm_unpackhi_epi32(t[4 * i + 1], t[4 * i + 3]);
+    }
+    for (int i = 0; i < 4; i++) {
+        _mm_storeu_si128((__m128i*)(dst + (2 * i) * dstStride),
+                         _mm_unpacklo_epi64(u[i], u[i + 4]));
+        _mm_storeu_si128((__m128i*)(dst + (2 * i + 1) * dstStride),
+                         _mm_unpackhi_epi64(u[i], u[i + 4]));
+    }
+    return true;
+}
+#endif
+
+/**
+ * Transposes a rows x cols matrix, i.e. dst[c * dstStride + r] =
+ * src[r * srcStride + c], in square blocks that stay in the cache.
+ */
+template <typename DType>
+void transposeMatrix(const DType* src,
+                     DType* dst,
+                     int rows,
+                     int cols,
+                     int srcStride,
+                     int dstStride) {
+    for (int r0 = 0; r0 < rows; r0 += kTransposeBlock) {
+        int rEnd = std::min(r0 + kTransposeBlock, rows);
+        for (int c0 = 0; c0 < cols; c0 += kTransposeBlock) {
+            int cEnd = std::min(c0 + kTransposeBlock, cols);
+            if (rEnd - r0 == kTransposeBlock && cEnd - c0 == kTransposeBlock &&
+                transposeBlock8x8(&src[r0 * srcStride + c0],
+                                  &dst[c0 * dstStride + r0], srcStride,
+                                  dstStride)) {
+                continue;
+            }
+            for (int r = r0; r < rEnd; r++) {
+                for (int c = c0; c < cEnd; c++)
+                    dst[c * dstStride + r] = src[r * srcStride + c];
             }
         }
     }
 }
 
+// The implementations below each process the units of work in [start, end),
+// so that the callers can split a tensor across threads. The unit is given
+// for each of them.
+
+/** Converts the rows of images from NCHW to NHWC. A unit is one row (n, h). */
 template <typename DType>
-void convertNhwcToNchwImpl(Tensor* input, Tensor* output) {
-    TensorIndexIterator inputIdx = input->startIndex();
-    TensorIndexIterator outputIdx = output->startIndex();
+void convertNchwToNhwcImpl(Tensor* input, Tensor* output, int start, int end) {
     const TensorShape& inputShape = input->getShape();
-    DType* inputData = input->template data<DType>();
+    const TensorShape& outputShape = output->getShape();
+    const DType* inputData = input->template data<DType>();
     DType* outputData = output->template data<DType>();
-    for (int n = 0; n < inputShape[0]; n++) {
-        for (int h = 0; h < inputShape[1]; h++) {
-            for (int w = 0; w < inputShape[2]; w++) {
-                for (int c = 0; c < inputShape[3]; c++) {
-                    outputData[outputIdx(n, c, h, w)] =
-                            inputData[inputIdx(n, h, w, c)];
-                }
-            }
-        }
+    int chans = inputShape[1];
+    int rows = inputShape[2];
+    int cols = inputShape[3];
+    int inputRowSize = inputShape.getStorageDim(3);
+    int outputPixelSize = outputShape.getStorageDim(3);
+    for (int i = start; i < end; i++) {
+        int n = i / rows;
+        int h = i % rows;
+        // The row is a C x W matrix in the input and a W x C one in the
+        // output.
+        transposeMatrix(
+                &inputData[(n * chans * rows + h) * inputRowSize],
+                &outputData[(n * rows + h) * cols * outputPixelSize], chans,
+                cols, rows * inputRowSize, outputPixelSize);
     }
 }
 
+/** Converts the rows of images from NHWC to NCHW. A unit is one row (n, h). */
 template <typename DType>
-void flattenImpl(Tensor* input, Tensor* output) {
-    TensorIndexIterator inputIdx = input->startIndex();
-    TensorIndexIterator outputIdx = output->startIndex();
+void convertNhwcToNchwImpl(Tensor* input, Tensor* output, int start, int end) {
     const TensorShape& inputShape = input->getShape();
     const TensorShape& outputShape = output->getShape();
-    DType* inputData = input->template data<DType>();
+    const DType* inputData = input->template data<DType>();
+    DType* outputData = output->template data<DType>();
+    int rows = inputShape[1];
+    int cols = inputShape[2];
+    int chans = inputShape[3];
+    int inputPixelSize = inputShape.getStorageDim(3);
+    int outputRowSize = outputShape.getStorageDim(3);
+    for (int i = start; i < end; i++) {
+        int n = i / rows;
+        int h = i % rows;
+        transposeMatrix(
+                &inputData[(n * rows + h) * cols * inputPixelSize],
+                &outputData[(n * chans * rows + h) * outputRowSize], cols,
+                chans, inputPixelSize, rows * outputRowSize);
+    }
+}
+
+/** Flattens a 4D tensor into NC or CN. A unit is one batch. */
+template <typename DType>
+void flattenImpl(Tensor* input, Tensor* output, int start, int end) {
+    const TensorShape& inputShape = input->getShape();
+    const TensorShape& outputShape = output->getShape();
+    const DType* inputData = input->template data<DType>();
     DType* outputData = output->template data<DType>();
     bool targetNC = outputShape.getLayout() == NC;
-    for (int n = 0; n < inputShape[0]; n++) {
-        int out_i = 0;
-        // At this point, it doesn't matter whether the layout is NCHW or NHWC.
-        // We just need to flatten the HWC part, which is dictated by the size
-        // of each dimension and not the logical meaning of each dim.
-        for (int i = 0; i < inputShape[1]; i++) {
-            for (int j = 0; j < inputShape[2]; j++) {
-                for (int k = 0; k < inputShape[3]; k++) {
-                    if (targetNC) {
-                        outputData[outputIdx(n, out_i++)] =
-                                inputData[inputIdx(n, i, j, k)];
-                    } else {
-                        outputData[outputIdx(out_i++, n)] =
-                                inputData[inputIdx(n, i, j, k)];
-                    }
+    // At this point, it doesn't matter whether the layout is NCHW or NHWC.
+    // We just need to flatten the HWC part, which is dictated by the size
+    // of each dimension and not the logical meaning of each dim.
+    int innerSize = inputShape[3];
+    int numInnerRows = inputShape[1] * inputShape[2];
+    int inputRowSize = inputShape.getStorageDim(3);
+    int batchSize = numInnerRows * inputRowSize;
+    int outputRowSize = outputShape.getStorageDim(1);
+    for (int n = start; n < end; n++) {
+        const DType* src = &inputData[n * batchSize];
+        if (targetNC) {
+            DType* dst = &outputData[n * outputRowSize];
+            if (innerSize == inputRowSize) {
+                // Without padding, the batch is already flat.
+                memcpy(dst, src, numInnerRows * innerSize * sizeof(DType));
+            } else {
+                for (int i = 0; i < numInnerRows; i++) {
+                    memcpy(&dst[i * innerSize], &src[i * inputRowSize],
+                           innerSize * sizeof(DType));
+                }
+            }
+        } else {
+            // The batch is a column of the output.
+            for (int i = 0; i < numInnerRows; i++) {
+                for (int k = 0; k < innerSize; k++) {
+                    outputData[(i * innerSize + k) * outputRowSize + n] =
+                            src[i * inputRowSize + k];
                 }
             }
         }
     }
 }
 
+/**
+ * Transposes the last two dimensions of a 3D tensor. A unit is one index of
+ * the outermost dimension.
+ */
 template <typename DType>
-void transpose3DImpl(Tensor* input, Tensor* output) {
-    TensorIndexIterator inputIdx = input->startIndex();
-    TensorIndexIterator outputIdx = output->startIndex();
+void transpose3DImpl(Tensor* input, Tensor* output, int start, int end) {
     const TensorShape& inputShape = input->getShape();
-    auto inputData = input->template data<DType>();
-    auto outputData = output->template data<DType>();
-    for (int i = 0; i < inputShape[0]; i++) {
-        for (int j = 0; j < inputShape[1]; j++) {
-            for (int k = 0; k < inputShape[2]; k++) {
-                outputData[outputIdx(i, k, j)] = inputData[inputIdx(i, j, k)];
-            }
-        }
+    const TensorShape& outputShape = output->getShape();
+    const DType* inputData = input->template data<DType>();
+    DType* outputData = output->template data<DType>();
+    int inputMatrixSize = inputShape[1] * inputShape.getStorageDim(2);
+    int outputMatrixSize = outputShape[1] * outputShape.getStorageDim(2);
+    for (int i = start; i < end; i++) {
+        transposeMatrix(&inputData[i * inputMatrixSize],
+                        &outputData[i * outputMatrixSize], inputShape[1],
+                        inputShape[2], inputShape.getStorageDim(2),
+                        outputShape.getStorageDim(2));
     }
 }
 
+/** Transposes a 2D tensor. A unit is one block of kTransposeBlock rows. */
 template <typename DType>
-void transpose2DImpl(Tensor* input, Tensor* output) {
-    TensorIndexIterator inputIdx = input->startIndex();
-    TensorIndexIterator outputIdx = output->startIndex();
+void transpose2DImpl(Tensor* input, Tensor* output, int start, int end) {
     const TensorShape& inputShape = input->getShape();
-    auto inputData = input->template data<DType>();
-    auto outputData = output->template data<DType>();
-    for (int n = 0; n < inputShape[0]; n++) {
-        for (int c = 0; c < inputShape[1]; c++) {
-            outputData[outputIdx(c, n)] = inputData[inputIdx(n, c)];
-        }
-    }
+    const TensorShape& outputShape = output->getShape();
+    const DType* inputData = input->template data<DType>();
+    DType* outputData = output->template data<DType>();
+    int rowStart = start * kTransposeBlock;
+    int rowEnd = std::min(end * kTransposeBlock, inputShape[0]);
+    transposeMatrix(&inputData[rowStart * inputShape.getStorageDim(1)],
+                    &outputData[rowStart], rowEnd - rowStart, inputShape[1],
+                    inputShape.getStorageDim(1), outputShape.getStorageDim(1));
 }
 
 void convertNchwToNhwc(Tensor* input, Tensor* output);
@@ -2,7 +2,9 @@
 #include "smaug/core/backend.h"
 #include "smaug/core/tensor.h"
 #include "smaug/core/smaug_test.h"
+#include "smaug/core/globals.h"
 #include "smaug/operators/reorder_op.h"
+#include "smaug/utility/thread_pool.h"
 
 using namespace smaug;
 
@@ -47,6 +49,25 @@ TEST_CASE_METHOD(SmaugTest, "Reorder from NCHW", "[refop]") {
         REQUIRE(outputsTensor->getShape().getLayout() == DataLayout::NC);
         verifyOutputs(outputsTensor, inputValues);
     }
+
+    SECTION("Flatten as a view of the input") {
+        reorderOp->setTargetLayout(DataLayout::NC);
+        reorderOp->createAllTensors();
+        allocateAllTensors<float>(reorderOp);
+        reorderOp->aliasOutputs();
+        auto outputsTensor = reorderOp->getOutput(0);
+        REQUIRE(outputsTensor->isViewOf(input, 0));
+        reorderOp->run();
+        verifyOutputs(outputsTensor, inputValues);
+    }
+
+    SECTION("No view for a layout change") {
+        reorderOp->setTargetLayout(DataLayout::NHWC);
+        reorderOp->createAllTensors();
+        allocateAllTensors<float>(reorderOp);
+        reorderOp->aliasOutputs();
+        REQUIRE_FALSE(reorderOp->getOutput(0)->isView());
+    }
 }
 
 TEST_CASE_METHOD(SmaugTest, "Reorder from NHWC", "[refop]") {
@@ -93,3 +114,121 @@ TEST_CASE_METHOD(SmaugTest, "Reorder from NHWC", "[refop]") {
         verifyOutputs(outputsTensor, inputValues);
     }
 }
+
+// Runs a reorder on a new fp16 tensor of the given shape, and returns its
+// input and output.
+Tensor* doSmvReorder(Workspace* workspace,
+                     const TensorShape& inputShape,
+                     DataLayout targetLayout,
+                     Tensor** inputPtr) {
+    auto reorderOp =
+            new ReorderOp<SmvBackend>("reorder", targetLayout, workspace);
+    Tensor* input = new Tensor("input", inputShape);
+    float16* inputData = input->allocateStorage<float16>();
+    for (int i = 0; i < inputShape.storageSize(); i++)
+        inputData[i] = fp16(i % 2048);
+    workspace->addTensor(input);
+    reorderOp->setInput(input, 0);
+    reorderOp->createAllTensors();
+    Tensor* output = reorderOp->getOutput(0);
+    output->allocateStorage<float16>();
+    reorderOp->run();
+    *inputPtr = input;
+    return output;
+}
+
+TEST_CASE_METHOD(SmaugTest, "Blocked and multithreaded reorders", "[refop]") {
+    // Odd sizes cover both the full and the partial transpose blocks, and
+    // the alignment padding of the innermost dimensions. The 4D layout
+    // conversions are large enough to be split across the threads.
+    ThreadPool* savedThreadPool = threadPool;
+    threadPool = new ThreadPool(4);
+    threadPool->initThreadPool();
+    SECTION("NCHW to NHWC") {
+        Tensor* input;
+        Tensor* output = doSmvReorder(
+                workspace(),
+                TensorShape({ 2, 61, 45, 53 }, DataLayout::NCHW, 8),
+                DataLayout::NHWC, &input);
+        auto inputIdx = input->startIndex();
+        auto outputIdx = output->startIndex();
+        float16* inputData = input->data<float16>();
+        float16* outputData = output->data<float16>();
+        for (int n = 0; n < 2; n++)
+            for (int c = 0; c < 61; c++)
+                for (int h = 0; h < 45; h++)
+                    for (int w = 0; w < 53; w++)
+                        REQUIRE(outputData[outputIdx(n, h, w, c)] ==
+                                inputData[inputIdx(n, c, h, w)]);
+    }
+    SECTION("NHWC to NCHW") {
+        Tensor* input;
+        Tensor* output = doSmvReorder(
+                workspace(),
+                TensorShape({ 2, 45, 53, 61 }, DataLayout::NHWC, 8),
+                DataLayout::NCHW, &input);
+        auto inputIdx = input->startIndex();
+        auto outputIdx = output->startIndex();
+        float16* inputData = input->data<float16>();
+        float16* outputData = output->data<float16>();
+        for (int n = 0; n < 2; n++)
+            for (int h = 0; h < 45; h++)
+                for (int w = 0; w < 53; w++)
+                    for (int c = 0; c < 61; c++)
+                        REQUIRE(outputData[outputIdx(n, c, h, w)] ==
+                                inputData[inputIdx(n, h, w, c)]);
+    }
+    SECTION("Flatten") {
+        for (int chans : { 13, 16 }) {
+            Tensor* input;
+            Tensor* output = doSmvReorder(
+                    workspace(),
+                    TensorShape({ 3, 5, 7, chans }, DataLayout::NHWC, 8),
+                    DataLayout::NC, &input);
+            auto inputIdx = input->startIndex();
+            auto outputIdx = output->startIndex();
+            float16* inputData = input->data<float16>();
+            float16* outputData = output->data<float16>();
+            for (int n = 0; n < 3; n++) {
+                int i = 0;
+                for (int h = 0; h < 5; h++)
+                    for (int w = 0; w < 7; w++)
+                        for (int c = 0; c < chans; c++)
+                            REQUIRE(outputData[outputIdx(n, i++)] ==
+                                    inputData[inputIdx(n, h, w, c)]);
+            }
+        }
+    }
+    SECTION("3D transpose") {
+        Tensor* input;
+        Tensor* output =
+                doSmvReorder(workspace(),
+                             TensorShape({ 3, 19, 21 }, DataLayout::NCT, 8),
+                             DataLayout::NTC, &input);
+        auto inputIdx = input->startIndex();
+        auto outputIdx = output->startIndex();
+        float16* inputData = input->data<float16>();
+        float16* outputData = output->data<float16>();
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 19; j++)
+                for (int k = 0; k < 21; k++)
+                    REQUIRE(outputData[outputIdx(i, k, j)] ==
+                            inputData[inputIdx(i, j, k)]);
+    }
+    SECTION("2D transpose") {
+        Tensor* input;
+        Tensor* output = doSmvReorder(
+                workspace(), TensorShape({ 37, 29 }, DataLayout::NC, 8),
+                DataLayout::CN, &input);
+        auto inputIdx = input->startIndex();
+        auto outputIdx = output->startIndex();
+        float16* inputData = input->data<float16>();
+        float16* outputData = output->data<float16>();
+        for (int n = 0; n < 37; n++)
+            for (int c = 0; c < 29; c++)
+                REQUIRE(outputData[outputIdx(c, n)] ==
+                        inputData[inputIdx(n, c)]);
+    }
+    delete threadPool;
+    threadPool = savedThreadPool;
+}
@@ -71,19 +71,20 @@ class RepeatOp : public Operator {
         Tensor* input = getInput(0);
         Tensor* output = getOutput(0);
         int ndims = input->ndims();
-        std::vector<int> inputDims = input->getShape().dims();
-        std::vector<int> outputDims = output->getShape().dims();
-        std::vector<int> srcOrigin = std::vector<int>(ndims, 0);
+        const TensorDims& inputDims = input->getShape().dims();
+        const TensorDims& outputDims = output->getShape().dims();
+        TensorDims srcOrigin(ndims, 0);
         // Copy the first piece of input into output.
-        copyTensorRegion(output, input, srcOrigin, srcOrigin, inputDims);
+        parallelCopyTensorRegion(
+                output, input, srcOrigin, srcOrigin, inputDims);
         for (int i = ndims - 1; i >= 0; i--) {
-            std::vector<int> currCopyRegion = inputDims;
+            TensorDims currCopyRegion = inputDims;
             for (int j = i + 1; j < ndims; j++)
                 currCopyRegion[j] = outputDims[j];
-            std::vector<int> dstOrigin(ndims, 0);
+            TensorDims dstOrigin(ndims, 0);
             dstOrigin[i] = inputDims[i];
             while (dstOrigin[i] + currCopyRegion[i] <= outputDims[i]) {
-                copyTensorRegion(
+                parallelCopyTensorRegion(
                         output, output, dstOrigin, srcOrigin, currCopyRegion);
                 dstOrigin[i] += currCopyRegion[i];
                 // Double the copy size for the next iteration.
@@ -92,7 +93,7 @@ class RepeatOp : public Operator {
             // Copy the remaining part if there's any.
             if (dstOrigin[i] < outputDims[i]) {
                 currCopyRegion[i] = outputDims[i] - dstOrigin[i];
-                copyTensorRegion(
+                parallelCopyTensorRegion(
                         output, output, dstOrigin, srcOrigin, currCopyRegion);
             }
         }
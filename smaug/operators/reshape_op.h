@@ -56,10 +56,17 @@ class ReshapeOp : public Operator {
         outputs.at(0) = output;
     }
 
+    /** Makes the output a view into the input if both store the same rows. */
+    void aliasOutputs() override {
+        aliasTensorStorage(getOutput(0), getInput(0));
+    }
+
     void run() override {
-        // Copy the input data.
         Tensor* input = getInput(0);
         Tensor* output = getOutput(0);
+        if (output->isViewOf(input, 0))
+            return;
+        // Copy the input data.
         const TensorShape& inputShape = input->getShape();
         const TensorShape& outputShape = output->getShape();
         int inputNumDims = input->ndims();
@@ -42,6 +42,17 @@ TEST_CASE_METHOD(SmaugTest, "Reshape reference backend", "[refop]") {
         REQUIRE(output->getShape().dims() == std::vector<int>{ 1, 2, 2, 2 });
         verifyOutputs(output, inputValues);
     }
+
+    SECTION("Reshape as a view of the input") {
+        reshapeOp->setShape({ 4, 2 }, DataLayout::NC);
+        reshapeOp->createAllTensors();
+        allocateAllTensors<float>(reshapeOp);
+        reshapeOp->aliasOutputs();
+        auto output = reshapeOp->getOutput(0);
+        REQUIRE(output->isViewOf(input, 0));
+        reshapeOp->run();
+        verifyOutputs(output, inputValues);
+    }
 }
 
 TEST_CASE_METHOD(SmaugTest, "Reshape SMV backend", "[smvop]") {
@@ -63,6 +74,9 @@ TEST_CASE_METHOD(SmaugTest, "Reshape SMV backend", "[smvop]") {
         reshapeOp->setShape({ 4, 2 }, DataLayout::NC);
         reshapeOp->createAllTensors();
         allocateAllTensors<float16>(reshapeOp);
+        // The rows are padded differently, so the data must be copied.
+        reshapeOp->aliasOutputs();
+        REQUIRE_FALSE(reshapeOp->getOutput(0)->isView());
         reshapeOp->run();
         auto output = reshapeOp->getOutput(0);
         REQUIRE(output->getShape().getLayout() == DataLayout::NC);
@@ -93,4 +107,16 @@ TEST_CASE_METHOD(SmaugTest, "Reshape SMV backend", "[smvop]") {
         REQUIRE(output->getShape().dims() == std::vector<int>{ 1, 2, 2, 2 });
         verifyOutputs<float16>(output, input);
     }
+
+    SECTION("Reshape with the same rows as a view of the input") {
+        reshapeOp->setShape({ 2, 1, 4 }, DataLayout::NTC);
+        reshapeOp->createAllTensors();
+        allocateAllTensors<float16>(reshapeOp);
+        reshapeOp->aliasOutputs();
+        auto output = reshapeOp->getOutput(0);
+        REQUIRE(output->isViewOf(input, 0));
+        reshapeOp->run();
+        REQUIRE(output->getShape().getPadding(2) == 4);
+        verifyOutputs<float16>(output, input);
+    }
 }
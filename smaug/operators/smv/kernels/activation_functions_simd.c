@@ -1,3 +1,5 @@
+#include <float.h>
+
 #include "smaug/operators/common.h"
 #include "smaug/operators/smv/kernels/load_store_fp16_data.h"
 #include "smaug/operators/smv/kernels/activation_functions_simd.h"
@@ -24,9 +26,107 @@ void smv_activation_fun_nc_vec_fxp(float16* host_inputs,
     host_store_fp16(results, host_results, inputs_size, 0, 0);
 }
 
+// The number of vectors whose maximum is taken at once when updating the
+// running softmax state. The sum is only rescaled once per block.
+#define SOFTMAX_BLOCK_VECS 8
+
+// Returns a mask of the lanes of the j-th vector of a row that are within the
+// first size elements of the row.
+ALWAYS_INLINE
+static inline v8sfx_t softmax_lane_mask(int j, int size) {
+    v8sfx_t lanes = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    return (lanes + j * VECTOR_SIZE) < size;
+}
+
+// Updates the running maximum and sum of exponentials of a softmax row with
+// the first size elements of inputs.
+//
+// The state is kept per lane: max holds the largest input seen by each lane,
+// and sum the sum of exp(input - max). Each block of vectors raises the
+// maximum first and rescales the sum once, so the inputs are only read once
+// (online softmax).
+ALWAYS_INLINE
+static inline void softmax_update_stats(v8fp_t* inputs,
+                                        int size,
+                                        v8fp_t* max,
+                                        v8fp_t* sum) {
+    v8fp_t lowest = (v8fp_t){ 0 } - FLT_MAX;
+    int num_vecs = FRAC_CEIL(size, VECTOR_SIZE);
+    softmax_stats_block:
+    for (int b = 0; b < num_vecs; b += SOFTMAX_BLOCK_VECS) {
+        int block_end = b + SOFTMAX_BLOCK_VECS;
+        if (block_end > num_vecs)
+            block_end = num_vecs;
+        v8fp_t block_max = *max;
+        softmax_block_max:
+        for (int j = b; j < block_end; j++) {
+            v8fp_t input = VEC256_SELECT(
+                    softmax_lane_mask(j, size), inputs[j], lowest);
+            block_max = VEC256_SELECT(input > block_max, input, block_max);
+        }
+        *sum *= exp_vec_unit(*max - block_max);
+        softmax_block_sum:
+        for (int j = b; j < block_end; j++) {
+            *sum += VEC256_MASK(exp_vec_unit(inputs[j] - block_max),
+                                softmax_lane_mask(j, size));
+        }
+        *max = block_max;
+    }
+}
+
+// Updates the softmax state of a row, given as its maximum and sum of
+// exp(input - max), with the first size elements of inputs.
+ALWAYS_INLINE
+static inline void softmax_row_stats(v8fp_t* inputs,
+                                     int size,
+                                     float* row_max,
+                                     float* row_sum) {
+    // The state of the row is carried by the first lane.
+    v8fp_t max = (v8fp_t){ 0 } + *row_max;
+    v8fp_t sum = (v8fp_t){ *row_sum };
+    softmax_update_stats(inputs, size, &max, &sum);
+
+    // Merge the lanes.
+    float merged_max = max[0];
+    softmax_merge_max:
+    for (int k = 1; k < VECTOR_SIZE; k++) {
+        if (max[k] > merged_max)
+            merged_max = max[k];
+    }
+    v8fp_t scaled_sum = sum * exp_vec_unit(max - merged_max);
+    float merged_sum = 0;
+    softmax_merge_sum:
+    for (int k = 0; k < VECTOR_SIZE; k++)
+        merged_sum += scaled_sum[k];
+    *row_max = merged_max;
+    *row_sum = merged_sum;
+}
+
+// Computes exp(input - row_max) / row_sum for the first size elements of a
+// row, and zeros the rest of its last vector.
+ALWAYS_INLINE
+static inline void softmax_row_normalize(v8fp_t* inputs,
+                                         v8fp_t* results,
+                                         int size,
+                                         float row_max,
+                                         float row_sum) {
+    // Precompute the division so that later we can just do a multiplication.
+    float scale = 1.0f / row_sum;
+    int num_vecs = FRAC_CEIL(size, VECTOR_SIZE);
+    softmax_mul:
+    for (int j = 0; j < num_vecs; j++) {
+        v8fp_t result = exp_vec_unit(inputs[j] - row_max) * scale;
+        results[j] = VEC256_MASK(result, softmax_lane_mask(j, size));
+    }
+}
+
 /** \ingroup AladdinKernels
  *
- * Top level function for softmax.
+ * Top level function for softmax, on tiles that hold whole rows.
+ *
+ * Each row is read once to compute its maximum and sum of exponentials
+ * (online softmax), and once more to write the normalized results. The
+ * maximum is subtracted from the inputs, so large inputs do not overflow.
  */
 void smv_softmax_nc_vec_fxp(float16* host_inputs,
                             float16* host_results,
@@ -41,40 +141,81 @@ void smv_softmax_nc_vec_fxp(float16* host_inputs,
 
     VEC_ARRAY_2D(v8fp_t, _inputs, inputs, input_size + input_pad);
     VEC_ARRAY_2D(v8fp_t, _results, results, input_size + input_pad);
-    int input_vec_size = input_size / VECTOR_SIZE;
 
     softmax_batch:
     for (int i = 0; i < input_num; i++) {
-        // Exponentiate.
-        softmax_exp:
-        for (int j = 0; j < input_vec_size; j++) {
-            softmax_exp_vec:
-            for (int k = 0; k < VECTOR_SIZE; k++)
-                _results[i][j][k] = exp(_inputs[i][j][k]);
-        }
+        float row_max = -FLT_MAX;
+        float row_sum = 0;
+        softmax_row_stats(_inputs[i], input_size, &row_max, &row_sum);
+        softmax_row_normalize(
+                _inputs[i], _results[i], input_size, row_max, row_sum);
+    }
 
-        // Compute the normalization factor.
-        float normaliz = 0.0;
-        softmax_reduce:
-        for (int j = 0; j < input_vec_size; j++) {
-            softmax_reduce_vec:
-            for (int k = 0; k < VECTOR_SIZE; k++)
-                normaliz += _results[i][j][k];
-        }
+    // Store results to the host memory.
+    host_store_fp16(
+            results, host_results, input_num * (input_size + input_pad), 0, 0);
+}
 
-        // Precompute the division so that later we can just do a
-        // multiplication.
-        normaliz = 1.0 / (normaliz + 1e-6);  // epsilon for numerical stability.
+/** \ingroup AladdinKernels
+ *
+ * First pass of a softmax whose rows are split along C into several tiles.
+ *
+ * This merges a tile into the softmax state of its rows: stats holds the
+ * running maximum of row i at index i, and its sum of exp(input - max) at
+ * index input_num + i. The state is reset when init_stats is set, i.e. for
+ * the first tile of the rows. Once all the tiles of the rows have been seen,
+ * smv_softmax_normalize_nc_vec_fxp writes the results.
+ */
+void smv_softmax_stats_nc_vec_fxp(float16* host_inputs,
+                                  float* inputs,
+                                  float* stats,
+                                  int input_num,
+                                  int input_size,
+                                  int input_pad,
+                                  bool init_stats) {
+    host_load_fp16(
+            inputs, host_inputs, input_num * (input_size + input_pad), 0, 0);
 
-        softmax_mul:
-        for (int j = 0; j < input_vec_size; j++) {
-            softmax_mul_vec:
-            for (int k = 0; k < VECTOR_SIZE; k++)
-                _results[i][j][k] *= normaliz;
+    VEC_ARRAY_2D(v8fp_t, _inputs, inputs, input_size + input_pad);
+
+    softmax_stats_batch:
+    for (int i = 0; i < input_num; i++) {
+        if (init_stats) {
+            stats[i] = -FLT_MAX;
+            stats[input_num + i] = 0;
         }
+        softmax_row_stats(
+                _inputs[i], input_size, &stats[i], &stats[input_num + i]);
+    }
+}
+
+/** \ingroup AladdinKernels
+ *
+ * Second pass of a softmax whose rows are split along C into several tiles.
+ *
+ * This normalizes a tile with the softmax state of its rows computed by
+ * smv_softmax_stats_nc_vec_fxp over all the tiles of the rows.
+ */
+void smv_softmax_normalize_nc_vec_fxp(float16* host_inputs,
+                                      float16* host_results,
+                                      float* inputs,
+                                      float* results,
+                                      float* stats,
+                                      int input_num,
+                                      int input_size,
+                                      int input_pad) {
+    host_load_fp16(
+            inputs, host_inputs, input_num * (input_size + input_pad), 0, 0);
+
+    VEC_ARRAY_2D(v8fp_t, _inputs, inputs, input_size + input_pad);
+    VEC_ARRAY_2D(v8fp_t, _results, results, input_size + input_pad);
+
+    softmax_normalize_batch:
+    for (int i = 0; i < input_num; i++) {
+        softmax_row_normalize(_inputs[i], _results[i], input_size, stats[i],
+                              stats[input_num + i]);
     }
 
-    // Store results to the host memory.
     host_store_fp16(
             results, host_results, input_num * (input_size + input_pad), 0, 0);
 }
@@ -0,0 +1,89 @@
+#include <cmath>
+#include <cstring>
+
+#include "catch.hpp"
+#include "smaug/core/smaug_test.h"
+#include "smaug/operators/smv/kernels/activation_functions_simd.h"
+
+using namespace smaug;
+
+// Returns the error of a result in units in the last place of the exact
+// result.
+double ulpError(float result, double exact) {
+    int exponent;
+    std::frexp((float)exact, &exponent);
+    double ulp = std::ldexp(1.0, std::max(exponent, -125) - 24);
+    return std::fabs(result - exact) / ulp;
+}
+
+// Evaluates a vector function on samples of all the floats between min and
+// max, and returns the maximum error against the exact function in ULPs.
+template <typename VecFunc, typename ExactFunc>
+double maxUlpError(VecFunc vecFunc, ExactFunc exactFunc, float min, float max) {
+    double maxError = 0;
+    v8fp_t inputs;
+    int lane = 0;
+    auto flush = [&]() {
+        v8fp_t results = vecFunc(inputs);
+        for (int i = 0; i < lane; i++) {
+            maxError = std::max(maxError,
+                                ulpError(results[i], exactFunc(inputs[i])));
+        }
+        lane = 0;
+    };
+    // Step through the bit patterns, so that every binade is sampled.
+    for (uint32_t bits = 0; bits < 0x7f800000; bits += 97) {
+        float value;
+        memcpy(&value, &bits, sizeof(float));
+        for (float input : { value, -value }) {
+            if (input < min || input > max)
+                continue;
+            inputs[lane++] = input;
+            if (lane == VECTOR_SIZE)
+                flush();
+        }
+    }
+    flush();
+    return maxError;
+}
+
+TEST_CASE_METHOD(SmaugTest,
+                 "Vectorized transcendental functions",
+                 "[smvactivation]") {
+    SECTION("exp") {
+        double error = maxUlpError(
+                [](v8fp_t a) { return exp_vec_unit(a); },
+                [](double x) { return std::exp(x); }, -87.3, 88.3);
+        REQUIRE(error <= 1);
+    }
+    SECTION("sigmoid") {
+        double error = maxUlpError(
+                [](v8fp_t a) { return sigmoid_vec_unit(a); },
+                [](double x) { return 1 / (1 + std::exp(-x)); }, -87, 100);
+        REQUIRE(error <= 2.5);
+    }
+    SECTION("tanh") {
+        double error = maxUlpError(
+                [](v8fp_t a) { return tanh_vec_unit(a); },
+                [](double x) { return std::tanh(x); }, -100, 100);
+        REQUIRE(error <= 1.5);
+    }
+    SECTION("Saturation") {
+        v8fp_t inputs = { -1000, -100, -88, 0, 1, 88, 100, 1000 };
+        v8fp_t exps = exp_vec_unit(inputs);
+        v8fp_t sigmoids = sigmoid_vec_unit(inputs);
+        v8fp_t tanhs = tanh_vec_unit(inputs);
+        for (int i = 0; i < VECTOR_SIZE; i++) {
+            REQUIRE(std::isfinite(exps[i]));
+            REQUIRE(exps[i] >= 0);
+            REQUIRE(sigmoids[i] >= 0);
+            REQUIRE(sigmoids[i] <= 1);
+            REQUIRE(tanhs[i] >= -1);
+            REQUIRE(tanhs[i] <= 1);
+        }
+        REQUIRE(sigmoids[0] < 1e-37);
+        REQUIRE(sigmoids[7] == 1);
+        REQUIRE(tanhs[0] == -1);
+        REQUIRE(tanhs[7] == 1);
+    }
+}
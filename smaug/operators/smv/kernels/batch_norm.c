@@ -32,6 +32,21 @@ v8fp_t batch_norm_simd_op(v8fp_t input,
     return shift * scale + beta;
 }
 
+/** \ingroup AladdinKernels
+ *
+ * Batch normalizes one input value with the fused weights of its channel.
+ *
+ * @param input Input activation.
+ * @param scale gamma / sqrt(var + eps).
+ * @param shift beta - mean * scale.
+ */
+ALWAYS_INLINE
+v8fp_t batch_norm_scale_shift_simd_op(v8fp_t input,
+                                      v8fp_t scale,
+                                      v8fp_t shift) {
+    return input * scale + shift;
+}
+
 /** \ingroup AladdinKernels
  *
  * SMV implementation of batch normalization following a fully-connected layer.
@@ -277,6 +292,156 @@ void smv_batch_norm_post_conv_nhwc_vec_fxp(float16* host_inputs,
     host_store_fp16(results, host_results, results_size, 0, 0);
 }
 
+/** \ingroup AladdinKernels
+ *
+ * SMV implementation of batch normalization following a fully-connected
+ * layer, with the weights folded into a scale and a shift per activation.
+ *
+ * The weights are two rows, the scales and then the shifts, so that each
+ * element takes one multiply-add. They are kept in single precision, since
+ * the shifts fold the mean in and would lose too much of it in fp16.
+ * Otherwise, the arguments are the same as in
+ * smv_batch_norm_post_fc_nc_vec_fxp().
+ */
+void smv_batch_norm_scale_shift_post_fc_nc_vec_fxp(
+        float16* host_inputs,
+        float* host_weights,
+        float16* host_results,
+        float* inputs,
+        float* weights,
+        float* results,
+        int inputs_dims[2],
+        int weights_acts,
+        int inputs_pad,
+        int inputs_start,
+        int send_results,
+        activation_type act_function,
+        activation_param_t act_params) {
+    int inputs_nums = inputs_dims[0];
+    int inputs_acts = inputs_dims[1];
+    int inputs_size = inputs_nums * (inputs_acts + inputs_pad);
+    int weights_size = 2 * (weights_acts + inputs_pad);
+    int results_size = inputs_size;
+    int inputs_start_vec = inputs_start / VECTOR_SIZE;
+
+    // Load inputs and weights if needed.
+    if (inputs_start == 0)
+        host_load_fp16(inputs, host_inputs, inputs_size, 0, 0);
+    hostLoad(weights, host_weights, weights_size * sizeof(float));
+
+    VEC_ARRAY_2D(v8fp_t, _inputs, inputs, inputs_acts + inputs_pad);
+    VEC_ARRAY_2D(v8fp_t, _weights, weights, weights_acts + inputs_pad);
+    VEC_ARRAY_2D(v8fp_t, _results, results, inputs_acts + inputs_pad);
+
+    bn_batch:
+    for (int i = 0; i < inputs_nums; i++) {
+        bn_input:
+        for (int j = 0; j < weights_acts / VECTOR_SIZE; j++) {
+            _results[i][j + inputs_start_vec] = batch_norm_scale_shift_simd_op(
+                    _inputs[i][j + inputs_start_vec], _weights[0][j],
+                    _weights[1][j]);
+        }
+    }
+    // Only run activation functions when the results are finished.
+    if (act_function != NO_ACTIVATION && send_results) {
+        activation_fun_vec(
+                results, results, results_size, act_function, act_params);
+    }
+    // Store results to the host memory if needed.
+    if (send_results)
+        host_store_fp16(results, host_results, results_size, 0, 0);
+}
+
+/** \ingroup AladdinKernels
+ *
+ * SMV implementation of batch normalization following a convolutional/pooling
+ * layer on NHWC data, with the weights folded into a scale and a shift per
+ * feature map.
+ *
+ * The weights are two single-precision rows, the scales and then the
+ * shifts, so that each element takes one multiply-add. Otherwise, the
+ * arguments are the same as in smv_batch_norm_post_conv_nhwc_vec_fxp().
+ */
+void smv_batch_norm_scale_shift_post_conv_nhwc_vec_fxp(
+        float16* host_inputs,
+        float* host_weights,
+        float16* host_results,
+        float* inputs,
+        float* weights,
+        float* results,
+        int inputs_dims[4],
+        int weights_chans,
+        int inputs_pad,
+        int weights_pad,
+        int weights_start,
+        activation_type act_function,
+        activation_param_t act_params,
+        SamplingInfo* sampling) {
+    int inputs_nums = inputs_dims[0];
+    int inputs_rows = inputs_dims[1];
+    int inputs_cols = inputs_dims[2];
+    int inputs_chans = inputs_dims[3];
+    int inputs_size = inputs_nums * inputs_rows * inputs_cols *
+                      (inputs_chans + inputs_pad);
+    int weights_size = 2 * (weights_chans + weights_pad);
+    int results_size = inputs_size;
+    int weights_start_vec = weights_start / VECTOR_SIZE;
+    int inputs_chans_vec = FRAC_CEIL(inputs_chans, VECTOR_SIZE);
+
+    // Load inputs and weights if needed.
+    host_load_fp16(inputs, host_inputs, inputs_size, 0, 0);
+    if (weights_start == 0)
+        hostLoad(weights, host_weights, weights_size * sizeof(float));
+
+    VEC_ARRAY_4D(v8fp_t, _inputs, inputs, inputs_rows, inputs_cols,
+                 inputs_chans + inputs_pad);
+    VEC_ARRAY_2D(v8fp_t, _weights, weights, weights_chans + weights_pad);
+    VEC_ARRAY_4D(v8fp_t, _results, results, inputs_rows, inputs_cols,
+                 inputs_chans + inputs_pad);
+
+    // We sample on the bn kernel only if the highest sampling level is
+    // used.
+    int batch_sample = inputs_nums;
+    int chan_sample = inputs_chans_vec;
+    int row_sample = inputs_rows;
+    int col_sample = inputs_cols;
+    int sample_num = sampling->num_sample_iterations;
+    if (sampling->level >= VeryHigh) {
+        batch_sample = min2(batch_sample, sample_num);
+        chan_sample = min2(chan_sample, sample_num);
+        row_sample = min2(row_sample, sample_num);
+        col_sample = min2(col_sample, sample_num);
+    }
+    setSamplingFactor("bn_batch", inputs_nums * 1.0 / batch_sample);
+    setSamplingFactor("bn_chan", inputs_chans_vec * 1.0 / chan_sample);
+    setSamplingFactor("bn_row", inputs_rows * 1.0 / row_sample);
+    setSamplingFactor("bn_col", inputs_cols * 1.0 / col_sample);
+
+    // The channels are innermost, so that the inputs are streamed in order.
+    bn_batch:
+    for (int i = 0; i < batch_sample; i++) {
+        bn_row:
+        for (int r = 0; r < row_sample; r++) {
+            bn_col:
+            for (int c = 0; c < col_sample; c++) {
+                bn_chan:
+                for (int h = 0; h < chan_sample; h++) {
+                    _results[i][r][c][h] = batch_norm_scale_shift_simd_op(
+                            _inputs[i][r][c][h],
+                            _weights[0][h + weights_start_vec],
+                            _weights[1][h + weights_start_vec]);
+                }
+            }
+        }
+    }
+    if (act_function != NO_ACTIVATION) {
+        activation_fun_vec(
+                results, results, results_size, act_function, act_params);
+    }
+    // Store results to the host memory.
+    host_store_fp16(results, host_results, results_size, 0, 0);
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
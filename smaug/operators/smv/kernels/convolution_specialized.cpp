@@ -0,0 +1,302 @@
+#include <cmath>
+#include <cstring>
+
+#include "smaug/operators/common.h"
+#include "smaug/operators/smv/kernels/params.h"
+#include "smaug/operators/smv/kernels/load_store_fp16_data.h"
+#include "smaug/operators/smv/kernels/activation_functions_simd.h"
+#include "smaug/operators/smv/kernels/convolution_specialized.h"
+#include "smaug/operators/smv/kernels/cpu_kernels.h"
+#include "smaug/utility/utils.h"
+
+// This file is also built for the other instruction sets (see
+// cpu_kernels_variant.h), each of which defines its own namespace.
+#ifndef SMV_CPU_ISA
+#define SMV_CPU_ISA sse
+#endif
+
+namespace smaug {
+namespace smv {
+namespace conv {
+namespace SMV_CPU_ISA {
+
+/**
+ * The number of output pixels computed together by the unrolled kernels. The
+ * partial sums of the block take half of the 16 vector registers of SSE,
+ * where a vector of VECTOR_SIZE floats takes two registers.
+ */
+#ifndef CONV_BLOCK_PIXELS
+#define CONV_BLOCK_PIXELS 4
+#endif
+
+/**
+ * Accumulates one filter tap into a vector of output channels of a block of
+ * Pixels output pixels. The loops are fully unrolled so that the partial
+ * sums stay in registers.
+ *
+ * @param chans The number of input channels.
+ * @param weight The transposed weights of the tap, one vector per channel.
+ * @param act The input channels of the tap for each output pixel.
+ * @param accum_reg The partial sums of the output pixels.
+ */
+template <int Pixels>
+static inline void conv_tap_block(int chans,
+                                  const v8fp_t* weight,
+                                  const float* act[Pixels],
+                                  v8fp_t accum_reg[Pixels]) {
+    v8fp_t accum[Pixels];
+    for (int p = 0; p < Pixels; p++)
+        accum[p] = accum_reg[p];
+
+    chan_iteration:
+    for (int chan = 0; chan < chans; chan++) {
+        v8fp_t w = weight[chan];
+        for (int p = 0; p < Pixels; p++) {
+            float x = act[p][chan];
+            v8fp_t x_vec = { x, x, x, x, x, x, x, x };
+            accum[p] += x_vec * w;
+        }
+    }
+    for (int p = 0; p < Pixels; p++)
+        accum_reg[p] = accum[p];
+}
+
+/**
+ * Performs the same computation as smv_conv3d_nhwc_vec_fxp, with the number
+ * of PEs, the filter size and the strides fixed at compile time so that the
+ * loops are fully unrolled. NumPEs must be a multiple of VECTOR_SIZE.
+ *
+ * Rather than reducing across the channels of every kernel, the weights of a
+ * group of NumPEs kernels are transposed so that the lanes of the vectors
+ * hold the output channels. Each input channel is then broadcast and
+ * accumulated into a block of output pixels, which needs no reduction and
+ * reuses every vector of weights across the block.
+ *
+ * Sampling is not supported, as this never runs in simulation.
+ */
+template <int NumPEs, int KRows, int KCols, int RowStride, int ColStride>
+void smv_conv3d_nhwc_vec_fxp_unrolled(float16* host_inputs,
+                                      float16* host_weights,
+                                      float16* host_results,
+                                      float* inputs,
+                                      float* weights,
+                                      float* results,
+                                      int inputs_dims[4],
+                                      int weights_dims[4],
+                                      int results_dims[4],
+                                      int inputs_align_pad,
+                                      int weights_pad,
+                                      int results_pad,
+                                      int inputs_halo_pad[4],
+                                      int row_stride,
+                                      int col_stride,
+                                      int ifmap_start,
+                                      int kern_start,
+                                      bool accumulate,
+                                      bool read_inputs,
+                                      bool read_weights,
+                                      bool send_results,
+                                      activation_type act_function,
+                                      activation_param_t act_params,
+                                      SamplingInfo* sampling) {
+    ASSERT(weights_dims[1] == KRows && weights_dims[2] == KCols &&
+           "The filter size does not match the specialization!");
+    ASSERT(row_stride == RowStride && col_stride == ColStride &&
+           "The strides do not match the specialization!");
+    int result_rows = results_dims[1];
+    int result_cols = results_dims[2];
+    int result_height = results_dims[3];
+    int results_size = results_dims[0] * result_rows * result_cols *
+                       (result_height + results_pad);
+
+    int k_height = weights_dims[3];
+    int k_pad = weights_pad;
+    int weights_size = weights_dims[0] * KRows * KCols * (k_height + k_pad);
+
+    int a_rows = inputs_dims[1];
+    int a_cols = inputs_dims[2];
+    int a_height = inputs_dims[3];
+    int a_pad = inputs_align_pad;
+    int inputs_size = inputs_dims[0] * a_rows * a_cols * (a_height + a_pad);
+
+    int top_pad = inputs_halo_pad[0];
+    int bottom_pad = inputs_halo_pad[1];
+    int left_pad = inputs_halo_pad[2];
+    int right_pad = inputs_halo_pad[3];
+    int end_row = a_rows + top_pad + bottom_pad - KRows + 1;
+    int end_col = a_cols + left_pad + right_pad - KCols + 1;
+    int output_rows = FRAC_CEIL(end_row, RowStride);
+    int output_cols = FRAC_CEIL(end_col, ColStride);
+
+    // The output channels of each block of NumPEs kernels span kVecs vectors.
+    const int kVecs = NumPEs / VECTOR_SIZE;
+    const int kPixels = CONV_BLOCK_PIXELS;
+    const v8fp_t zero = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    int a_width = a_height + a_pad;
+    // Like the generic kernel, the last vector of channels is not masked.
+    int chans = FRAC_CEIL(k_height, VECTOR_SIZE) * VECTOR_SIZE;
+    int num_eff_kernels = min2(weights_dims[0], result_height);
+    int num_kernel_blocks = FRAC_CEIL(num_eff_kernels, NumPEs);
+
+    ARRAY_4D(float, _kernels, weights, KRows, KCols, k_height + k_pad);
+    ARRAY_3D(float, _a, inputs, a_cols, a_width);
+    VEC_ARRAY_3D(
+            v8fp_t, _result, results, result_cols, result_height + results_pad);
+    // The weights of a block of NumPEs kernels, transposed so that the
+    // vectors of each channel hold one weight of VECTOR_SIZE kernels,
+    // followed by a row of zeros that stands in for the inputs in the halo
+    // padding.
+    float* packed = (float*)malloc_aligned(
+            (KRows * KCols * NumPEs + 1) * chans * sizeof(float));
+    ARRAY_5D(float, _packed, packed, KCols, kVecs, chans, VECTOR_SIZE);
+    float* zeros = packed + KRows * KCols * chans * NumPEs;
+    memset(zeros, 0, chans * sizeof(float));
+
+    if (read_inputs)
+        host_load_fp16(inputs, host_inputs, inputs_size, 0, 0);
+    if (read_weights)
+        host_load_fp16(weights, host_weights, weights_size, 0, 0);
+
+    ofmap_block_iteration:
+    for (int ofmap_iters = 0; ofmap_iters < num_kernel_blocks; ofmap_iters++) {
+        int ofmap_offset = ofmap_iters * NumPEs;
+        int kEffNumPeInsts = min2(result_height - ofmap_offset, NumPEs);
+        // The vectors of output channels that exist in the results.
+        int eff_vecs = FRAC_CEIL(kEffNumPeInsts, VECTOR_SIZE);
+        int result_vec = ofmap_iters * kVecs;
+        int kern_offset = kern_start + ofmap_offset;
+
+        pack_weights:
+        for (int kern_row = 0; kern_row < KRows; kern_row++) {
+            for (int kern_col = 0; kern_col < KCols; kern_col++) {
+                for (int pe_id = 0; pe_id < NumPEs; pe_id++) {
+                    int v = pe_id / VECTOR_SIZE;
+                    int lane = pe_id % VECTOR_SIZE;
+                    for (int chan = 0; chan < chans; chan++) {
+                        _packed[kern_row][kern_col][v][chan][lane] =
+                                pe_id < kEffNumPeInsts
+                                        ? _kernels[kern_offset + pe_id]
+                                                  [kern_row][kern_col][chan]
+                                        : 0;
+                    }
+                }
+            }
+        }
+
+        conv3d_row:
+        for (int out_i = 0; out_i < output_rows; out_i++) {
+            int row_origin = out_i * RowStride - top_pad;
+
+            // Each iteration computes a block of kPixels output pixels, so
+            // that every vector of weights is reused across the block.
+            conv3d_col:
+            for (int out_j = 0; out_j < output_cols; out_j += kPixels) {
+                int block_cols = min2(kPixels, output_cols - out_j);
+                v8fp_t accum_reg[kVecs][kPixels];
+                for (int v = 0; v < kVecs; v++) {
+                    for (int p = 0; p < kPixels; p++) {
+                        accum_reg[v][p] =
+                                accumulate && p < block_cols && v < eff_vecs
+                                        ? _result[out_i][out_j + p]
+                                                 [result_vec + v]
+                                        : zero;
+                    }
+                }
+
+                k_row:
+                for (int kern_row = 0; kern_row < KRows; kern_row++) {
+                    int in_row = row_origin + kern_row;
+                    if (in_row < 0 || in_row >= a_rows)
+                        continue;
+                    k_col:
+                    for (int kern_col = 0; kern_col < KCols; kern_col++) {
+                        const float* act[kPixels];
+                        for (int p = 0; p < kPixels; p++) {
+                            int in_col = (out_j + p) * ColStride - left_pad +
+                                         kern_col;
+                            bool is_padding = p >= block_cols || in_col < 0 ||
+                                              in_col >= a_cols;
+                            act[p] = is_padding
+                                             ? zeros
+                                             : &_a[in_row][in_col][ifmap_start];
+                        }
+                        // Each vector of output channels is accumulated in
+                        // turn, which keeps the partial sums of the block in
+                        // registers for any number of PEs.
+                        for (int v = 0; v < eff_vecs; v++) {
+                            conv_tap_block<kPixels>(
+                                    chans,
+                                    (v8fp_t*)&_packed[kern_row][kern_col][v][0]
+                                                     [0],
+                                    act, accum_reg[v]);
+                        }
+                    }
+                }
+
+                for (int p = 0; p < block_cols; p++) {
+                    for (int v = 0; v < eff_vecs; v++) {
+                        _result[out_i][out_j + p][result_vec + v] =
+                                accum_reg[v][p];
+                    }
+                }
+            }
+        }
+    }
+    free(packed);
+
+    if (act_function != NO_ACTIVATION && send_results) {
+        activation_fun_vec(
+                results, results, results_size, act_function, act_params);
+    }
+    if (send_results)
+        host_store_fp16(results, host_results, results_size, 0, 0);
+}
+
+template <int NumPEs>
+Conv3dKernel* selectConv3dKernel(int kRows, int stride) {
+    if (kRows == 1 && stride == 1)
+        return smv_conv3d_nhwc_vec_fxp_unrolled<NumPEs, 1, 1, 1, 1>;
+    if (kRows == 3 && stride == 1)
+        return smv_conv3d_nhwc_vec_fxp_unrolled<NumPEs, 3, 3, 1, 1>;
+    if (kRows == 3 && stride == 2)
+        return smv_conv3d_nhwc_vec_fxp_unrolled<NumPEs, 3, 3, 2, 2>;
+    if (kRows == 5 && stride == 1)
+        return smv_conv3d_nhwc_vec_fxp_unrolled<NumPEs, 5, 5, 1, 1>;
+    if (kRows == 7 && stride == 2)
+        return smv_conv3d_nhwc_vec_fxp_unrolled<NumPEs, 7, 7, 2, 2>;
+    return nullptr;
+}
+
+Conv3dKernel* selectConv3dKernel(int kRows,
+                                 int kCols,
+                                 int rowStride,
+                                 int colStride,
+                                 int numPEs) {
+    Conv3dKernel* kernel = nullptr;
+    if (rowStride == colStride && kRows == kCols) {
+        if (numPEs == VECTOR_SIZE)
+            kernel = selectConv3dKernel<VECTOR_SIZE>(kRows, rowStride);
+        else if (numPEs == 2 * VECTOR_SIZE)
+            kernel = selectConv3dKernel<2 * VECTOR_SIZE>(kRows, rowStride);
+        else if (numPEs == 4 * VECTOR_SIZE)
+            kernel = selectConv3dKernel<4 * VECTOR_SIZE>(kRows, rowStride);
+    }
+    return kernel ? kernel : smv_conv3d_nhwc_vec_fxp;
+}
+
+}  // namespace SMV_CPU_ISA
+
+#ifndef SMV_CPU_ISA_VARIANT
+Conv3dKernel* selectConv3dKernel(int kRows,
+                                 int kCols,
+                                 int rowStride,
+                                 int colStride,
+                                 int numPEs) {
+    return getCpuKernels().selectConv3d(
+            kRows, kCols, rowStride, colStride, numPEs);
+}
+#endif
+
+}  // namespace conv
+}  // namespace smv
+}  // namespace smaug
@@ -0,0 +1,56 @@
+#ifndef _OPERATORS_SMV_KERNELS_CONVOLUTION_SPECIALIZED_H_
+#define _OPERATORS_SMV_KERNELS_CONVOLUTION_SPECIALIZED_H_
+
+#include "smaug/operators/smv/smv_kernels.h"
+#include "smaug/operators/smv/kernels/params.h"
+
+/**
+ * \file convolution_specialized.h
+ * \brief Convolution kernels specialized at compile time for common filter
+ * geometries, for the Cpu backend.
+ */
+
+namespace smaug {
+namespace smv {
+namespace conv {
+
+/**
+ * The type of a convolution kernel with the tile interface of
+ * smv_conv3d_nhwc_vec_fxp.
+ */
+typedef decltype(smv_conv3d_nhwc_vec_fxp) Conv3dKernel;
+
+/**
+ * The type of a function that returns the kernel specialized for the given
+ * number of PEs, filter size and strides, or the generic
+ * smv_conv3d_nhwc_vec_fxp if there is none.
+ */
+typedef Conv3dKernel* Conv3dKernelSelector(int kRows,
+                                           int kCols,
+                                           int rowStride,
+                                           int colStride,
+                                           int numPEs);
+
+/**
+ * Returns the specialized kernel for the given number of PEs, filter size and
+ * strides, built for the instruction set the Cpu backend runs with (see
+ * cpu_kernels.h), or the generic smv_conv3d_nhwc_vec_fxp if there is none.
+ * Specializations exist for 8, 16 and 32 PEs, and for 1x1 and 3x3 filters
+ * with stride 1, 3x3 with stride 2, 5x5 with stride 1 and 7x7 with stride 2.
+ */
+Conv3dKernel* selectConv3dKernel(int kRows,
+                                 int kCols,
+                                 int rowStride,
+                                 int colStride,
+                                 int numPEs = NUM_PE_INSTS);
+
+namespace sse {
+/** The kernel selector built for the baseline instruction set. */
+Conv3dKernelSelector selectConv3dKernel;
+}  // namespace sse
+
+}  // namespace conv
+}  // namespace smv
+}  // namespace smaug
+
+#endif
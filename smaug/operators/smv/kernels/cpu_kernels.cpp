@@ -0,0 +1,49 @@
+#include "smaug/operators/smv/kernels/cpu_kernels.h"
+
+namespace smaug {
+namespace smv {
+
+namespace sse {
+
+const CpuKernels kCpuKernels = {
+    Sse,
+    conv::sse::selectConv3dKernel,
+    smv_conv3d_nhwc_vec_fxp,
+    smv_depthwise_conv_nhwc_vec_fxp,
+    smv_winograd_filter_transform_f4x4_3x3,
+    smv_winograd_input_transform_f4x4_3x3,
+    smv_winograd_batched_gemm,
+    smv_winograd_output_transform_f4x4_3x3,
+    smv_matrix_multiply_transpose_nc_vec_fxp,
+    smv_packed_gemm_transpose_nc_vec_fxp,
+    smv_maxpooling_nhwc_vec_fxp,
+    smv_avgpooling_nhwc_vec_fxp,
+    smv_global_avgpooling_nhwc_vec_fxp,
+    smv_batch_norm_post_fc_nc_vec_fxp,
+    smv_batch_norm_post_conv_nchw_vec_fxp,
+    smv_batch_norm_post_conv_nhwc_vec_fxp,
+    smv_batch_norm_scale_shift_post_fc_nc_vec_fxp,
+    smv_batch_norm_scale_shift_post_conv_nhwc_vec_fxp,
+    smv_activation_fun_nc_vec_fxp,
+    smv_softmax_nc_vec_fxp,
+    smv_softmax_stats_nc_vec_fxp,
+    smv_softmax_normalize_nc_vec_fxp,
+};
+
+}  // namespace sse
+
+const CpuKernels& getCpuKernels(CpuIsa isa) {
+    switch (isa) {
+        case Avx512:
+            return avx512::kCpuKernels;
+        case Avx2:
+            return avx2::kCpuKernels;
+        default:
+            return sse::kCpuKernels;
+    }
+}
+
+const CpuKernels& getCpuKernels() { return getCpuKernels(getCpuIsa()); }
+
+}  // namespace smv
+}  // namespace smaug
@@ -0,0 +1,76 @@
+#ifndef _OPERATORS_SMV_KERNELS_CPU_KERNELS_H_
+#define _OPERATORS_SMV_KERNELS_CPU_KERNELS_H_
+
+#include "smaug/operators/smv/smv_kernels.h"
+#include "smaug/operators/smv/kernels/convolution_specialized.h"
+#include "smaug/utility/cpu_info.h"
+
+/**
+ * \file cpu_kernels.h
+ * \brief Registry of the SMV kernels that the Cpu backend runs natively, one
+ * set per instruction set.
+ *
+ * The whole binary is compiled for the baseline SSE3 that gem5 supports. The
+ * kernels the Cpu backend calls directly are also built from the same
+ * sources for AVX2 and AVX-512 (see cpu_kernels_variant.h), and the set that
+ * matches the host is selected once at startup from CPUID. The Smv backend
+ * always invokes the baseline kernels, which are the ones traced by Aladdin.
+ */
+
+namespace smaug {
+namespace smv {
+
+/** The kernels of the Cpu backend, built for one instruction set. */
+struct CpuKernels {
+    /** The instruction set the kernels are built for. */
+    CpuIsa isa;
+    /** Selects the (specialized) direct convolution kernel. */
+    conv::Conv3dKernelSelector* selectConv3d;
+    /** The generic direct convolution kernel. */
+    decltype(&smv_conv3d_nhwc_vec_fxp) conv3d;
+    decltype(&smv_depthwise_conv_nhwc_vec_fxp) depthwiseConv;
+    decltype(&smv_winograd_filter_transform_f4x4_3x3) winogradFilterTransform;
+    decltype(&smv_winograd_input_transform_f4x4_3x3) winogradInputTransform;
+    decltype(&smv_winograd_batched_gemm) winogradBatchedGemm;
+    decltype(&smv_winograd_output_transform_f4x4_3x3) winogradOutputTransform;
+    decltype(&smv_matrix_multiply_transpose_nc_vec_fxp) matrixMultiply;
+    decltype(&smv_packed_gemm_transpose_nc_vec_fxp) packedGemm;
+    decltype(&smv_maxpooling_nhwc_vec_fxp) maxPooling;
+    decltype(&smv_avgpooling_nhwc_vec_fxp) avgPooling;
+    decltype(&smv_global_avgpooling_nhwc_vec_fxp) globalAvgPooling;
+    decltype(&smv_batch_norm_post_fc_nc_vec_fxp) batchNormPostFc;
+    decltype(&smv_batch_norm_post_conv_nchw_vec_fxp) batchNormPostConvNchw;
+    decltype(&smv_batch_norm_post_conv_nhwc_vec_fxp) batchNormPostConvNhwc;
+    decltype(&smv_batch_norm_scale_shift_post_fc_nc_vec_fxp)
+            batchNormScaleShiftPostFc;
+    decltype(&smv_batch_norm_scale_shift_post_conv_nhwc_vec_fxp)
+            batchNormScaleShiftPostConvNhwc;
+    decltype(&smv_activation_fun_nc_vec_fxp) activation;
+    decltype(&smv_softmax_nc_vec_fxp) softmax;
+    decltype(&smv_softmax_stats_nc_vec_fxp) softmaxStats;
+    decltype(&smv_softmax_normalize_nc_vec_fxp) softmaxNormalize;
+};
+
+/** Returns the kernels built for the given instruction set. */
+const CpuKernels& getCpuKernels(CpuIsa isa);
+
+/**
+ * Returns the kernels built for the instruction set the Cpu backend runs
+ * with, i.e. getCpuIsa().
+ */
+const CpuKernels& getCpuKernels();
+
+namespace sse {
+extern const CpuKernels kCpuKernels;
+}  // namespace sse
+namespace avx2 {
+extern const CpuKernels kCpuKernels;
+}  // namespace avx2
+namespace avx512 {
+extern const CpuKernels kCpuKernels;
+}  // namespace avx512
+
+}  // namespace smv
+}  // namespace smaug
+
+#endif
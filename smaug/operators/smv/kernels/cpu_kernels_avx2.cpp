@@ -0,0 +1,10 @@
+// The kernels of the Cpu backend for AVX2 (with FMA and F16C). A vector of
+// VECTOR_SIZE floats fits in one of the 16 registers, so the specialized
+// convolutions accumulate twice as many output pixels as on SSE.
+
+#define SMV_CPU_ISA avx2
+#define SMV_CPU_ISA_ENUM Avx2
+#define SMV_CPU_ISA_TARGET "avx2,fma,f16c"
+#define CONV_BLOCK_PIXELS 8
+
+#include "smaug/operators/smv/kernels/cpu_kernels_variant.h"
@@ -0,0 +1,13 @@
+// The kernels of the Cpu backend for AVX-512 (F, VL, BW and DQ). The GEMM
+// micro-kernel works on rows of two vectors, which fill a 512-bit register,
+// and the other kernels get the 32 registers of AVX-512VL.
+
+#define SMV_CPU_ISA avx512
+#define SMV_CPU_ISA_ENUM Avx512
+#define SMV_CPU_ISA_TARGET                                                     \
+    "avx512f,avx512vl,avx512bw,avx512dq,avx2,fma,f16c,"                        \
+    "prefer-vector-width=512"
+#define CONV_BLOCK_PIXELS 8
+#define GEMM_NR_VECS 2
+
+#include "smaug/operators/smv/kernels/cpu_kernels_variant.h"
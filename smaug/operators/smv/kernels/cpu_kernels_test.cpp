@@ -0,0 +1,177 @@
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "catch.hpp"
+#include "smaug/core/smaug_test.h"
+#include "smaug/operators/smv/kernels/cpu_kernels.h"
+#include "smaug/utility/cpu_info.h"
+
+using namespace smaug;
+using namespace smaug::smv;
+
+// The kernels write whole cachelines, so the buffers are padded.
+constexpr int kBufferSize = 4096;
+
+typedef std::function<void(const CpuKernels&, float16*, float*, float*)>
+        KernelRun;
+
+std::vector<float16> randomFp16Data(int size, float scale = 1.0) {
+    std::vector<float16> data(kBufferSize, 0);
+    for (int i = 0; i < size; i++)
+        data[i] = fp16(scale * (rand() / (float)RAND_MAX - 0.5));
+    return data;
+}
+
+std::vector<float16> runKernel(const CpuKernels& kernels,
+                               const KernelRun& run) {
+    std::vector<float16> results(kBufferSize, 0);
+    float* local0 = (float*)malloc_aligned(kBufferSize * sizeof(float));
+    float* local1 = (float*)malloc_aligned(kBufferSize * sizeof(float));
+    run(kernels, results.data(), local0, local1);
+    free(local0);
+    free(local1);
+    return results;
+}
+
+// Runs a kernel built for each instruction set the host supports, and
+// compares the results with the ones of the baseline build.
+void doIsaTest(int resultsSize, const KernelRun& run) {
+    std::vector<float16> expected = runKernel(getCpuKernels(Sse), run);
+    for (CpuIsa isa : { Avx2, Avx512 }) {
+        if (isa > getHostCpuIsa())
+            break;
+        INFO("Instruction set: " << getCpuIsaName(isa));
+        const CpuKernels& kernels = getCpuKernels(isa);
+        REQUIRE(kernels.isa == isa);
+        std::vector<float16> results = runKernel(kernels, run);
+        for (int i = 0; i < resultsSize; i++) {
+            REQUIRE(Approx(fp32(results[i])).margin(1e-3).epsilon(kEpsilon) ==
+                    fp32(expected[i]));
+        }
+    }
+}
+
+TEST_CASE_METHOD(SmaugTest, "Cpu kernel registry", "[cpukernels]") {
+    CpuIsa savedIsa = getCpuIsa();
+    SECTION("Instruction set selection") {
+        REQUIRE(getCpuIsa() <= getHostCpuIsa());
+        REQUIRE(setCpuIsa(Sse));
+        REQUIRE(getCpuKernels().isa == Sse);
+        REQUIRE(setCpuIsa(getHostCpuIsa()));
+        REQUIRE(getCpuKernels().isa == getHostCpuIsa());
+        if (getHostCpuIsa() != Avx512) {
+            REQUIRE_FALSE(setCpuIsa(Avx512));
+            REQUIRE(getCpuIsa() == getHostCpuIsa());
+        }
+    }
+    SECTION("Instruction set names") {
+        CpuIsa isa;
+        for (CpuIsa expected : { Sse, Avx2, Avx512 }) {
+            REQUIRE(parseCpuIsa(getCpuIsaName(expected), &isa));
+            REQUIRE(isa == expected);
+        }
+        REQUIRE_FALSE(parseCpuIsa("neon", &isa));
+    }
+    setCpuIsa(savedIsa);
+}
+
+TEST_CASE_METHOD(SmaugTest,
+                 "Cpu kernels match the baseline build",
+                 "[cpukernels]") {
+    SamplingInfo sampling = { NoSampling, 1 };
+    activation_param_t actParams = ActivationInfo(activation_type::ELU).params;
+    SECTION("Matrix multiply") {
+        std::vector<float16> a = randomFp16Data(4 * 64);
+        std::vector<float16> b = randomFp16Data(24 * 64);
+        doIsaTest(4 * 24, [&](const CpuKernels& kernels, float16* results,
+                              float* local0, float* local1) {
+            int aDims[2] = { 4, 64 };
+            int bDims[2] = { 24, 64 };
+            int resultsDims[2] = { 4, 24 };
+            float* localResults =
+                    (float*)malloc_aligned(kBufferSize * sizeof(float));
+            kernels.matrixMultiply(a.data(), b.data(), results, local0,
+                                   local1, localResults, aDims, bDims,
+                                   resultsDims, 0, 0, 0, 0, 0, false, true,
+                                   true, activation_type::RELU, actParams, &sampling);
+            free(localResults);
+        });
+    }
+    SECTION("Max and average pooling") {
+        std::vector<float16> inputs = randomFp16Data(8 * 8 * 16);
+        int inputsDims[4] = { 1, 8, 8, 16 };
+        int resultsDims[4] = { 1, 4, 4, 16 };
+        doIsaTest(4 * 4 * 16, [&](const CpuKernels& kernels, float16* results,
+                                  float* local0, float* local1) {
+            kernels.maxPooling(inputs.data(), results, local0, local1,
+                               inputsDims, resultsDims, 0, 0, 2, 2, 2, 2, 0,
+                               &sampling);
+        });
+        doIsaTest(4 * 4 * 16, [&](const CpuKernels& kernels, float16* results,
+                                  float* local0, float* local1) {
+            kernels.avgPooling(inputs.data(), results, local0, local1,
+                               inputsDims, resultsDims, 0, 0, 2, 2, 2, 2, 0,
+                               &sampling);
+        });
+        doIsaTest(16, [&](const CpuKernels& kernels, float16* results,
+                          float* local0, float* local1) {
+            // The kernel sums the pixels up, in blocks of 8.
+            memset(local1, 0, 16 * sizeof(float));
+            kernels.globalAvgPooling(
+                    inputs.data(), local0, local1, inputsDims, 0, 0, 64, 8);
+            for (int i = 0; i < 16; i++)
+                results[i] = fp16(local1[i] / 64);
+        });
+    }
+    SECTION("Batch norm") {
+        std::vector<float16> inputs = randomFp16Data(2 * 64);
+        // Mean, reciprocal square root of the variance, gamma and beta.
+        std::vector<float16> weights = randomFp16Data(4 * 64);
+        doIsaTest(2 * 64, [&](const CpuKernels& kernels, float16* results,
+                              float* local0, float* local1) {
+            int inputsDims[2] = { 2, 64 };
+            float* localResults =
+                    (float*)malloc_aligned(kBufferSize * sizeof(float));
+            kernels.batchNormPostFc(inputs.data(), weights.data(), results,
+                                    local0, local1, localResults, inputsDims,
+                                    64, 0, 0, true, activation_type::ELU, actParams);
+            free(localResults);
+        });
+        // Scales and shifts, in single precision.
+        std::vector<float> scaleShift(2 * 64);
+        for (int i = 0; i < 2 * 64; i++)
+            scaleShift[i] = fp32(weights[i]);
+        doIsaTest(2 * 64, [&](const CpuKernels& kernels, float16* results,
+                              float* local0, float* local1) {
+            int inputsDims[2] = { 2, 64 };
+            float* localResults =
+                    (float*)malloc_aligned(kBufferSize * sizeof(float));
+            kernels.batchNormScaleShiftPostFc(
+                    inputs.data(), scaleShift.data(), results, local0, local1,
+                    localResults, inputsDims, 64, 0, 0, true,
+                    activation_type::ELU, actParams);
+            free(localResults);
+        });
+    }
+    SECTION("Activation functions") {
+        std::vector<float16> inputs = randomFp16Data(256, 8);
+        for (activation_type function :
+             { activation_type::RELU, activation_type::ELU,
+               activation_type::SIGMOID, activation_type::TANH }) {
+            INFO("Activation function: " << function);
+            doIsaTest(256, [&](const CpuKernels& kernels, float16* results,
+                               float* local0, float* local1) {
+                kernels.activation(inputs.data(), results, local0, local1, 256,
+                                   function, actParams);
+            });
+        }
+    }
+    SECTION("Softmax") {
+        std::vector<float16> inputs = randomFp16Data(4 * 32, 8);
+        doIsaTest(4 * 32, [&](const CpuKernels& kernels, float16* results,
+                              float* local0, float* local1) {
+            kernels.softmax(inputs.data(), results, local0, local1, 4, 32, 0);
+        });
+    }
+}
@@ -0,0 +1,133 @@
+/**
+ * \file cpu_kernels_variant.h
+ * \brief Builds the kernels of the Cpu backend for one instruction set.
+ *
+ * A variant is a source file that defines, before including this file:
+ *  - SMV_CPU_ISA, the namespace of the variant, which also suffixes the names
+ *    of its C kernels,
+ *  - SMV_CPU_ISA_ENUM, its CpuIsa,
+ *  - SMV_CPU_ISA_TARGET, the GCC target options it is built with,
+ *  - any tuning parameters of the kernels, e.g. CONV_BLOCK_PIXELS or
+ *    GEMM_NR_VECS.
+ *
+ * Only the kernel sources are built for the instruction set. Every header
+ * with C++ inline functions is included before the target pragma, so that
+ * the linker can never pick a copy of them built for the variant for the
+ * rest of the binary.
+ */
+
+#ifndef SMV_CPU_ISA
+#error "SMV_CPU_ISA must be defined before including cpu_kernels_variant.h!"
+#endif
+
+#define SMV_CPU_ISA_VARIANT
+// Every variant has F16C, which is not detected under a target pragma.
+#define SMAUG_F16C
+
+#include <cmath>
+#include <cstring>
+
+#include "smaug/operators/common.h"
+#include "smaug/operators/smv/kernels/cpu_kernels.h"
+#include "smaug/utility/utils.h"
+
+#define SMV_CPU_ISA_CONCAT_(name, isa) name##_##isa
+#define SMV_CPU_ISA_CONCAT(name, isa) SMV_CPU_ISA_CONCAT_(name, isa)
+#define SMV_CPU_ISA_SYMBOL(name) SMV_CPU_ISA_CONCAT(name, SMV_CPU_ISA)
+
+// The C kernels of the variant are renamed so that they do not clash with
+// the baseline ones.
+#define host_load_fp16 SMV_CPU_ISA_SYMBOL(host_load_fp16)
+#define host_store_fp16 SMV_CPU_ISA_SYMBOL(host_store_fp16)
+#define smv_activation_fun_nc_vec_fxp                                          \
+    SMV_CPU_ISA_SYMBOL(smv_activation_fun_nc_vec_fxp)
+#define smv_softmax_nc_vec_fxp SMV_CPU_ISA_SYMBOL(smv_softmax_nc_vec_fxp)
+#define smv_softmax_stats_nc_vec_fxp                                           \
+    SMV_CPU_ISA_SYMBOL(smv_softmax_stats_nc_vec_fxp)
+#define smv_softmax_normalize_nc_vec_fxp                                       \
+    SMV_CPU_ISA_SYMBOL(smv_softmax_normalize_nc_vec_fxp)
+#define smv_conv3d_nhwc_vec_fxp SMV_CPU_ISA_SYMBOL(smv_conv3d_nhwc_vec_fxp)
+#define smv_depthwise_conv_nhwc_vec_fxp                                        \
+    SMV_CPU_ISA_SYMBOL(smv_depthwise_conv_nhwc_vec_fxp)
+#define smv_winograd_filter_transform_f4x4_3x3                                 \
+    SMV_CPU_ISA_SYMBOL(smv_winograd_filter_transform_f4x4_3x3)
+#define smv_winograd_input_transform_f4x4_3x3                                  \
+    SMV_CPU_ISA_SYMBOL(smv_winograd_input_transform_f4x4_3x3)
+#define smv_winograd_batched_gemm SMV_CPU_ISA_SYMBOL(smv_winograd_batched_gemm)
+#define smv_winograd_output_transform_f4x4_3x3                                 \
+    SMV_CPU_ISA_SYMBOL(smv_winograd_output_transform_f4x4_3x3)
+#define smv_matrix_multiply_transpose_nc_vec_fxp                               \
+    SMV_CPU_ISA_SYMBOL(smv_matrix_multiply_transpose_nc_vec_fxp)
+#define smv_packed_gemm_transpose_nc_vec_fxp                                   \
+    SMV_CPU_ISA_SYMBOL(smv_packed_gemm_transpose_nc_vec_fxp)
+#define smv_maxpooling_nhwc_vec_fxp                                            \
+    SMV_CPU_ISA_SYMBOL(smv_maxpooling_nhwc_vec_fxp)
+#define smv_avgpooling_nhwc_vec_fxp                                            \
+    SMV_CPU_ISA_SYMBOL(smv_avgpooling_nhwc_vec_fxp)
+#define smv_global_avgpooling_nhwc_vec_fxp                                     \
+    SMV_CPU_ISA_SYMBOL(smv_global_avgpooling_nhwc_vec_fxp)
+#define batch_norm_simd_op SMV_CPU_ISA_SYMBOL(batch_norm_simd_op)
+#define smv_batch_norm_post_fc_nc_vec_fxp                                      \
+    SMV_CPU_ISA_SYMBOL(smv_batch_norm_post_fc_nc_vec_fxp)
+#define smv_batch_norm_post_conv_nchw_vec_fxp                                  \
+    SMV_CPU_ISA_SYMBOL(smv_batch_norm_post_conv_nchw_vec_fxp)
+#define smv_batch_norm_post_conv_nhwc_vec_fxp                                  \
+    SMV_CPU_ISA_SYMBOL(smv_batch_norm_post_conv_nhwc_vec_fxp)
+#define batch_norm_scale_shift_simd_op                                         \
+    SMV_CPU_ISA_SYMBOL(batch_norm_scale_shift_simd_op)
+#define smv_batch_norm_scale_shift_post_fc_nc_vec_fxp                          \
+    SMV_CPU_ISA_SYMBOL(smv_batch_norm_scale_shift_post_fc_nc_vec_fxp)
+#define smv_batch_norm_scale_shift_post_conv_nhwc_vec_fxp                      \
+    SMV_CPU_ISA_SYMBOL(smv_batch_norm_scale_shift_post_conv_nhwc_vec_fxp)
+
+#define SMV_CPU_ISA_PRAGMA(x) _Pragma(#x)
+#define SMV_CPU_ISA_TARGET_PRAGMA(isa) SMV_CPU_ISA_PRAGMA(GCC target(isa))
+
+#pragma GCC push_options
+SMV_CPU_ISA_TARGET_PRAGMA(SMV_CPU_ISA_TARGET)
+
+#include "smaug/operators/smv/kernels/load_store_fp16_data.c"
+#include "smaug/operators/smv/kernels/activation_functions_simd.c"
+#include "smaug/operators/smv/kernels/convolution_simd.c"
+#include "smaug/operators/smv/kernels/depthwise_convolution_simd.c"
+#include "smaug/operators/smv/kernels/winograd_simd.c"
+#include "smaug/operators/smv/kernels/matrix_multiply.c"
+#include "smaug/operators/smv/kernels/gemm_simd.c"
+#include "smaug/operators/smv/kernels/pooling.c"
+#include "smaug/operators/smv/kernels/batch_norm.c"
+#include "smaug/operators/smv/kernels/convolution_specialized.cpp"
+
+namespace smaug {
+namespace smv {
+namespace SMV_CPU_ISA {
+
+const CpuKernels kCpuKernels = {
+    SMV_CPU_ISA_ENUM,
+    conv::SMV_CPU_ISA::selectConv3dKernel,
+    smv_conv3d_nhwc_vec_fxp,
+    smv_depthwise_conv_nhwc_vec_fxp,
+    smv_winograd_filter_transform_f4x4_3x3,
+    smv_winograd_input_transform_f4x4_3x3,
+    smv_winograd_batched_gemm,
+    smv_winograd_output_transform_f4x4_3x3,
+    smv_matrix_multiply_transpose_nc_vec_fxp,
+    smv_packed_gemm_transpose_nc_vec_fxp,
+    smv_maxpooling_nhwc_vec_fxp,
+    smv_avgpooling_nhwc_vec_fxp,
+    smv_global_avgpooling_nhwc_vec_fxp,
+    smv_batch_norm_post_fc_nc_vec_fxp,
+    smv_batch_norm_post_conv_nchw_vec_fxp,
+    smv_batch_norm_post_conv_nhwc_vec_fxp,
+    smv_batch_norm_scale_shift_post_fc_nc_vec_fxp,
+    smv_batch_norm_scale_shift_post_conv_nhwc_vec_fxp,
+    smv_activation_fun_nc_vec_fxp,
+    smv_softmax_nc_vec_fxp,
+    smv_softmax_stats_nc_vec_fxp,
+    smv_softmax_normalize_nc_vec_fxp,
+};
+
+}  // namespace SMV_CPU_ISA
+}  // namespace smv
+}  // namespace smaug
+
+#pragma GCC pop_options
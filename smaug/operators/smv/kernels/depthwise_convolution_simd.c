@@ -0,0 +1,161 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "smaug/operators/common.h"
+#include "smaug/operators/smv/kernels/params.h"
+#include "smaug/operators/smv/kernels/load_store_fp16_data.h"
+#include "smaug/operators/smv/kernels/activation_functions_simd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \ingroup AladdinKernels
+ *
+ * Perform a depthwise convolution on an image in NHWC format. This is the
+ * vectorized implementation.
+ *
+ * Every channel of the inputs is convolved with its own 2D filter, so there
+ * is no reduction across channels: each group of VECTOR_SIZE channels is
+ * accumulated independently in one vector register. The inputs, weights and
+ * results tiles must all cover the same channels.
+ *
+ * @param host_inputs Host inputs buffer in NHWC.
+ * @param host_weights Host weights buffer in NHWC (1 x rows x cols x chans).
+ * @param host_results Host results buffer in NHWC.
+ * @param inputs Local inputs buffer in NHWC.
+ * @param weights Local weights buffer in NHWC.
+ * @param results Local results buffer in NHWC.
+ * @param inputs_dims Dimensions of the inputs.
+ * @param weights_dims Dimensions of the weights.
+ * @param results_dims Dimensions of the results.
+ * @param inputs_align_pad Alignment padding size on the channel dimension of
+ *        the inputs.
+ * @param weights_pad Alignment padding size on the channel dimension of the
+ *        weights.
+ * @param results_pad Alignment padding size on the channel dimension of the
+ *        results.
+ * @param inputs_halo_pad Padding sizes on top, bottom, left and right of the
+ * input 2D feature maps.
+ * @param row_stride Stride size on the row dimension.
+ * @param col_stride Stride size on the col dimension.
+ * @param read_weights Load weights from the host. Set to false if the weights
+ *        can be reused from the last invocation.
+ * @param act_function Activation function the operator runs.
+ * @param act_params Parameters for the activation function.
+ * @param sampling Simulation samplng settings.
+ */
+void smv_depthwise_conv_nhwc_vec_fxp(float16* host_inputs,
+                                     float16* host_weights,
+                                     float16* host_results,
+                                     float* inputs,
+                                     float* weights,
+                                     float* results,
+                                     int inputs_dims[4],
+                                     int weights_dims[4],
+                                     int results_dims[4],
+                                     int inputs_align_pad,
+                                     int weights_pad,
+                                     int results_pad,
+                                     int inputs_halo_pad[4],
+                                     int row_stride,
+                                     int col_stride,
+                                     bool read_weights,
+                                     activation_type act_function,
+                                     activation_param_t act_params,
+                                     SamplingInfo* sampling) {
+    int a_batch = inputs_dims[0];
+    int a_rows = inputs_dims[1];
+    int a_cols = inputs_dims[2];
+    int a_height = inputs_dims[3];
+    int a_pad = inputs_align_pad;
+    int inputs_size = a_batch * a_rows * a_cols * (a_height + a_pad);
+
+    int k_rows = weights_dims[1];
+    int k_cols = weights_dims[2];
+    int k_height = weights_dims[3];
+    int k_pad = weights_pad;
+    int weights_size = k_rows * k_cols * (k_height + k_pad);
+
+    int result_rows = results_dims[1];
+    int result_cols = results_dims[2];
+    int result_height = results_dims[3];
+    int results_size = a_batch * result_rows * result_cols *
+                       (result_height + results_pad);
+
+    int top_pad = inputs_halo_pad[0];
+    int left_pad = inputs_halo_pad[2];
+    int chan_groups = FRAC_CEIL(a_height, VECTOR_SIZE);
+    const v8fp_t zero = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    VEC_ARRAY_4D(v8fp_t, _a, inputs, a_rows, a_cols, a_height + a_pad);
+    VEC_ARRAY_3D(v8fp_t, _kernels, weights, k_cols, k_height + k_pad);
+    VEC_ARRAY_4D(v8fp_t,
+                 _results,
+                 results,
+                 result_rows,
+                 result_cols,
+                 result_height + results_pad);
+
+    host_load_fp16(inputs, host_inputs, inputs_size, 0, 0);
+    if (read_weights)
+        host_load_fp16(weights, host_weights, weights_size, 0, 0);
+
+    // Set up the sample sizes and factors.
+    int output_row_sample = result_rows;
+    int output_col_sample = result_cols;
+    int chan_grp_sample = chan_groups;
+    int sample_num = sampling->num_sample_iterations;
+    if (sampling->level >= High)
+        chan_grp_sample = min2(chan_grp_sample, sample_num);
+    if (sampling->level >= VeryHigh) {
+        output_row_sample = min2(output_row_sample, sample_num);
+        // Pipelined loops need at minimum 2 sampled iterations.
+        output_col_sample = min2(output_col_sample, max2(2, sample_num));
+    }
+    setSamplingFactor("dw_conv_row", result_rows * 1.0 / output_row_sample);
+    setSamplingFactor("dw_conv_col", result_cols * 1.0 / output_col_sample);
+    setSamplingFactor("dw_conv_chan_grp", chan_groups * 1.0 / chan_grp_sample);
+
+    dw_conv_batch:
+    for (int n = 0; n < a_batch; n++) {
+        dw_conv_row:
+        for (int out_row = 0; out_row < output_row_sample; out_row++) {
+            dw_conv_col:
+            for (int out_col = 0; out_col < output_col_sample; out_col++) {
+                dw_conv_chan_grp:
+                for (int chan_grp = 0; chan_grp < chan_grp_sample;
+                     chan_grp++) {
+                    v8fp_t accum_reg = zero;
+                    dw_conv_k_row:
+                    for (int kern_row = 0; kern_row < k_rows; kern_row++) {
+                        int in_row = out_row * row_stride - top_pad + kern_row;
+                        bool in_padding_row = in_row < 0 || in_row >= a_rows;
+                        dw_conv_k_col:
+                        for (int kern_col = 0; kern_col < k_cols; kern_col++) {
+                            int in_col =
+                                    out_col * col_stride - left_pad + kern_col;
+                            bool in_padding_col =
+                                    in_col < 0 || in_col >= a_cols;
+                            v8fp_t act_reg =
+                                    (in_padding_row || in_padding_col)
+                                            ? zero
+                                            : _a[n][in_row][in_col][chan_grp];
+                            accum_reg +=
+                                    act_reg *
+                                    _kernels[kern_row][kern_col][chan_grp];
+                        }
+                    }
+                    _results[n][out_row][out_col][chan_grp] = accum_reg;
+                }
+            }
+        }
+    }
+
+    activation_fun_vec(results, results, results_size, act_function, act_params);
+    host_store_fp16(results, host_results, results_size, 0, 0);
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
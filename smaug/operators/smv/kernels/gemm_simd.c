@@ -0,0 +1,273 @@
+#include <stdbool.h>
+#include <string.h>
+
+#include "smaug/operators/common.h"
+#include "smaug/operators/smv/kernels/params.h"
+#include "smaug/operators/smv/kernels/activation_functions_simd.h"
+#include "smaug/utility/fp16_utils.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Packed, cache-blocked GEMM for the Cpu backend: results = A x B^T, where A
+// holds a row per output pixel (or batch) and B a row per output channel
+// (or neuron), both in NC layout with the same padded number of columns.
+//
+// The loop nest follows the usual three levels of cache blocking. A block of
+// col_block rows of B and chan_block columns is unpacked from fp16 into fp32
+// panels of GEMM_NR rows, which stay in the L3 cache while every block of
+// row_block rows of A is unpacked into panels of GEMM_MR rows, which stay in
+// the L2 cache. The micro-kernel then multiplies one panel of A with one
+// panel of B, accumulating a GEMM_MR x GEMM_NR block of results in registers
+// while both panels are streamed with unit stride from the L1 cache.
+
+/** The number of rows of A in a panel, i.e. of a micro-kernel block. */
+#define GEMM_MR 4
+
+/**
+ * The number of vectors in a row of a micro-kernel block. The variants built
+ * for wider vector units set this (see cpu_kernels_variant.h).
+ */
+#ifndef GEMM_NR_VECS
+#define GEMM_NR_VECS 1
+#endif
+
+/** The number of rows of B in a panel, i.e. of a micro-kernel block. */
+#define GEMM_NR (GEMM_NR_VECS * VECTOR_SIZE)
+
+/**
+ * A row of a micro-kernel block. Only the alignment of a v8fp_t is assumed,
+ * as the buffers are not aligned to wider vectors.
+ */
+typedef float gemm_vec_t
+        __attribute__((__vector_size__(GEMM_NR * sizeof(float)),
+                       __aligned__(VECTOR_SIZE * sizeof(float))));
+
+/**
+ * Unpacks rows [row_start, row_start + rows) and columns [col_start,
+ * col_start + cols) of an fp16 matrix into fp32 panels of panel_rows rows,
+ * [FRAC_CEIL(rows, panel_rows)][cols][panel_rows]. Rows past the end, and
+ * the alignment padding past the first valid_cols columns, are filled with
+ * zeros. cols must be a multiple of VECTOR_SIZE.
+ */
+static inline void gemm_pack_panels(float16* host,
+                                    float* packed,
+                                    int width,
+                                    int valid_cols,
+                                    int row_start,
+                                    int rows,
+                                    int col_start,
+                                    int cols,
+                                    int panel_rows) {
+    int num_panels = FRAC_CEIL(rows, panel_rows);
+    ARRAY_2D(float16, _host, host, width);
+
+    gemm_pack_panel:
+    for (int p = 0; p < num_panels; p++) {
+        float* panel = packed + p * cols * panel_rows;
+        gemm_pack_row:
+        for (int i = 0; i < panel_rows; i++) {
+            int row = p * panel_rows + i;
+            if (row >= rows) {
+                for (int c = 0; c < cols; c++)
+                    panel[c * panel_rows + i] = 0;
+                continue;
+            }
+            gemm_pack_col:
+            for (int c = 0; c < cols; c += VECTOR_SIZE) {
+                v8ph_t fp16_data =
+                        *(v8ph_t*)&_host[row_start + row][col_start + c];
+                v8fp_t fp32_data = _CVT_PH_PS_256(fp16_data);
+                for (int j = 0; j < VECTOR_SIZE; j++) {
+                    panel[(c + j) * panel_rows + i] =
+                            col_start + c + j < valid_cols ? fp32_data[j] : 0;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Accumulates the product of a panel of A and a panel of B into a
+ * GEMM_MR x GEMM_NR block of results.
+ *
+ * @param chans The number of columns in the panels.
+ * @param packed_a A panel of A, [chans][GEMM_MR].
+ * @param packed_b A panel of B, [chans][GEMM_NR].
+ * @param results The first element of the block of results.
+ * @param results_width The row pitch of the results.
+ */
+static inline void gemm_micro_kernel(int chans,
+                                     float* packed_a,
+                                     float* packed_b,
+                                     float* results,
+                                     int results_width) {
+    ARRAY_2D(float, _a, packed_a, GEMM_MR);
+    gemm_vec_t* _b = (gemm_vec_t*)packed_b;
+    ARRAY_2D(float, _results, results, results_width);
+    gemm_vec_t acc0 = *(gemm_vec_t*)&_results[0][0];
+    gemm_vec_t acc1 = *(gemm_vec_t*)&_results[1][0];
+    gemm_vec_t acc2 = *(gemm_vec_t*)&_results[2][0];
+    gemm_vec_t acc3 = *(gemm_vec_t*)&_results[3][0];
+
+    gemm_micro_chan:
+    for (int c = 0; c < chans; c++) {
+        gemm_vec_t b = _b[c];
+        acc0 += _a[c][0] * b;
+        acc1 += _a[c][1] * b;
+        acc2 += _a[c][2] * b;
+        acc3 += _a[c][3] * b;
+    }
+    *(gemm_vec_t*)&_results[0][0] = acc0;
+    *(gemm_vec_t*)&_results[1][0] = acc1;
+    *(gemm_vec_t*)&_results[2][0] = acc2;
+    *(gemm_vec_t*)&_results[3][0] = acc3;
+}
+
+/**
+ * Accumulates the product of one row of a panel of A and a panel of B into a
+ * row of GEMM_NR results. This handles the last panel of A when it has fewer
+ * than GEMM_MR valid rows, which is common for small batches.
+ *
+ * @param chans The number of columns in the panels.
+ * @param packed_a A panel of A, [chans][GEMM_MR].
+ * @param row The row of the panel of A.
+ * @param packed_b A panel of B, [chans][GEMM_NR].
+ * @param results The first element of the row of results.
+ */
+static inline void gemm_micro_kernel_row(int chans,
+                                         float* packed_a,
+                                         int row,
+                                         float* packed_b,
+                                         float* results) {
+    ARRAY_2D(float, _a, packed_a, GEMM_MR);
+    gemm_vec_t* _b = (gemm_vec_t*)packed_b;
+    gemm_vec_t acc = *(gemm_vec_t*)results;
+
+    gemm_micro_row_chan:
+    for (int c = 0; c < chans; c++)
+        acc += _a[c][row] * _b[c];
+    *(gemm_vec_t*)results = acc;
+}
+
+/**
+ * Computes a block of results = A x B^T, applies the activation function and
+ * stores the block to the host.
+ *
+ * The block covers rows [row_start, row_start + num_rows) of A and rows
+ * [col_start, col_start + num_cols) of B. col_start and col_block must be
+ * multiples of kGemmNR (a multiple of GEMM_NR for every instruction set),
+ * row_block a multiple of GEMM_MR and chan_block a multiple of VECTOR_SIZE.
+ *
+ * @param host_a Host A matrix buffer in NC.
+ * @param host_b Host B matrix buffer in NC.
+ * @param host_results Host results buffer in NC.
+ * @param packed_a Local buffer for the panels of a block of A, at least
+ *        row_block x chan_block.
+ * @param packed_b Local buffer for the panels of a block of B, at least
+ *        FRAC_CEIL(col_block, GEMM_NR) * GEMM_NR x chan_block.
+ * @param results Local buffer for the fp32 results, at least
+ *        FRAC_CEIL(num_rows, GEMM_MR) * GEMM_MR x
+ *        FRAC_CEIL(col_block, GEMM_NR) * GEMM_NR.
+ * @param a_dims Dimensions of A.
+ * @param b_dims Dimensions of B.
+ * @param a_pad Alignment padding size on the column dimension of A.
+ * @param b_pad Alignment padding size on the column dimension of B.
+ * @param results_pad Alignment padding size on the column dimension of the
+ *        results.
+ * @param row_start The first row of A in the block.
+ * @param num_rows The number of rows of A in the block.
+ * @param col_start The first row of B in the block.
+ * @param num_cols The number of rows of B in the block.
+ * @param row_block The number of rows of A unpacked at a time.
+ * @param col_block The number of rows of B unpacked at a time.
+ * @param chan_block The number of columns of A and B unpacked at a time.
+ * @param act_function Activation function the results are passed through.
+ * @param act_params Parameters for the activation function.
+ */
+void smv_packed_gemm_transpose_nc_vec_fxp(float16* host_a,
+                                          float16* host_b,
+                                          float16* host_results,
+                                          float* packed_a,
+                                          float* packed_b,
+                                          float* results,
+                                          int a_dims[2],
+                                          int b_dims[2],
+                                          int a_pad,
+                                          int b_pad,
+                                          int results_pad,
+                                          int row_start,
+                                          int num_rows,
+                                          int col_start,
+                                          int num_cols,
+                                          int row_block,
+                                          int col_block,
+                                          int chan_block,
+                                          activation_type act_function,
+                                          activation_param_t act_params) {
+    int width = a_dims[1] + a_pad;
+    ASSERT(width == b_dims[1] + b_pad &&
+           "A and B must have the same padded number of columns!");
+    int results_width = b_dims[0] + results_pad;
+    int block_width = FRAC_CEIL(col_block, GEMM_NR) * GEMM_NR;
+    int block_height = FRAC_CEIL(num_rows, GEMM_MR) * GEMM_MR;
+    ARRAY_2D(float, _results, results, block_width);
+    ARRAY_2D(float16, _host_results, host_results, results_width);
+
+    gemm_col_block:
+    for (int jc = col_start; jc < col_start + num_cols; jc += col_block) {
+        int cols = min2(col_block, col_start + num_cols - jc);
+        int col_panels = FRAC_CEIL(cols, GEMM_NR);
+        memset(results, 0, block_height * block_width * sizeof(float));
+        gemm_chan_block:
+        for (int pc = 0; pc < width; pc += chan_block) {
+            int chans = min2(chan_block, width - pc);
+            gemm_pack_panels(host_b, packed_b, width, b_dims[1], jc, cols,
+                             pc, chans, GEMM_NR);
+            gemm_row_block:
+            for (int ic = 0; ic < num_rows; ic += row_block) {
+                int rows = min2(row_block, num_rows - ic);
+                int row_panels = FRAC_CEIL(rows, GEMM_MR);
+                gemm_pack_panels(host_a, packed_a, width, a_dims[1],
+                                 row_start + ic, rows, pc, chans, GEMM_MR);
+                gemm_col_panel:
+                for (int jr = 0; jr < col_panels; jr++) {
+                    gemm_row_panel:
+                    for (int ir = 0; ir < row_panels; ir++) {
+                        float* a_panel = &packed_a[ir * chans * GEMM_MR];
+                        float* b_panel = &packed_b[jr * chans * GEMM_NR];
+                        int row = ic + ir * GEMM_MR;
+                        int panel_rows = min2(GEMM_MR, rows - ir * GEMM_MR);
+                        if (panel_rows == GEMM_MR) {
+                            gemm_micro_kernel(chans, a_panel, b_panel,
+                                              &_results[row][jr * GEMM_NR],
+                                              block_width);
+                            continue;
+                        }
+                        for (int i = 0; i < panel_rows; i++) {
+                            gemm_micro_kernel_row(
+                                    chans, a_panel, i, b_panel,
+                                    &_results[row + i][jr * GEMM_NR]);
+                        }
+                    }
+                }
+            }
+        }
+        activation_fun_vec(results, results, block_height * block_width,
+                           act_function, act_params);
+        gemm_store_row:
+        for (int r = 0; r < num_rows; r++) {
+            gemm_store_col:
+            for (int c = 0; c < cols; c += VECTOR_SIZE) {
+                v8fp_t fp32_data = *(v8fp_t*)&_results[r][c];
+                v8ph_t fp16_data = _CVT_PS_PH_256(fp32_data, 0);
+                *(v8ph_t*)&_host_results[row_start + r][jc + c] = fp16_data;
+            }
+        }
+    }
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
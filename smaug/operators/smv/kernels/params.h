@@ -7,8 +7,20 @@
 #error "Existing VECTOR_SIZE is incompatible with SMV!"
 #endif
 
+// The geometry of the SMV accelerator: NUM_PE_INSTS PEs, each of which
+// performs NUM_MACC_INSTS vector MACCs per cycle. The kernels buffer the
+// partial sums of all the PEs in one vector register, so the number of PEs
+// is tied to VECTOR_SIZE; the number of MACCs can be set at build time, e.g.
+// -DNUM_MACC_INSTS=8, for design-space exploration.
+#ifndef NUM_MACC_INSTS
 #define NUM_MACC_INSTS 4
-#define NUM_PE_INSTS 8
+#endif
+
+#ifndef NUM_PE_INSTS
+#define NUM_PE_INSTS VECTOR_SIZE
+#elif NUM_PE_INSTS != VECTOR_SIZE
+#error "NUM_PE_INSTS must be equal to VECTOR_SIZE!"
+#endif
 
 #define DATA_PE_ALIGNMENT (NUM_MACC_INSTS)*(VECTOR_SIZE)
 
@@ -264,6 +264,57 @@ void smv_avgpooling_nhwc_vec_fxp(float16* host_inputs,
         host_store_fp16(results, host_results, results_size, 0, 0);
 }
 
+/** \ingroup AladdinKernels
+ *
+ * The reduction of a global average-pooling operation on SMV with NHWC
+ * format, i.e. when the pooling window covers the whole feature map. This is
+ * the vectorized implementation.
+ *
+ * This adds up the pixels [pixel_start, pixel_start + num_pixels) of a single
+ * input feature map into the local results, which hold one sum per channel
+ * and must be initialized by the caller. The pixels are contiguous in NHWC,
+ * so they are streamed from the host in blocks of block_pixels pixels, and
+ * the feature map is never tiled. The caller scales the sums by the number of
+ * pixels once all of them have been added up.
+ *
+ * @param host_inputs Host inputs buffer of one feature map in NHWC.
+ * @param inputs Local inputs buffer, which holds block_pixels pixels.
+ * @param results Local buffer of the per-channel sums.
+ * @param inputs_dims Dimensions of the inputs.
+ * @param inputs_pad Align padding size on the channel dimension of the
+ *        inputs.
+ * @param pixel_start The first pixel to add up.
+ * @param num_pixels Number of pixels to add up.
+ * @param block_pixels Number of pixels loaded from the host at a time.
+ */
+void smv_global_avgpooling_nhwc_vec_fxp(float16* host_inputs,
+                                        float* inputs,
+                                        float* results,
+                                        int inputs_dims[4],
+                                        int inputs_pad,
+                                        int pixel_start,
+                                        int num_pixels,
+                                        int block_pixels) {
+    int pixel_size = inputs_dims[3] + inputs_pad;
+    int chan_groups = pixel_size / VECTOR_SIZE;
+
+    VEC_ARRAY_2D(v8fp_t, _a, inputs, pixel_size);
+    VEC_ARRAY_1D(v8fp_t, _results, results);
+
+    global_avgpool_block:
+    for (int block = 0; block < num_pixels; block += block_pixels) {
+        int block_size = min2(block_pixels, num_pixels - block);
+        host_load_fp16(inputs, host_inputs, block_size * pixel_size, 0,
+                       (pixel_start + block) * pixel_size);
+        global_avgpool_pixel:
+        for (int pixel = 0; pixel < block_size; pixel++) {
+            global_avgpool_chan_grp:
+            for (int chan_grp = 0; chan_grp < chan_groups; chan_grp++)
+                _results[chan_grp] += _a[pixel][chan_grp];
+        }
+    }
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -0,0 +1,273 @@
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "smaug/operators/common.h"
+#include "smaug/operators/smv/kernels/params.h"
+#include "smaug/operators/smv/kernels/load_store_fp16_data.h"
+#include "smaug/operators/smv/kernels/activation_functions_simd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Int8 kernels for the Cpu backend.
+ *
+ * Unlike the other SMV kernels, these are not meant to be traced by Aladdin:
+ * they run natively on the host, using the widest integer multiply-add that
+ * the gem5-compatible build flags allow (SSE2 pmaddwd on sign-extended
+ * 16-bit lanes, 8 MACCs per instruction).
+ *
+ * Activations arrive as fp16 and are quantized with a per-tensor scale while
+ * they are loaded. Weights arrive already quantized with one scale per output
+ * channel. Products are accumulated in int32 in the local results buffer, so
+ * partial sums over channel-wise tiles are exact. When the results are sent,
+ * the epilogue rescales them to fp32, applies the fused activation function
+ * and stores them to the host as fp16.
+ */
+
+static inline int8_t quantize_int8(float value, float inv_scale) {
+    float q = roundf(value * inv_scale);
+    q = q > 127 ? 127 : (q < -127 ? -127 : q);
+    return (int8_t)q;
+}
+
+static void host_load_quantize_int8(int8_t* local_data,
+                                    float16* remote_data,
+                                    int num_elems,
+                                    float scale) {
+    float inv_scale = 1.0f / scale;
+    for (int i = 0; i < num_elems; i++) {
+        local_data[i] = quantize_int8(
+                fp16_ieee_to_fp32_value(remote_data[i]), inv_scale);
+    }
+}
+
+static inline int32_t dot_int8(const int8_t* a, const int8_t* b, int size) {
+    int32_t sum = 0;
+    int i = 0;
+#ifdef __SSE2__
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        // Sign-extend to 16 bits by placing each byte in the upper half of a
+        // 16-bit lane and shifting it back down arithmetically.
+        __m128i a_lo = _mm_srai_epi16(_mm_unpacklo_epi8(va, va), 8);
+        __m128i a_hi = _mm_srai_epi16(_mm_unpackhi_epi8(va, va), 8);
+        __m128i b_lo = _mm_srai_epi16(_mm_unpacklo_epi8(vb, vb), 8);
+        __m128i b_hi = _mm_srai_epi16(_mm_unpackhi_epi8(vb, vb), 8);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a_lo, b_lo));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a_hi, b_hi));
+    }
+    int32_t lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < size; i++)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+// Rescales the int32 results in place to fp32, zeroing the alignment padding,
+// then applies the activation function and stores the results as fp16.
+static void requantize_and_store(int32_t* results,
+                                 float16* host_results,
+                                 int num_rows,
+                                 int row_size,
+                                 int row_pad,
+                                 float input_scale,
+                                 const float* weight_scales,
+                                 activation_type act_function,
+                                 activation_param_t act_params) {
+    int row_stride = row_size + row_pad;
+    float* fp_results = (float*)results;
+    for (int i = 0; i < num_rows; i++) {
+        for (int j = 0; j < row_stride; j++) {
+            int idx = i * row_stride + j;
+            float value = j < row_size
+                                  ? results[idx] * input_scale *
+                                            weight_scales[j]
+                                  : 0;
+            memcpy(&fp_results[idx], &value, sizeof(float));
+        }
+    }
+    int results_size = num_rows * row_stride;
+    activation_fun_vec(
+            fp_results, fp_results, results_size, act_function, act_params);
+    host_store_fp16(fp_results, host_results, results_size, 0, 0);
+}
+
+/**
+ * Int8 version of smv_conv3d_nhwc_vec_fxp. The arguments that are common
+ * with it have the same meaning.
+ *
+ * @param inputs Local int8 buffer for the quantized input tile.
+ * @param weights Local int8 buffer for the weight tile.
+ * @param results Local int32 buffer for the accumulated results.
+ * @param input_scale The per-tensor scale of the inputs.
+ * @param weight_scales The scales of the output channels of this results
+ *        tile, i.e. offset to its first channel.
+ */
+void smv_conv3d_nhwc_int8(float16* host_inputs,
+                          int8_t* host_weights,
+                          float16* host_results,
+                          int8_t* inputs,
+                          int8_t* weights,
+                          int32_t* results,
+                          int inputs_dims[4],
+                          int weights_dims[4],
+                          int results_dims[4],
+                          int inputs_align_pad,
+                          int weights_pad,
+                          int results_pad,
+                          int inputs_halo_pad[4],
+                          int row_stride,
+                          int col_stride,
+                          int ifmap_start,
+                          int kern_start,
+                          bool accumulate,
+                          bool read_inputs,
+                          bool read_weights,
+                          bool send_results,
+                          float input_scale,
+                          const float* weight_scales,
+                          activation_type act_function,
+                          activation_param_t act_params) {
+    int a_batch = inputs_dims[0];
+    int a_rows = inputs_dims[1];
+    int a_cols = inputs_dims[2];
+    int a_stride = inputs_dims[3] + inputs_align_pad;
+    int k_rows = weights_dims[1];
+    int k_cols = weights_dims[2];
+    int k_chans = weights_dims[3];
+    int k_stride = weights_dims[3] + weights_pad;
+    int result_rows = results_dims[1];
+    int result_cols = results_dims[2];
+    int result_chans = results_dims[3];
+    int result_stride = results_dims[3] + results_pad;
+    int top_pad = inputs_halo_pad[0];
+    int left_pad = inputs_halo_pad[2];
+
+    if (read_inputs) {
+        host_load_quantize_int8(inputs, host_inputs,
+                                a_batch * a_rows * a_cols * a_stride,
+                                input_scale);
+    }
+    if (read_weights) {
+        memcpy(weights, host_weights,
+               weights_dims[0] * k_rows * k_cols * k_stride * sizeof(int8_t));
+    }
+
+    for (int n = 0; n < a_batch; n++) {
+        for (int out_row = 0; out_row < result_rows; out_row++) {
+            for (int out_col = 0; out_col < result_cols; out_col++) {
+                int32_t* result_pixel =
+                        &results[((n * result_rows + out_row) * result_cols +
+                                  out_col) *
+                                 result_stride];
+                for (int k = 0; k < result_chans; k++) {
+                    int32_t sum = 0;
+                    for (int kern_row = 0; kern_row < k_rows; kern_row++) {
+                        int in_row = out_row * row_stride - top_pad + kern_row;
+                        if (in_row < 0 || in_row >= a_rows)
+                            continue;
+                        for (int kern_col = 0; kern_col < k_cols; kern_col++) {
+                            int in_col =
+                                    out_col * col_stride - left_pad + kern_col;
+                            if (in_col < 0 || in_col >= a_cols)
+                                continue;
+                            const int8_t* act =
+                                    &inputs[((n * a_rows + in_row) * a_cols +
+                                             in_col) *
+                                                    a_stride +
+                                            ifmap_start];
+                            const int8_t* kern =
+                                    &weights[(((kern_start + k) * k_rows +
+                                               kern_row) *
+                                                      k_cols +
+                                              kern_col) *
+                                             k_stride];
+                            sum += dot_int8(act, kern, k_chans);
+                        }
+                    }
+                    result_pixel[k] = accumulate ? result_pixel[k] + sum : sum;
+                }
+            }
+        }
+    }
+
+    if (send_results) {
+        requantize_and_store(results, host_results,
+                             a_batch * result_rows * result_cols, result_chans,
+                             results_pad, input_scale, weight_scales,
+                             act_function, act_params);
+    }
+}
+
+/**
+ * Int8 version of smv_matrix_multiply_transpose_nc_vec_fxp. The arguments
+ * that are common with it have the same meaning.
+ *
+ * @param a Local int8 buffer for the quantized inputs.
+ * @param b Local int8 buffer for the weight tile.
+ * @param results Local int32 buffer for the accumulated results.
+ * @param input_scale The per-tensor scale of the inputs.
+ * @param weight_scales The scales of all the neurons of the results.
+ */
+void smv_matrix_multiply_transpose_nc_int8(float16* host_a,
+                                           int8_t* host_b,
+                                           float16* host_results,
+                                           int8_t* a,
+                                           int8_t* b,
+                                           int32_t* results,
+                                           int a_dims[2],
+                                           int b_dims[2],
+                                           int results_dims[2],
+                                           int a_pad,
+                                           int b_pad,
+                                           int results_pad,
+                                           int a_start,
+                                           int result_start,
+                                           bool accumulate,
+                                           bool read_inputs,
+                                           bool send_results,
+                                           float input_scale,
+                                           const float* weight_scales,
+                                           activation_type act_function,
+                                           activation_param_t act_params) {
+    int a_height = a_dims[0];
+    int a_stride = a_dims[1] + a_pad;
+    int b_height = b_dims[0];
+    int b_width = b_dims[1];
+    int b_stride = b_dims[1] + b_pad;
+    int results_stride = results_dims[1] + results_pad;
+
+    if (read_inputs)
+        host_load_quantize_int8(a, host_a, a_height * a_stride, input_scale);
+    memcpy(b, host_b, b_height * b_stride * sizeof(int8_t));
+
+    for (int i = 0; i < a_height; i++) {
+        int32_t* result_row = &results[i * results_stride + result_start];
+        for (int j = 0; j < b_height; j++) {
+            int32_t sum = dot_int8(
+                    &a[i * a_stride + a_start], &b[j * b_stride], b_width);
+            result_row[j] = accumulate ? result_row[j] + sum : sum;
+        }
+    }
+
+    if (send_results) {
+        requantize_and_store(results, host_results, a_height, results_dims[1],
+                             results_pad, input_scale, weight_scales,
+                             act_function, act_params);
+    }
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
@@ -0,0 +1,360 @@
+#include <stdbool.h>
+#include <string.h>
+
+#include "smaug/operators/common.h"
+#include "smaug/operators/smv/kernels/params.h"
+#include "smaug/operators/smv/kernels/activation_functions_simd.h"
+#include "smaug/utility/fp16_utils.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Winograd F(4x4, 3x3): each 6x6 input tile produces a 4x4 output tile. The
+// transforms are Y = A^T [(G g G^T) .* (B^T d B)] A, with the standard
+// matrices derived from the interpolation points (0, 1, -1, 2, -2, inf).
+//
+// These kernels only run on the Cpu backend. They gather and scatter single
+// pixels of the host tensors, so they convert fp16 data one vector at a time
+// instead of going through the page-sized host_load_fp16/host_store_fp16.
+
+/** Computes B^T d for one column of a 6x6 tile. */
+static inline void winograd_bt_col(v8fp_t d[6], v8fp_t out[6]) {
+    out[0] = 4 * d[0] - 5 * d[2] + d[4];
+    out[1] = -4 * d[1] - 4 * d[2] + d[3] + d[4];
+    out[2] = 4 * d[1] - 4 * d[2] - d[3] + d[4];
+    out[3] = -2 * d[1] - d[2] + 2 * d[3] + d[4];
+    out[4] = 2 * d[1] - d[2] - 2 * d[3] + d[4];
+    out[5] = 4 * d[1] - 5 * d[3] + d[5];
+}
+
+/** Computes A^T m for one column of a 6x6 tile. */
+static inline void winograd_at_col(v8fp_t m[6], v8fp_t out[4]) {
+    v8fp_t sum12 = m[1] + m[2];
+    v8fp_t diff12 = m[1] - m[2];
+    v8fp_t sum34 = m[3] + m[4];
+    v8fp_t diff34 = m[3] - m[4];
+    out[0] = m[0] + sum12 + sum34;
+    out[1] = diff12 + 2 * diff34;
+    out[2] = sum12 + 4 * sum34;
+    out[3] = diff12 + 8 * diff34 + m[5];
+}
+
+/**
+ * Transforms 3x3 filters into the 6x6 Winograd domain, U = G g G^T.
+ *
+ * This is done once per layer. The transformed filters are laid out as
+ * [36][chans][kernels], where chans and kernels are the channel and kernel
+ * counts rounded up to the vector size, so that the batched GEMM can
+ * vectorize over the kernels.
+ *
+ * @param host_weights Host weights buffer in NHWC (kernels x 3 x 3 x chans).
+ * @param weights Local buffer for one kernel, at least 9 x padded chans.
+ * @param transformed Transformed filter buffer.
+ * @param weights_dims Dimensions of the weights.
+ * @param weights_pad Alignment padding size on the channel dimension of the
+ *        weights.
+ */
+void smv_winograd_filter_transform_f4x4_3x3(float16* host_weights,
+                                            float* weights,
+                                            float* transformed,
+                                            int weights_dims[4],
+                                            int weights_pad) {
+    int k_num = weights_dims[0];
+    int k_height = weights_dims[3] + weights_pad;
+    int k_padded = FRAC_CEIL(k_num, VECTOR_SIZE) * VECTOR_SIZE;
+    ARRAY_3D(float, _kernel, weights, 3, k_height);
+    ARRAY_3D(float, _transformed, transformed, k_height, k_padded);
+    VEC_ARRAY_1D(v8ph_t, _host_weights, host_weights);
+    VEC_ARRAY_1D(v8fp_t, _weights, weights);
+    memset(transformed, 0, 36 * k_height * k_padded * sizeof(float));
+
+    wino_filter_kernel:
+    for (int k = 0; k < k_num; k++) {
+        int kernel_offset = k * 9 * k_height / VECTOR_SIZE;
+        for (int v = 0; v < 9 * k_height / VECTOR_SIZE; v++) {
+            v8ph_t fp16_data = _host_weights[kernel_offset + v];
+            v8fp_t fp32_data = _CVT_PH_PS_256(fp16_data);
+            _weights[v] = fp32_data;
+        }
+        wino_filter_chan:
+        for (int c = 0; c < weights_dims[3]; c++) {
+            // G g: 6x3.
+            float gg[6][3];
+            for (int j = 0; j < 3; j++) {
+                float g0 = _kernel[0][j][c];
+                float g1 = _kernel[1][j][c];
+                float g2 = _kernel[2][j][c];
+                gg[0][j] = g0 / 4;
+                gg[1][j] = -(g0 + g1 + g2) / 6;
+                gg[2][j] = -(g0 - g1 + g2) / 6;
+                gg[3][j] = g0 / 24 + g1 / 12 + g2 / 6;
+                gg[4][j] = g0 / 24 - g1 / 12 + g2 / 6;
+                gg[5][j] = g2;
+            }
+            // (G g) G^T: 6x6.
+            for (int i = 0; i < 6; i++) {
+                float g0 = gg[i][0];
+                float g1 = gg[i][1];
+                float g2 = gg[i][2];
+                float u[6] = { g0 / 4,
+                               -(g0 + g1 + g2) / 6,
+                               -(g0 - g1 + g2) / 6,
+                               g0 / 24 + g1 / 12 + g2 / 6,
+                               g0 / 24 - g1 / 12 + g2 / 6,
+                               g2 };
+                for (int j = 0; j < 6; j++)
+                    _transformed[i * 6 + j][c][k] = u[j];
+            }
+        }
+    }
+}
+
+/**
+ * Transforms a range of 6x6 input tiles into the Winograd domain,
+ * V = B^T d B.
+ *
+ * The output is tiled in 4x4 blocks; output tile t covers the output rows
+ * [4 * tr, 4 * tr + 4) and columns [4 * tc, 4 * tc + 4) of image n, where t
+ * = (n * tile_rows + tr) * tile_cols + tc. Input pixels that fall in the
+ * zero-padding or past the image boundary are read as zeros. The transformed
+ * tiles are laid out as [36][num_tiles][chans].
+ *
+ * @param host_inputs Host inputs buffer in NHWC.
+ * @param patch Local buffer for one 6x6 input tile, at least 36 x padded
+ *        chans.
+ * @param transformed Transformed inputs buffer.
+ * @param inputs_dims Dimensions of the inputs.
+ * @param inputs_pad Alignment padding size on the channel dimension of the
+ *        inputs.
+ * @param inputs_halo_pad Padding sizes on top, bottom, left and right of the
+ *        input 2D feature maps.
+ * @param tile_start The first output tile to transform.
+ * @param num_tiles Number of output tiles to transform.
+ * @param tile_rows Number of 4x4 output tiles along the rows.
+ * @param tile_cols Number of 4x4 output tiles along the columns.
+ */
+void smv_winograd_input_transform_f4x4_3x3(float16* host_inputs,
+                                           float* patch,
+                                           float* transformed,
+                                           int inputs_dims[4],
+                                           int inputs_pad,
+                                           int inputs_halo_pad[4],
+                                           int tile_start,
+                                           int num_tiles,
+                                           int tile_rows,
+                                           int tile_cols) {
+    int a_rows = inputs_dims[1];
+    int a_cols = inputs_dims[2];
+    int a_height = inputs_dims[3] + inputs_pad;
+    int chan_groups = a_height / VECTOR_SIZE;
+    VEC_ARRAY_4D(v8ph_t, _host_inputs, host_inputs, a_rows, a_cols, a_height);
+    VEC_ARRAY_3D(v8fp_t, _patch, patch, 6, a_height);
+    VEC_ARRAY_3D(v8fp_t, _transformed, transformed, num_tiles, a_height);
+    const v8fp_t zero = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    wino_input_tile:
+    for (int t = 0; t < num_tiles; t++) {
+        int tile = tile_start + t;
+        int n = tile / (tile_rows * tile_cols);
+        int tr = (tile / tile_cols) % tile_rows;
+        int tc = tile % tile_cols;
+        int row_start = tr * 4 - inputs_halo_pad[0];
+        int col_start = tc * 4 - inputs_halo_pad[2];
+        wino_input_load_row:
+        for (int i = 0; i < 6; i++) {
+            int row = row_start + i;
+            wino_input_load_col:
+            for (int j = 0; j < 6; j++) {
+                int col = col_start + j;
+                bool in_padding =
+                        row < 0 || row >= a_rows || col < 0 || col >= a_cols;
+                for (int g = 0; g < chan_groups; g++) {
+                    if (in_padding) {
+                        _patch[i][j][g] = zero;
+                    } else {
+                        v8ph_t fp16_data = _host_inputs[n][row][col][g];
+                        v8fp_t fp32_data = _CVT_PH_PS_256(fp16_data);
+                        _patch[i][j][g] = fp32_data;
+                    }
+                }
+            }
+        }
+        wino_input_chan_grp:
+        for (int g = 0; g < chan_groups; g++) {
+            v8fp_t tmp[6][6];
+            for (int j = 0; j < 6; j++) {
+                v8fp_t col[6], out[6];
+                for (int i = 0; i < 6; i++)
+                    col[i] = _patch[i][j][g];
+                winograd_bt_col(col, out);
+                for (int i = 0; i < 6; i++)
+                    tmp[i][j] = out[i];
+            }
+            for (int i = 0; i < 6; i++) {
+                v8fp_t out[6];
+                winograd_bt_col(tmp[i], out);
+                for (int j = 0; j < 6; j++)
+                    _transformed[i * 6 + j][t][g] = out[j];
+            }
+        }
+    }
+}
+
+/**
+ * The element-wise stage of Winograd convolution, computed as 36 independent
+ * GEMMs: M[xi] = V[xi] x U[xi] for every point xi of the 6x6 transformed
+ * tile.
+ *
+ * Each GEMM is vectorized over the kernels: a transformed input element is
+ * broadcast and multiplied with a row of four vectors of transformed filters,
+ * which are accumulated in registers over all the channels.
+ *
+ * @param transformed_inputs Transformed inputs, [36][num_tiles][chans].
+ * @param transformed_weights Transformed filters, [36][chans][kernels].
+ * @param transformed_results Transformed results, [36][num_tiles][kernels].
+ * @param num_tiles Number of tiles.
+ * @param chans Number of channels, a multiple of the vector size.
+ * @param kernels Number of kernels, a multiple of the vector size.
+ */
+void smv_winograd_batched_gemm(float* transformed_inputs,
+                               float* transformed_weights,
+                               float* transformed_results,
+                               int num_tiles,
+                               int chans,
+                               int kernels) {
+    int kernel_groups = kernels / VECTOR_SIZE;
+    ARRAY_3D(float, _inputs, transformed_inputs, num_tiles, chans);
+    VEC_ARRAY_3D(v8fp_t, _weights, transformed_weights, chans, kernels);
+    VEC_ARRAY_3D(v8fp_t, _results, transformed_results, num_tiles, kernels);
+    const v8fp_t zero = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    wino_gemm_point:
+    for (int xi = 0; xi < 36; xi++) {
+        wino_gemm_tile:
+        for (int t = 0; t < num_tiles; t++) {
+            int kg = 0;
+            wino_gemm_kernel_block:
+            for (; kg + 4 <= kernel_groups; kg += 4) {
+                v8fp_t acc0 = zero, acc1 = zero, acc2 = zero, acc3 = zero;
+                wino_gemm_chan:
+                for (int c = 0; c < chans; c++) {
+                    float v = _inputs[xi][t][c];
+                    v8fp_t vv = { v, v, v, v, v, v, v, v };
+                    acc0 += vv * _weights[xi][c][kg];
+                    acc1 += vv * _weights[xi][c][kg + 1];
+                    acc2 += vv * _weights[xi][c][kg + 2];
+                    acc3 += vv * _weights[xi][c][kg + 3];
+                }
+                _results[xi][t][kg] = acc0;
+                _results[xi][t][kg + 1] = acc1;
+                _results[xi][t][kg + 2] = acc2;
+                _results[xi][t][kg + 3] = acc3;
+            }
+            wino_gemm_kernel_rem:
+            for (; kg < kernel_groups; kg++) {
+                v8fp_t acc = zero;
+                for (int c = 0; c < chans; c++) {
+                    float v = _inputs[xi][t][c];
+                    v8fp_t vv = { v, v, v, v, v, v, v, v };
+                    acc += vv * _weights[xi][c][kg];
+                }
+                _results[xi][t][kg] = acc;
+            }
+        }
+    }
+}
+
+/**
+ * Transforms a range of tiles back from the Winograd domain, Y = A^T M A,
+ * applies the activation function and stores the 4x4 output tiles to the
+ * host. Output pixels past the image boundary are dropped.
+ *
+ * @param transformed_results Transformed results, [36][num_tiles][kernels].
+ * @param patch Local buffer for one 4x4 output tile, at least 16 x padded
+ *        kernels.
+ * @param host_results Host results buffer in NHWC.
+ * @param results_dims Dimensions of the results.
+ * @param results_pad Alignment padding size on the channel dimension of the
+ *        results.
+ * @param tile_start The first output tile to transform.
+ * @param num_tiles Number of output tiles to transform.
+ * @param tile_rows Number of 4x4 output tiles along the rows.
+ * @param tile_cols Number of 4x4 output tiles along the columns.
+ * @param act_function Activation function the operator runs.
+ * @param act_params Parameters for the activation function.
+ */
+void smv_winograd_output_transform_f4x4_3x3(float* transformed_results,
+                                            float* patch,
+                                            float16* host_results,
+                                            int results_dims[4],
+                                            int results_pad,
+                                            int tile_start,
+                                            int num_tiles,
+                                            int tile_rows,
+                                            int tile_cols,
+                                            activation_type act_function,
+                                            activation_param_t act_params) {
+    int result_rows = results_dims[1];
+    int result_cols = results_dims[2];
+    int result_height = results_dims[3] + results_pad;
+    int kernel_groups = result_height / VECTOR_SIZE;
+    VEC_ARRAY_4D(v8ph_t,
+                 _host_results,
+                 host_results,
+                 result_rows,
+                 result_cols,
+                 result_height);
+    VEC_ARRAY_3D(v8fp_t, _patch, patch, 4, result_height);
+    VEC_ARRAY_3D(
+            v8fp_t, _transformed, transformed_results, num_tiles, result_height);
+
+    wino_output_tile:
+    for (int t = 0; t < num_tiles; t++) {
+        int tile = tile_start + t;
+        int n = tile / (tile_rows * tile_cols);
+        int tr = (tile / tile_cols) % tile_rows;
+        int tc = tile % tile_cols;
+        wino_output_kernel_grp:
+        for (int g = 0; g < kernel_groups; g++) {
+            v8fp_t tmp[4][6];
+            for (int j = 0; j < 6; j++) {
+                v8fp_t col[6], out[4];
+                for (int i = 0; i < 6; i++)
+                    col[i] = _transformed[i * 6 + j][t][g];
+                winograd_at_col(col, out);
+                for (int i = 0; i < 4; i++)
+                    tmp[i][j] = out[i];
+            }
+            for (int i = 0; i < 4; i++) {
+                v8fp_t out[4];
+                winograd_at_col(tmp[i], out);
+                for (int j = 0; j < 4; j++)
+                    _patch[i][j][g] = out[j];
+            }
+        }
+        activation_fun_vec(
+                patch, patch, 16 * result_height, act_function, act_params);
+        wino_output_store_row:
+        for (int i = 0; i < 4; i++) {
+            int row = tr * 4 + i;
+            if (row >= result_rows)
+                break;
+            wino_output_store_col:
+            for (int j = 0; j < 4; j++) {
+                int col = tc * 4 + j;
+                if (col >= result_cols)
+                    break;
+                for (int g = 0; g < kernel_groups; g++) {
+                    v8fp_t fp32_data = _patch[i][j][g];
+                    v8ph_t fp16_data = _CVT_PS_PH_256(fp32_data, 0);
+                    _host_results[n][row][col][g] = fp16_data;
+                }
+            }
+        }
+    }
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
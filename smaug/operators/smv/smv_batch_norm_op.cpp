@@ -1,10 +1,18 @@
+#include <algorithm>
+#include <cmath>
+
+#include "fp16.h"
 #include "smaug/core/backend.h"
+#include "smaug/core/globals.h"
 #include "smaug/operators/common.h"
+#include "smaug/operators/smv/kernels/cpu_kernels.h"
 #include "smaug/operators/smv/smv_batch_norm_op.h"
 #include "smaug/operators/smv/smv_batch_norm_tiling.h"
 #include "smaug/operators/smv/smv_kernels.h"
 #include "smaug/operators/smv/smv_accel_pool.h"
+#include "smaug/operators/smv/smv_perf_model.h"
 #include "smaug/utility/debug_stream.h"
+#include "smaug/utility/thread_pool.h"
 
 namespace smaug {
 namespace smv {
@@ -28,15 +36,8 @@ void SmvBatchNormOp::runNA(TiledTensor& inputs,
     auto inputIdx = inputs.startIndex();
     auto weightIdx = weights.startIndex();
     auto outputIdx = outputs.startIndex();
-    
-    float * a;
-    float * b;
-    float * results;
-    if (backEnd == Cpu) {
-        a = (float*)smaug::malloc_aligned(memSize * 2);
-        b = (float*)smaug::malloc_aligned(memSize * 2);
-        results = (float*)smaug::malloc_aligned(memSize * 2);
-    }
+    std::vector<TileJob> cpuJobs;
+    std::vector<int> cpuJobSplits;
     setArrayMemTypeIfSimulating(
             smv::kBatchNormHw, "host_inputs", getInputsMemType());
     setArrayMemTypeIfSimulating(
@@ -63,9 +64,12 @@ void SmvBatchNormOp::runNA(TiledTensor& inputs,
             mapArrayToAccel(smv::kBatchNormHw, "host_inputs",
                             inputTile->data<float16>(),
                             inputShape.storageSize() * sizeof(float16));
-            mapArrayToAccel(smv::kBatchNormHw, "host_weights",
-                            weightsTile->data<float16>(),
-                            weightsShape.storageSize() * sizeof(float16));
+            // The folded scales and shifts are only read by the Cpu kernels.
+            if (!usesScaleShift()) {
+                mapArrayToAccel(smv::kBatchNormHw, "host_weights",
+                                weightsTile->data<float16>(),
+                                weightsShape.storageSize() * sizeof(float16));
+            }
             mapArrayToAccel(smv::kBatchNormHw, "host_results",
                             outputTile->data<float16>(),
                             outputShape.storageSize() * sizeof(float16));
@@ -77,8 +81,16 @@ void SmvBatchNormOp::runNA(TiledTensor& inputs,
             int actStart = (iC == wC) ? 0 : actOffset;
             // Send the results back to host memory when we finish the weights.
             bool sendOutputs = iC == wC || wC == weightActTiles - 1;
+            if (actStart == 0)
+                recordTileTransfer(inputTile);
+            recordTileTransfer(weightsTile);
+            if (sendOutputs)
+                recordTileTransfer(outputTile);
 
-            if (backEnd == Smv){
+            if (isEstimating()) {
+                recordKernelEstimate(
+                        0, smv::model::vectorCycles(inputShape.storageSize()));
+            } else if (backEnd == Smv){
                 invokeKernel(smv::kBatchNormHw, smv_batch_norm_post_fc_nc_vec_fxp,
                             inputTile->data<float16>(),
                             weightsTile->data<float16>(),
@@ -86,17 +98,15 @@ void SmvBatchNormOp::runNA(TiledTensor& inputs,
                             smv::spad2, inputDims, weightsShape[1],
                             inputShape.getPadding(1), actStart, sendOutputs,
                             actInfo.function, actInfo.params);
-            } else if (backEnd == Cpu){
-                smv_batch_norm_post_fc_nc_vec_fxp(
-                            inputTile->data<float16>(),
-                            weightsTile->data<float16>(),
-                            outputTile->data<float16>(), a, b,
-                            results, inputDims, weightsShape[1],
-                            inputShape.getPadding(1), actStart, sendOutputs,
-                            actInfo.function, actInfo.params);
+            } else if (backEnd == Cpu) {
+                // A job that does not load the inputs reuses the ones of the
+                // previous job.
+                if (actStart == 0)
+                    cpuJobSplits.push_back(cpuJobs.size());
+                cpuJobs.push_back({ inputTile, weightsTile, outputTile,
+                                    actStart, sendOutputs });
             }
 
-
             actOffset += weightsTile->getShape()[1];
             if (inputActTiles == weightActTiles) {
                 iC++;
@@ -111,11 +121,8 @@ void SmvBatchNormOp::runNA(TiledTensor& inputs,
         }
     }
 
-    if (backEnd == Cpu){
-        free(a);
-        free(b);
-        free(results);
-    }
+    if (backEnd == Cpu)
+        dispatchCpuJobs(cpuJobs, cpuJobSplits);
 }
 
 // The tile dispatcher for post-convolution batch norms. The tile iteration is
@@ -129,15 +136,8 @@ void SmvBatchNormOp::runNHWC(TiledTensor& inputs,
                              TiledTensor& outputs) {
     // Ordinarily, we don't need to tile the weights.
     assert(weights.size() == 1);
-    float * a;
-    float * b;
-    float * results;
-
-    if (backEnd == Cpu) {
-        a = (float*)smaug::malloc_aligned(memSize * 2);
-        b = (float*)smaug::malloc_aligned(memSize * 2);
-        results = (float*)smaug::malloc_aligned(memSize * 2);
-    }
+    std::vector<TileJob> cpuJobs;
+    std::vector<int> cpuJobSplits;
     int inputNumTiles = inputs.getShape()[0];
     int inputRowTiles = inputs.getShape()[1];
     int inputColTiles = inputs.getShape()[2];
@@ -147,9 +147,11 @@ void SmvBatchNormOp::runNHWC(TiledTensor& inputs,
     Tensor* weightTile = weights.getTileWithData(0);
     const TensorShape& weightShape = weightTile->getShape();
     for (int i = 0; i < numCores; i++) {
-        mapArrayToAccel(smv::kBatchNormHw + i, "host_weights",
-                        weightTile->data<float16>(),
-                        weightShape.storageSize() * sizeof(float16));
+        if (!usesScaleShift()) {
+            mapArrayToAccel(smv::kBatchNormHw + i, "host_weights",
+                            weightTile->data<float16>(),
+                            weightShape.storageSize() * sizeof(float16));
+        }
         setArrayMemTypeIfSimulating(
                 smv::kBatchNormHw + i, "host_inputs", getInputsMemType());
         setArrayMemTypeIfSimulating(
@@ -182,7 +184,18 @@ void SmvBatchNormOp::runNHWC(TiledTensor& inputs,
                             outputShape.storageSize() * sizeof(float16));
                     int inputDims[4] = { inputShape[0], inputShape[1],
                                          inputShape[2], inputShape[3] };
-                    if (backEnd == Smv) {
+                    recordTileTransfer(inputTile);
+                    if (ifmapOffset == 0)
+                        recordTileTransfer(weightTile);
+                    recordTileTransfer(outputTile);
+                    if (isEstimating()) {
+                        recordKernelEstimate(
+                                currAccelIdx,
+                                smv::model::vectorCycles(
+                                        inputShape.storageSize()));
+                        accelPool.addFinishFlag(
+                                currAccelIdx, std::move(nullptr));
+                    } else if (backEnd == Smv) {
                         std::unique_ptr<volatile int> finishFlag =
                             invokeKernelNoBlock(
                                     currAccelIdx,
@@ -199,15 +212,12 @@ void SmvBatchNormOp::runNHWC(TiledTensor& inputs,
                         accelPool.addFinishFlag(
                                 currAccelIdx, std::move(finishFlag));
                     } else if (backEnd == Cpu) {
-                            smv_batch_norm_post_conv_nhwc_vec_fxp(
-                                    inputTile->data<float16>(),
-                                    weightTile->data<float16>(),
-                                    outputTile->data<float16>(), a,
-                                    b, results, inputDims,
-                                    weightShape[1], inputShape.getPadding(3),
-                                    weightShape.getPadding(1), ifmapOffset,
-                                    actInfo.function, actInfo.params,
-                                    &sampling);
+                        // A job that does not load the weights reuses the
+                        // ones of the previous job.
+                        if (ifmapOffset == 0)
+                            cpuJobSplits.push_back(cpuJobs.size());
+                        cpuJobs.push_back({ inputTile, weightTile, outputTile,
+                                            ifmapOffset, true });
                         accelPool.addFinishFlag(
                                 currAccelIdx, std::move(nullptr));
                     } else {
@@ -224,11 +234,124 @@ void SmvBatchNormOp::runNHWC(TiledTensor& inputs,
     }
     accelPool.joinAll();
 
-    if (backEnd == Cpu){
-        free(a);
-        free(b);
-        free(results);
+    if (backEnd == Cpu)
+        dispatchCpuJobs(cpuJobs, cpuJobSplits);
+}
+
+void SmvBatchNormOp::dispatchCpuJobs(const std::vector<TileJob>& jobs,
+                                     const std::vector<int>& splits) {
+    int numThreads = 1;
+    if (!fastForwardMode && threadPool)
+        numThreads = std::min(numCores, threadPool->size());
+    if (numThreads <= 1 || splits.size() <= 1) {
+        runCpuJobs(jobs, 0, jobs.size());
+        return;
+    }
+    int numSplitsPerThread = std::ceil(splits.size() * 1.0 / numThreads);
+    for (int i = 0; i < splits.size(); i += numSplitsPerThread) {
+        int start = splits[i];
+        int end = i + numSplitsPerThread < splits.size()
+                          ? splits[i + numSplitsPerThread]
+                          : jobs.size();
+        auto args = new CpuWorkerArgs{ this, &jobs, start, end - start };
+        int cpuid = threadPool->dispatchThread(cpuWorker, (void*)args);
+        assert(cpuid != -1 && "Failed to dispatch thread!");
+    }
+    threadPool->joinThreadPool();
+}
+
+void SmvBatchNormOp::runCpuJobs(const std::vector<TileJob>& jobs,
+                                int start,
+                                int numJobs) {
+    float* a = (float*)smaug::malloc_aligned(memSize * 2);
+    float* b = (float*)smaug::malloc_aligned(memSize * 2);
+    float* results = (float*)smaug::malloc_aligned(memSize * 2);
+    const smv::CpuKernels& kernels = smv::getCpuKernels();
+    for (int i = start; i < start + numJobs; i++) {
+        const TileJob& job = jobs[i];
+        const TensorShape& inputShape = job.inputs->getShape();
+        const TensorShape& weightShape = job.weights->getShape();
+        if (inputShape.ndims() == 4) {
+            int inputDims[4] = { inputShape[0], inputShape[1], inputShape[2],
+                                 inputShape[3] };
+            if (usesScaleShift()) {
+                kernels.batchNormScaleShiftPostConvNhwc(
+                        job.inputs->data<float16>(), job.weights->data<float>(),
+                        job.outputs->data<float16>(), a, b, results, inputDims,
+                        weightShape[1], inputShape.getPadding(3),
+                        weightShape.getPadding(1), job.start, actInfo.function,
+                        actInfo.params, &sampling);
+            } else {
+                kernels.batchNormPostConvNhwc(
+                        job.inputs->data<float16>(),
+                        job.weights->data<float16>(),
+                        job.outputs->data<float16>(), a, b, results, inputDims,
+                        weightShape[1], inputShape.getPadding(3),
+                        weightShape.getPadding(1), job.start, actInfo.function,
+                        actInfo.params, &sampling);
+            }
+        } else {
+            int inputDims[2] = { inputShape[0], inputShape[1] };
+            if (usesScaleShift()) {
+                kernels.batchNormScaleShiftPostFc(
+                        job.inputs->data<float16>(), job.weights->data<float>(),
+                        job.outputs->data<float16>(), a, b, results, inputDims,
+                        weightShape[1], inputShape.getPadding(1), job.start,
+                        job.sendOutputs, actInfo.function, actInfo.params);
+            } else {
+                kernels.batchNormPostFc(
+                        job.inputs->data<float16>(),
+                        job.weights->data<float16>(),
+                        job.outputs->data<float16>(), a, b, results, inputDims,
+                        weightShape[1], inputShape.getPadding(1), job.start,
+                        job.sendOutputs, actInfo.function, actInfo.params);
+            }
+        }
+    }
+    free(a);
+    free(b);
+    free(results);
+}
+
+void* SmvBatchNormOp::cpuWorker(void* _args) {
+    auto args = reinterpret_cast<CpuWorkerArgs*>(_args);
+    args->op->runCpuJobs(*args->jobs, args->start, args->numJobs);
+    delete args;
+    return nullptr;
+}
+
+Tensor* SmvBatchNormOp::createScaleShiftTensor() {
+    Tensor* mean = getInput(Mean);
+    Tensor* variance = getInput(Variance);
+    Tensor* gamma = getInput(Gamma);
+    Tensor* beta = getInput(Beta);
+    const TensorShape& shape = mean->getShape();
+    int chans = shape[1];
+    int rowSize = shape.getStorageDim(1);
+    TensorShape scaleShiftShape(
+            { 2, chans }, shape.getLayout(), shape.getAlignment());
+    Tensor* scaleShift = new Tensor(name + "/scale_shift", scaleShiftShape);
+    workspace->addTensor(scaleShift);
+    // The shifts fold the mean in, so they are kept in single precision.
+    float* scaleShiftData = scaleShift->allocateStorage<float>();
+    float16* meanData = mean->data<float16>();
+    float16* varianceData = variance->data<float16>();
+    float16* gammaData = gamma->data<float16>();
+    float16* betaData = beta->data<float16>();
+    for (int c = 0; c < rowSize; c++) {
+        float scale = 0;
+        float shift = 0;
+        if (c < chans) {
+            // The variance is precomputed as 1/sqrt(variance + eps).
+            scale = fp16_ieee_to_fp32_value(varianceData[c]) *
+                    fp16_ieee_to_fp32_value(gammaData[c]);
+            shift = fp16_ieee_to_fp32_value(betaData[c]) -
+                    fp16_ieee_to_fp32_value(meanData[c]) * scale;
+        }
+        scaleShiftData[c] = scale;
+        scaleShiftData[rowSize + c] = shift;
     }
+    return scaleShift;
 }
 
 void SmvBatchNormOp::tile() {
@@ -1,6 +1,8 @@
 #ifndef _OPERATORS_SMV_SMV_BATCH_NORM_OP_H_
 #define _OPERATORS_SMV_SMV_BATCH_NORM_OP_H_
 
+#include <vector>
+
 #include "smaug/core/backend.h"
 #include "smaug/operators/common.h"
 #include "smaug/operators/batch_norm_op.h"
@@ -23,6 +25,11 @@ class TilingOptimizer;
  * SMV backend implementation of batch normalization.
  *
  * Elements are formatted and consumed in vectors of 8.
+ *
+ * On the Cpu backend, the four weights are folded into a scale and a shift
+ * per channel when the op is tiled, so that each element takes a single
+ * multiply-add, and the tiles are distributed across the thread pool, up to
+ * numCores workers.
  */
 class SmvBatchNormOp : public BatchNormOp<SmvBackend> {
   public:
@@ -30,7 +37,45 @@ class SmvBatchNormOp : public BatchNormOp<SmvBackend> {
     void tile() override;
     void run() override;
 
+    /**
+     * Returns true if the kernels take the weights folded into a scale and a
+     * shift instead of the mean, variance, gamma and beta. This requires the
+     * variance to be precomputed as 1/sqrt(variance + eps).
+     */
+    bool usesScaleShift() const {
+        return backEnd == Cpu && SmvBackend::PrecomputeBNVariance;
+    }
+
+    /**
+     * Creates a single-precision tensor with the scales
+     * (gamma / sqrt(variance + eps)) in the first row and the shifts
+     * (beta - mean * scale) in the second one.
+     */
+    Tensor* createScaleShiftTensor();
+
   protected:
+   /** A set of tiles consumed by one kernel invocation on Cpu. */
+   struct TileJob {
+       Tensor* inputs;
+       Tensor* weights;
+       Tensor* outputs;
+       /**
+        * The channel offset of the tile: the inputs offset for post-FC batch
+        * norms, the weights offset for post-convolution ones.
+        */
+       int start;
+       /** Post-FC only: whether the kernel sends back its results. */
+       bool sendOutputs;
+   };
+
+   /** Arguments of a worker thread running a range of TileJobs on Cpu. */
+   struct CpuWorkerArgs {
+       SmvBatchNormOp* op;
+       const std::vector<TileJob>* jobs;
+       int start;
+       int numJobs;
+   };
+
    /** Post-FC tile dispatcher. */
    void runNA(TiledTensor& inputs, TiledTensor& weights, TiledTensor& outputs);
 
@@ -39,6 +84,19 @@ class SmvBatchNormOp : public BatchNormOp<SmvBackend> {
                 TiledTensor& weights,
                 TiledTensor& outputs);
 
+   /**
+    * Splits TileJobs across the thread pool. A thread's range of jobs may only
+    * start at one of the given job indices, i.e. at a job that does not
+    * reuse the local buffers of the previous one.
+    */
+   void dispatchCpuJobs(const std::vector<TileJob>& jobs,
+                        const std::vector<int>& splits);
+
+   /** Runs TileJobs [start, start + numJobs) on the calling thread. */
+   void runCpuJobs(const std::vector<TileJob>& jobs, int start, int numJobs);
+
+   static void* cpuWorker(void* args);
+
    std::array<TiledTensor, 3> tiledTensors;
 };
 
@@ -2,6 +2,8 @@
 #include "smaug/core/backend.h"
 #include "smaug/core/tensor.h"
 #include "smaug/core/smaug_test.h"
+#include "smaug/core/globals.h"
+#include "smaug/utility/thread_pool.h"
 #include "smaug/operators/smv/smv_test_common.h"
 #include "smaug/operators/smv/smv_batch_norm_op.h"
 
@@ -40,8 +42,10 @@ class SmvBatchNormOpTest : public SmaugTest {
         return convertFp32ToFp16Tensor(refBnOp->getOutput(0), workspace());
     }
 
-    void doTest(std::vector<int> dims) {
+    void doTest(std::vector<int> dims, BackEndName_t backEnd = Smv) {
         auto bnOp = new SmvBatchNormOp("bn", workspace());
+        bnOp->setBackEnd(backEnd);
+        bnOp->setNumCores(backEnd == Cpu ? 4 : 1);
         DataLayout layout = dims.size() == 4 ? NHWC : NC;
         TensorShape inputShape(dims, layout, SmvBackend::Alignment);
         Tensor* inputs = new Tensor("input", inputShape);
@@ -56,8 +60,10 @@ class SmvBatchNormOpTest : public SmaugTest {
         verifyOutputs<float16>(outputs, refOutputs);
     }
 
-    void doFusionTest(std::vector<int> dims) {
+    void doFusionTest(std::vector<int> dims, BackEndName_t backEnd = Smv) {
         auto bnOp = new SmvBatchNormOp("bn", workspace());
+        bnOp->setBackEnd(backEnd);
+        bnOp->setNumCores(backEnd == Cpu ? 4 : 1);
         ActivationInfo actInfo;
         actInfo.function = activation_type::ELU;
         bnOp->setActivation(actInfo);
@@ -113,3 +119,30 @@ TEST_CASE_METHOD(SmvBatchNormOpTest,
     SECTION("No tiling required") { doFusionTest({ 1, 1024 }); }
     SECTION("DimNC required") { doFusionTest({ 1, 32768 }); }
 }
+
+TEST_CASE_METHOD(SmvBatchNormOpTest,
+                 "Cpu Batch Norm with fused scale and shift",
+                 "[smvpool]") {
+    ThreadPool* savedThreadPool = threadPool;
+    bool savedFastForwardMode = fastForwardMode;
+    threadPool = new ThreadPool(4);
+    threadPool->initThreadPool();
+    fastForwardMode = false;
+    SECTION("Post-conv") {
+        SECTION("No tiling required") { doTest({ 1, 32, 32, 16 }, Cpu); }
+        SECTION("DimNC tiling") { doTest({ 1, 16, 16, 128 }, Cpu); }
+        SECTION("DimNH tiling") { doTest({ 1, 64, 64, 32 }, Cpu); }
+        SECTION("DimNCH tiling") { doTest({ 1, 64, 64, 512 }, Cpu); }
+        SECTION("Fused activation") {
+            doFusionTest({ 1, 128, 128, 64 }, Cpu);
+        }
+    }
+    SECTION("Post-FC") {
+        SECTION("No tiling required") { doTest({ 4, 1024 }, Cpu); }
+        SECTION("DimNC required") { doTest({ 1, 32768 }, Cpu); }
+        SECTION("Fused activation") { doFusionTest({ 1, 32768 }, Cpu); }
+    }
+    delete threadPool;
+    threadPool = savedThreadPool;
+    fastForwardMode = savedFastForwardMode;
+}
@@ -26,8 +26,10 @@ std::array<TilingDims, 2> TilingOptimizer::determineBestTilingDims(
         bestInputTilingDims =
                 findBestTilingDims(inputShape, maxTileSize, { 1, kVectorSize });
     }
+    // The weights are tiled channelwise only.
+    const TensorShape& weightsShape = weights->getShape();
     TilingDims bestWeightTilingDims = findBestTilingDims(
-            weights->getShape(), maxTileSize, { 4, kVectorSize });
+            weightsShape, maxTileSize, { weightsShape[0], kVectorSize });
 
     return { bestInputTilingDims, bestWeightTilingDims };
 }
@@ -264,9 +266,15 @@ std::array<TiledTensor, 3> TilingOptimizer::doTiling(SmvBatchNormOp* op) {
     auto variance = op->getInput(SmvBatchNormOp::Variance);
     auto gamma = op->getInput(SmvBatchNormOp::Gamma);
     auto beta = op->getInput(SmvBatchNormOp::Beta);
-    // Concatenate the four weight tensors into one.
-    auto weights = concatTensors(
-            { mean, variance, gamma, beta }, 0, op->getWorkspace());
+    Tensor* weights;
+    if (op->usesScaleShift()) {
+        // Fold the four weight tensors into a scale and a shift.
+        weights = op->createScaleShiftTensor();
+    } else {
+        // Concatenate the four weight tensors into one.
+        weights = concatTensors(
+                { mean, variance, gamma, beta }, 0, op->getWorkspace());
+    }
     auto outputs = op->getOutput(SmvBatchNormOp::Outputs);
     TilingConfig tileConfig =
             TilingOptimizer::computeBasicTileShapes(op->getMemSize(), inputs, weights, outputs);
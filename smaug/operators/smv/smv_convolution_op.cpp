@@ -1,17 +1,29 @@
+#include <algorithm>
+#include <cmath>
+
 #include "smaug/core/backend.h"
+#include "smaug/core/globals.h"
 #include "smaug/operators/common.h"
+#include "smaug/operators/smv/kernels/params.h"
+#include "smaug/operators/smv/kernels/cpu_kernels.h"
 #include "smaug/operators/smv/smv_convolution_op.h"
 #include "smaug/operators/smv/smv_convolution_tiling.h"
 #include "smaug/operators/smv/smv_kernels.h"
 #include "smaug/operators/smv/smv_accel_pool.h"
+#include "smaug/operators/smv/smv_perf_model.h"
+#include "smaug/operators/smv/smv_quantize.h"
+#include "smaug/operators/smv/kernels/convolution_specialized.h"
 #include "smaug/utility/debug_stream.h"
+#include "smaug/utility/thread_pool.h"
 
 namespace smaug {
 namespace smv {
 namespace conv {
 
-const int kNumPEs = 8;
-const int kNumMaccsPerPE = 32;
+const int kNumPEs = NUM_PE_INSTS;
+const int kNumMaccsPerPE = DATA_PE_ALIGNMENT;
+// Sized to keep a block's transformed tiles resident in a per-core L2 cache.
+const int kWinogradWorkspaceSize = 1024 * 1024;
 
 }  // namespace conv
 }  // namespace smv
@@ -42,8 +54,16 @@ void SmvConvolutionOp::runNHWC(TiledTensor& inputs,
     if (backEnd == Cpu) {
         a = (float*)smaug::malloc_aligned(memSize * 2);
         b = (float*)smaug::malloc_aligned(memSize * 2);
-        results = (float*)smaug::malloc_aligned(memSize * 2);
+        // The int8 tiles hold twice as many elements, each accumulated in an
+        // int32.
+        results = (float*)smaug::malloc_aligned(
+                isQuantized() ? memSize * 4 : memSize * 2);
     }
+    // On the Cpu backend, use a kernel specialized for the PE geometry, the
+    // filter size and the strides when there is one.
+    smv::conv::Conv3dKernel* cpuKernel = smv::conv::selectConv3dKernel(
+            getWeightRows(), getWeightCols(), getRowStride(), getColStride(),
+            numPEs);
 
     unsigned accelId = useSystolicArrayWhenAvailable ? smv::kSystolicArrayHw
                                                      : smv::kConvolutionHw;
@@ -96,6 +116,9 @@ void SmvConvolutionOp::runNHWC(TiledTensor& inputs,
             assert(numOutputInvocations > 1
                            ? weightOfmapTiles == 1
                            : weightOfmapTiles == outputChanTiles);
+            // The number of output channels produced by the previous weight
+            // tiles, used to find the scales of the quantized kernels.
+            int finishedKernels = 0;
             for (int W = 0; W < weightOfmapTiles; W++) {
                 // We have three loop levels up to this point, the first for
                 // input batch-wise tiles iteration, the second for input
@@ -150,10 +173,13 @@ void SmvConvolutionOp::runNHWC(TiledTensor& inputs,
                                 accelId + currAccelIdx, "host_inputs",
                                 inputTile->data<float16>(),
                                 inputShape.storageSize() * sizeof(float16));
-                        mapArrayToAccel(
-                                accelId + currAccelIdx, "host_weights",
-                                weightsTile->data<float16>(),
-                                weightsShape.storageSize() * sizeof(float16));
+                        if (!isQuantized()) {
+                            mapArrayToAccel(accelId + currAccelIdx,
+                                            "host_weights",
+                                            weightsTile->data<float16>(),
+                                            weightsShape.storageSize() *
+                                                    sizeof(float16));
+                        }
                         int inputDims[4] = { inputShape[0], inputShape[1],
                                              inputShape[2], inputShape[3] };
                         int weightsDims[4] = { weightsShape[0], weightsShape[1],
@@ -189,9 +215,21 @@ void SmvConvolutionOp::runNHWC(TiledTensor& inputs,
                         // channelwise tiles, the results are finished and need
                         // to be sent back to the host.
                         bool sendResults = wC == weightChanTiles - 1;
+                        if (readInputs)
+                            recordTileTransfer(inputTile);
+                        if (readWeights)
+                            recordTileTransfer(weightsTile);
+                        if (sendResults)
+                            recordTileTransfer(outputTile);
 
                         std::unique_ptr<volatile int> finishFlag;
-                        if (useSystolicArrayWhenAvailable) {
+                        if (isEstimating()) {
+                            recordKernelEstimate(
+                                    currAccelIdx,
+                                    smv::model::convCycles(
+                                            inputDims, weightsDims, outputDims,
+                                            numPEs, numMaccsPerPE));
+                        } else if (useSystolicArrayWhenAvailable) {
                             // Invoke the systolic array if specified.
                             finishFlag = invokeSystolicArrayKernel(
                                     accelId + currAccelIdx,
@@ -223,8 +261,28 @@ void SmvConvolutionOp::runNHWC(TiledTensor& inputs,
                                         kernStart, accumulate, readInputs,
                                         readWeights, sendResults, actInfo.function,
                                         actInfo.params, &sampling);
+                            } else if (isQuantized()) {
+                                const float* tileScales =
+                                        weightScales.data() + finishedKernels +
+                                        kernStart;
+                                smv_conv3d_nhwc_int8(
+                                        inputTile->data<float16>(),
+                                        weightsTile->data<int8_t>(),
+                                        outputTile->data<float16>(),
+                                        (int8_t*)a, (int8_t*)b,
+                                        (int32_t*)results, inputDims,
+                                        weightsDims, outputDims,
+                                        inputShape.getPadding(3),
+                                        weightsShape.getPadding(3),
+                                        outputShape.getPadding(3), inputHaloPad,
+                                        getRowStride(), getColStride(),
+                                        ifmapStart, kernStart, accumulate,
+                                        readInputs, readWeights, sendResults,
+                                        inputScale, tileScales,
+                                        actInfo.function, actInfo.params);
+                                finishFlag = nullptr;
                             } else if (backEnd == Cpu){
-                                smv_conv3d_nhwc_vec_fxp(
+                                cpuKernel(
                                         inputTile->data<float16>(),
                                         weightsTile->data<float16>(),
                                         outputTile->data<float16>(), a,
@@ -262,6 +320,7 @@ void SmvConvolutionOp::runNHWC(TiledTensor& inputs,
                     if (needOutputIteration)
                         kernStart += outputShape[3];
                 }
+                finishedKernels += weights[weightIdx(W, 0, 0, 0)]->getShape()[0];
                 currAccelIdx =
                         accelPool.getNextAvailableAccelerator(currAccelIdx);
             }
@@ -277,6 +336,141 @@ void SmvConvolutionOp::runNHWC(TiledTensor& inputs,
     }
 }
 
+void SmvConvolutionOp::runCpuBlocks(int numBlocks, CpuBlockFn fn) {
+    int numThreads = 1;
+    if (!fastForwardMode && threadPool)
+        numThreads = std::min(numCores, threadPool->size());
+    if (numThreads <= 1 || numBlocks == 1) {
+        (this->*fn)(0, numBlocks);
+        return;
+    }
+    int numBlocksPerThread = std::ceil(numBlocks * 1.0 / numThreads);
+    int remainingBlocks = numBlocks;
+    while (remainingBlocks > 0) {
+        int blocks = std::min(numBlocksPerThread, remainingBlocks);
+        auto args = new CpuBlockWorkerArgs{ this, fn,
+                                            numBlocks - remainingBlocks,
+                                            blocks };
+        int cpuid = threadPool->dispatchThread(cpuBlockWorker, (void*)args);
+        assert(cpuid != -1 && "Failed to dispatch thread!");
+        remainingBlocks -= blocks;
+    }
+    threadPool->joinThreadPool();
+}
+
+void* SmvConvolutionOp::cpuBlockWorker(void* _args) {
+    auto args = reinterpret_cast<CpuBlockWorkerArgs*>(_args);
+    (args->op->*(args->fn))(args->start, args->numBlocks);
+    delete args;
+    return nullptr;
+}
+
+void SmvConvolutionOp::runWinograd() {
+    // The transforms read the untiled tensors in place, so every byte is
+    // only moved once.
+    recordTileTransfer(getInput(Inputs));
+    recordTileTransfer(getInput(Kernels));
+    recordTileTransfer(getOutput(Outputs));
+    const TensorShape& outputShape = getOutput(Outputs)->getShape();
+    int numTiles = outputShape[0] * FRAC_CEIL(outputShape[1], 4) *
+                   FRAC_CEIL(outputShape[2], 4);
+    runCpuBlocks(FRAC_CEIL(numTiles, winogradTilesPerBlock),
+                 &SmvConvolutionOp::runWinogradBlocks);
+}
+
+void SmvConvolutionOp::runWinogradBlocks(int start, int numBlocks) {
+    Tensor* input = getInput(Inputs);
+    Tensor* output = getOutput(Outputs);
+    const TensorShape& inputShape = input->getShape();
+    const TensorShape& outputShape = output->getShape();
+    int inputDims[4] = { inputShape[0], inputShape[1], inputShape[2],
+                         inputShape[3] };
+    int outputDims[4] = { outputShape[0], outputShape[1], outputShape[2],
+                          outputShape[3] };
+    std::vector<int> inputPadding = getInputPadding();
+    int inputHaloPad[4] = { inputPadding[0], inputPadding[1], inputPadding[2],
+                            inputPadding[3] };
+    int chans = inputShape[3] + inputShape.getPadding(3);
+    int kernels = outputShape[3] + outputShape.getPadding(3);
+    int tileRows = FRAC_CEIL(outputShape[1], 4);
+    int tileCols = FRAC_CEIL(outputShape[2], 4);
+    int numTiles = outputShape[0] * tileRows * tileCols;
+
+    float* patch = (float*)smaug::malloc_aligned(
+            std::max(36 * chans, 16 * kernels) * sizeof(float));
+    float* transformedInputs = (float*)smaug::malloc_aligned(
+            36 * winogradTilesPerBlock * chans * sizeof(float));
+    float* transformedResults = (float*)smaug::malloc_aligned(
+            36 * winogradTilesPerBlock * kernels * sizeof(float));
+    for (int b = start; b < start + numBlocks; b++) {
+        int tileStart = b * winogradTilesPerBlock;
+        int blockTiles = std::min(winogradTilesPerBlock, numTiles - tileStart);
+        const smv::CpuKernels& cpuKernels = smv::getCpuKernels();
+        cpuKernels.winogradInputTransform(
+                input->data<float16>(), patch, transformedInputs, inputDims,
+                inputShape.getPadding(3), inputHaloPad, tileStart, blockTiles,
+                tileRows, tileCols);
+        cpuKernels.winogradBatchedGemm(transformedInputs,
+                                       winogradWeights->data<float>(),
+                                       transformedResults, blockTiles, chans,
+                                       kernels);
+        cpuKernels.winogradOutputTransform(
+                transformedResults, patch, output->data<float16>(), outputDims,
+                outputShape.getPadding(3), tileStart, blockTiles, tileRows,
+                tileCols, actInfo.function, actInfo.params);
+    }
+    free(patch);
+    free(transformedInputs);
+    free(transformedResults);
+}
+
+void SmvConvolutionOp::runPointwiseGemm() {
+    // Like the Winograd path, the GEMM reads the untiled tensors in place.
+    recordTileTransfer(getInput(Inputs));
+    recordTileTransfer(getInput(Kernels));
+    recordTileTransfer(getOutput(Outputs));
+    const TensorShape& outputShape = getOutput(Outputs)->getShape();
+    int numRows = outputShape[0] * outputShape[1] * outputShape[2];
+    runCpuBlocks(FRAC_CEIL(numRows, gemmBlocking.rowsPerBlock),
+                 &SmvConvolutionOp::runPointwiseGemmBlocks);
+}
+
+void SmvConvolutionOp::runPointwiseGemmBlocks(int start, int numBlocks) {
+    Tensor* input = getInput(Inputs);
+    Tensor* kernels = getInput(Kernels);
+    Tensor* output = getOutput(Outputs);
+    const TensorShape& inputShape = input->getShape();
+    const TensorShape& kernelShape = kernels->getShape();
+    const TensorShape& outputShape = output->getShape();
+    int numRows = outputShape[0] * outputShape[1] * outputShape[2];
+    int rowStart = start * gemmBlocking.rowsPerBlock;
+    int rows = std::min(numBlocks * gemmBlocking.rowsPerBlock,
+                        numRows - rowStart);
+    // The GEMM sees the NHWC inputs as a matrix of pixels by channels, and
+    // the kernels as a matrix of output channels by input channels.
+    int aDims[2] = { numRows, inputShape[3] };
+    int bDims[2] = { kernelShape[0], kernelShape[3] };
+    int chansPerBlock = gemmBlocking.chansPerBlock;
+    int colsPerBlock = gemmBlocking.colsPerBlock;
+    float* packedA = (float*)smaug::malloc_aligned(
+            gemmBlocking.rowsPerBlock * chansPerBlock * sizeof(float));
+    float* packedB = (float*)smaug::malloc_aligned(
+            colsPerBlock * chansPerBlock * sizeof(float));
+    float* results = (float*)smaug::malloc_aligned(
+            FRAC_CEIL(rows, smv::kGemmMR) * smv::kGemmMR * colsPerBlock *
+            sizeof(float));
+    smv::getCpuKernels().packedGemm(
+            input->data<float16>(), kernels->data<float16>(),
+            output->data<float16>(), packedA, packedB, results, aDims, bDims,
+            inputShape.getPadding(3), kernelShape.getPadding(3),
+            outputShape.getPadding(3), rowStart, rows, 0, outputShape[3],
+            gemmBlocking.rowsPerBlock, colsPerBlock, chansPerBlock,
+            actInfo.function, actInfo.params);
+    free(packedA);
+    free(packedB);
+    free(results);
+}
+
 std::unique_ptr<volatile int> SmvConvolutionOp::invokeSystolicArrayKernel(
         unsigned accelId,
         float16* inputs,
@@ -340,6 +534,46 @@ void SmvConvolutionOp::tile() {
     // layer instead of merging them into a single output tensor first. It's
     // sort of operator fusing that two back-to-back convolution operators are
     // tiled only once.
+    if (isQuantized() && !quantizedWeights) {
+        quantizedWeights = smv::quant::quantizeWeightsPerChannel(
+                getInput(Kernels), workspace, weightScales);
+    }
+    if (useWinograd()) {
+        // The Winograd kernels work on the whole tensors, in blocks of
+        // transformed tiles, so only the filter transform is done here.
+        if (!winogradWeights) {
+            Tensor* kernels = getInput(Kernels);
+            const TensorShape& kernelShape = kernels->getShape();
+            int weightsDims[4] = { kernelShape[0], kernelShape[1],
+                                   kernelShape[2], kernelShape[3] };
+            int chans = kernelShape[3] + kernelShape.getPadding(3);
+            int numKernels = FRAC_CEIL(kernelShape[0], VECTOR_SIZE) *
+                             VECTOR_SIZE;
+            winogradWeights = new Tensor(
+                    getName() + "/winograd_weights",
+                    TensorShape({ 36 * chans, numKernels }, DataLayout::NC));
+            winogradWeights->allocateStorage<float>();
+            workspace->addTensor(winogradWeights);
+            float* weights =
+                    (float*)smaug::malloc_aligned(9 * chans * sizeof(float));
+            smv::getCpuKernels().winogradFilterTransform(
+                    kernels->data<float16>(), weights,
+                    winogradWeights->data<float>(), weightsDims,
+                    kernelShape.getPadding(3));
+            free(weights);
+        }
+        winogradTilesPerBlock =
+                smaug::smv::conv::TilingOptimizer::computeWinogradTilesPerBlock(
+                        this);
+        return;
+    }
+    if (usePointwiseGemm()) {
+        // Likewise, the GEMM works on blocks of the whole tensors.
+        gemmBlocking =
+                smaug::smv::conv::TilingOptimizer::computePointwiseGemmBlocking(
+                        this);
+        return;
+    }
     tiledTensors = smaug::smv::conv::TilingOptimizer::doTiling(this);
 }
 
@@ -354,6 +588,16 @@ void SmvConvolutionOp::run() {
     assert(kernelShape.getLayout() == DataLayout::NHWC);
     assert(outputShape.getLayout() == DataLayout::NHWC);
     dout(2) << *kernels << "\n";
+    if (isQuantized())
+        inputScale = smv::quant::computeInt8Scale(input);
+    if (useWinograd()) {
+        runWinograd();
+        return;
+    }
+    if (usePointwiseGemm()) {
+        runPointwiseGemm();
+        return;
+    }
 
     {
         auto stats = gem5::ScopedStats(
@@ -1,9 +1,12 @@
 #ifndef _OPERATORS_SMV_SMV_CONVOLUTION_OP_H_
 #define _OPERATORS_SMV_SMV_CONVOLUTION_OP_H_
 
+#include <vector>
+
 #include "smaug/core/backend.h"
 #include "smaug/operators/common.h"
 #include "smaug/operators/convolution_op.h"
+#include "smaug/operators/smv/smv_tiling_common.h"
 
 namespace smaug {
 
@@ -13,6 +16,7 @@ namespace conv {
 
 extern const int kNumPEs;
 extern const int kNumMaccsPerPE;
+extern const int kWinogradWorkspaceSize;
 
 class TilingOptimizer;
 
@@ -31,6 +35,32 @@ class SmvConvolutionOp : public ConvolutionOp<SmvBackend> {
     void run() override;
     friend class smv::conv::TilingOptimizer;
 
+    /**
+     * Returns true if this operator runs the int8 kernel, which is only
+     * implemented for the Cpu backend.
+     */
+    bool isQuantized() const { return useInt8WhenAvailable && backEnd == Cpu; }
+
+    /**
+     * Returns true if this operator runs the Winograd F(4x4, 3x3) kernels
+     * instead of the direct convolution, which is the case for all the fp16
+     * 3x3 stride-1 convolutions on the Cpu backend.
+     */
+    bool useWinograd() const {
+        return backEnd == Cpu && !isQuantized() && weightRows == 3 &&
+               weightCols == 3 && rowStride == 1 && colStride == 1;
+    }
+
+    /**
+     * Returns true if this operator runs as a GEMM over the output pixels
+     * instead of the direct convolution, which is the case for all the fp16
+     * pointwise (1x1, stride 1) convolutions on the Cpu backend.
+     */
+    bool usePointwiseGemm() const {
+        return backEnd == Cpu && !isQuantized() && weightRows == 1 &&
+               weightCols == 1 && rowStride == 1 && colStride == 1;
+    }
+
   protected:
    /**
     * Tiling scheduler for this operator.
@@ -59,7 +89,59 @@ class SmvConvolutionOp : public ConvolutionOp<SmvBackend> {
            bool sendResults,
            ActivationInfo* actInfo);
 
+   /** Runs a range of blocks of a Cpu fast path on the calling thread. */
+   typedef void (SmvConvolutionOp::*CpuBlockFn)(int start, int numBlocks);
+
+   /** Arguments of a worker thread running a range of blocks. */
+   struct CpuBlockWorkerArgs {
+       SmvConvolutionOp* op;
+       CpuBlockFn fn;
+       int start;
+       int numBlocks;
+   };
+
+   /**
+    * Runs numBlocks independent blocks of work with fn, distributing
+    * contiguous ranges of blocks across the thread pool.
+    */
+   void runCpuBlocks(int numBlocks, CpuBlockFn fn);
+   static void* cpuBlockWorker(void* args);
+
+   /**
+    * Runs the Winograd convolution, splitting the 4x4 output tiles into
+    * blocks of winogradTilesPerBlock.
+    */
+   void runWinograd();
+   /** Runs Winograd blocks [start, start + numBlocks). */
+   void runWinogradBlocks(int start, int numBlocks);
+
+   /**
+    * Runs the pointwise convolution as a GEMM, splitting the output pixels
+    * into blocks of gemmBlocking.rowsPerBlock.
+    */
+   void runPointwiseGemm();
+   /** Runs pointwise GEMM blocks [start, start + numBlocks). */
+   void runPointwiseGemmBlocks(int start, int numBlocks);
+
    std::array<TiledTensor, 3> tiledTensors;
+
+   /** The int8 copy of the kernels, if isQuantized(). */
+   Tensor* quantizedWeights = nullptr;
+   /** The scale of each output channel of quantizedWeights. */
+   std::vector<float> weightScales;
+   /** The scale of the inputs, recomputed on every run. */
+   float inputScale = 1;
+
+   /**
+    * The kernels transformed into the Winograd domain, if useWinograd().
+    * These are computed once, when the operator is first tiled.
+    */
+   Tensor* winogradWeights = nullptr;
+   /** The number of 4x4 output tiles in a Winograd block. */
+   int winogradTilesPerBlock = 0;
+
+   /** The cache blocking of the pointwise GEMM. */
+   smv::GemmBlocking gemmBlocking;
 };
 
 }  // namespace smaug
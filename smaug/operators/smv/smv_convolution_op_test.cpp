@@ -1,10 +1,19 @@
+#include <chrono>
+#include <iostream>
+
 #include "catch.hpp"
 #include "smaug/core/backend.h"
+#include "smaug/core/backend_config.h"
+#include "smaug/core/globals.h"
 #include "smaug/core/tensor.h"
 #include "smaug/core/smaug_test.h"
 #include "smaug/operators/smv/smv_test_common.h"
 #include "smaug/operators/smv/smv_convolution_op.h"
 #include "smaug/operators/smv/smv_convolution_tiling.h"
+#include "smaug/operators/smv/kernels/convolution_specialized.h"
+#include "smaug/operators/smv/kernels/cpu_kernels.h"
+#include "smaug/utility/cpu_info.h"
+#include "smaug/utility/thread_pool.h"
 
 using namespace smaug;
 
@@ -81,6 +90,163 @@ class SmvConvolutionOpTest : public SmaugTest {
         auto refOutputs = getReferenceOutput(convOp);
         verifyOutputs<float16>(outputs, refOutputs);
     }
+
+    // Runs a convolution that takes one of the Cpu fast paths (Winograd or
+    // pointwise GEMM) instead of the tiled direct convolution.
+    void doCpuFastPathTest(std::vector<int> inputDims,
+                           std::vector<int> kernelDims,
+                           PaddingType padding = SamePadding,
+                           ActivationInfo actInfo = ActivationInfo()) {
+        auto convOp = new SmvConvolutionOp("conv", workspace());
+        convOp->setBackEnd(Cpu);
+        convOp->setNumCores(4);
+        convOp->setMemSize(DEFAULT_MEM_SIZE_SMV);
+        convOp->setNumPEs(DEFAULT_NUM_PE_SMV);
+        convOp->setNumMaccsPerPE(DEFAULT_NUM_MAC_PER_PE_SMV);
+        convOp->setActivation(actInfo);
+        convOp->setStride(1, 1);
+        convOp->setPadding(padding);
+        TensorShape inputShape(inputDims, NHWC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("input", inputShape);
+        inputs->allocateStorage<float16>();
+        workspace()->addTensor(inputs);
+        convOp->setInput(inputs, 0);
+        convOp->setWeightDims(kernelDims[1], kernelDims[2], kernelDims[0]);
+        createAndFillTensorsWithData<float16>(convOp, fillTensorWithRandomData);
+        REQUIRE((convOp->useWinograd() || convOp->usePointwiseGemm()));
+        convOp->tile();
+        convOp->run();
+        // The fast paths reorder the accumulation, so compare the values in
+        // fp32 instead of the fp16 bit patterns, which diverge near zero.
+        auto outputs =
+                convertFp16ToFp32Tensor(convOp->getOutput(0), workspace());
+        auto refOutputs = convertFp16ToFp32Tensor(
+                getReferenceOutput(convOp), workspace());
+        verifyOutputs<float>(outputs, refOutputs);
+    }
+
+    // Runs a convolution through the tiled direct convolution on the Cpu
+    // backend, which picks a specialized kernel for common filter geometries.
+    void doCpuDirectTest(std::vector<int> inputDims,
+                         std::vector<int> kernelDims,
+                         PaddingType padding = SamePadding,
+                         std::vector<int> strides = { 1, 1 },
+                         ActivationInfo actInfo = ActivationInfo(),
+                         int numPEs = DEFAULT_NUM_PE_SMV) {
+        auto convOp = new SmvConvolutionOp("conv", workspace());
+        convOp->setBackEnd(Cpu);
+        convOp->setNumCores(1);
+        convOp->setMemSize(DEFAULT_MEM_SIZE_SMV);
+        convOp->setNumPEs(numPEs);
+        convOp->setNumMaccsPerPE(DEFAULT_NUM_MAC_PER_PE_SMV);
+        convOp->setActivation(actInfo);
+        convOp->setStride(strides[0], strides[1]);
+        convOp->setPadding(padding);
+        TensorShape inputShape(inputDims, NHWC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("input", inputShape);
+        inputs->allocateStorage<float16>();
+        workspace()->addTensor(inputs);
+        convOp->setInput(inputs, 0);
+        convOp->setWeightDims(kernelDims[1], kernelDims[2], kernelDims[0]);
+        createAndFillTensorsWithData<float16>(convOp, fillTensorWithRandomData);
+        REQUIRE_FALSE(convOp->useWinograd());
+        REQUIRE_FALSE(convOp->usePointwiseGemm());
+        convOp->tile();
+        convOp->run();
+        auto outputs =
+                convertFp16ToFp32Tensor(convOp->getOutput(0), workspace());
+        auto refOutputs = convertFp16ToFp32Tensor(
+                getReferenceOutput(convOp), workspace());
+        verifyOutputs<float>(outputs, refOutputs);
+    }
+
+    Tensor* createRandomTensor(const std::string& name,
+                               std::vector<int> dims) {
+        TensorShape shape(dims, NHWC, SmvBackend::Alignment);
+        Tensor* tensor = new Tensor(name, shape);
+        tensor->allocateStorage<float16>();
+        workspace()->addTensor(tensor);
+        fillTensorWithRandomData(tensor);
+        return tensor;
+    }
+
+    // Runs the specialized kernel for a filter geometry and the generic
+    // kernel on the same tile, and compares the results. With more than one
+    // iteration, the time taken by each kernel is reported.
+    void doSpecializedKernelTest(std::vector<int> inputDims,
+                                 std::vector<int> kernelDims,
+                                 int stride,
+                                 std::vector<int> haloPad,
+                                 int numPEs = DEFAULT_NUM_PE_SMV,
+                                 int iters = 1) {
+        smv::conv::Conv3dKernel* kernel = smv::conv::selectConv3dKernel(
+                kernelDims[1], kernelDims[2], stride, stride, numPEs);
+        smv::conv::Conv3dKernel* generic = smv::getCpuKernels().conv3d;
+        REQUIRE(kernel != generic);
+        int outputRows = FRAC_CEIL(inputDims[1] + haloPad[0] + haloPad[1] -
+                                           kernelDims[1] + 1,
+                                   stride);
+        int outputCols = FRAC_CEIL(inputDims[2] + haloPad[2] + haloPad[3] -
+                                           kernelDims[2] + 1,
+                                   stride);
+        std::vector<int> outputDims = { 1, outputRows, outputCols,
+                                        kernelDims[0] };
+        Tensor* inputs = createRandomTensor("inputs", inputDims);
+        Tensor* weights = createRandomTensor("weights", kernelDims);
+        Tensor* outputs = createRandomTensor("outputs", outputDims);
+        Tensor* refOutputs = createRandomTensor("ref_outputs", outputDims);
+        const TensorShape& inputShape = inputs->getShape();
+        const TensorShape& weightShape = weights->getShape();
+        const TensorShape& outputShape = outputs->getShape();
+        // host_load_fp16 rounds the transfers up to whole cachelines.
+        int bufferSize = std::max(
+                { inputShape.storageSize(), weightShape.storageSize(),
+                  outputShape.storageSize() }) + 32;
+        float* localInputs = (float*)malloc_aligned(bufferSize * sizeof(float));
+        float* localWeights =
+                (float*)malloc_aligned(bufferSize * sizeof(float));
+        float* localResults =
+                (float*)malloc_aligned(bufferSize * sizeof(float));
+        SamplingInfo sampling;
+        sampling.level = NoSampling;
+        sampling.num_sample_iterations = 1;
+        auto runKernel = [&](smv::conv::Conv3dKernel* kernel, Tensor* results,
+                             bool readData) {
+            kernel(inputs->data<float16>(), weights->data<float16>(),
+                   results->data<float16>(), localInputs, localWeights,
+                   localResults, inputDims.data(), kernelDims.data(),
+                   outputDims.data(), inputShape.getPadding(3),
+                   weightShape.getPadding(3), outputShape.getPadding(3),
+                   haloPad.data(), stride, stride, 0, 0, false, readData,
+                   readData, true, NO_ACTIVATION, activation_param_t(),
+                   &sampling);
+        };
+        // Both kernels reuse the local copies of the inputs and weights, so
+        // that only the computation is timed.
+        auto timeKernel = [&](smv::conv::Conv3dKernel* kernel,
+                              Tensor* results) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iters; i++)
+                runKernel(kernel, results, false);
+            std::chrono::duration<double> elapsed =
+                    std::chrono::steady_clock::now() - start;
+            return elapsed.count() / iters;
+        };
+        runKernel(kernel, outputs, true);
+        double specializedTime = timeKernel(kernel, outputs);
+        double genericTime = timeKernel(generic, refOutputs);
+        if (iters > 1) {
+            std::cout << kernelDims[1] << "x" << kernelDims[2] << ", stride "
+                      << stride << ", " << numPEs << " PEs: generic " << genericTime * 1e3
+                      << " ms, specialized " << specializedTime * 1e3
+                      << " ms\n";
+        }
+        free(localInputs);
+        free(localWeights);
+        free(localResults);
+        verifyOutputs<float>(convertFp16ToFp32Tensor(outputs, workspace()),
+                             convertFp16ToFp32Tensor(refOutputs, workspace()));
+    }
 };
 
 }  // namespace smaug
@@ -340,3 +506,239 @@ TEST_CASE_METHOD(SmvConvolutionOpTest, "Stride size tests", "[smvconv]") {
         }
     }
 }
+
+TEST_CASE_METHOD(SmvConvolutionOpTest,
+                 "Cpu Winograd convolution",
+                 "[smvconv]") {
+    SECTION("Only 3x3 stride-1 Cpu convolutions use Winograd") {
+        auto convOp = new SmvConvolutionOp("conv", workspace());
+        convOp->setBackEnd(Cpu);
+        convOp->setWeightDims(3, 3, 8);
+        convOp->setStride(1, 1);
+        REQUIRE(convOp->useWinograd());
+        convOp->setStride(2, 2);
+        REQUIRE_FALSE(convOp->useWinograd());
+        convOp->setStride(1, 1);
+        convOp->setWeightDims(5, 5, 8);
+        REQUIRE_FALSE(convOp->useWinograd());
+        convOp->setWeightDims(3, 3, 8);
+        convOp->setBackEnd(Smv);
+        REQUIRE_FALSE(convOp->useWinograd());
+    }
+    SECTION("Single block") { doCpuFastPathTest({ 1, 8, 8, 8 }, { 8, 3, 3, 8 }); }
+    SECTION("Sizes not multiples of the tile and vector sizes") {
+        doCpuFastPathTest({ 1, 13, 11, 20 }, { 10, 3, 3, 20 });
+    }
+    SECTION("Valid padding") {
+        doCpuFastPathTest(
+                { 1, 16, 16, 32 }, { 16, 3, 3, 32 }, ValidPadding);
+    }
+    SECTION("Many blocks with fused activation") {
+        doCpuFastPathTest({ 1, 32, 32, 64 },
+                          { 64, 3, 3, 64 },
+                          SamePadding,
+                          ActivationInfo(activation_type::RELU));
+    }
+    SECTION("Multithreaded") {
+        ThreadPool* savedThreadPool = threadPool;
+        bool savedFastForwardMode = fastForwardMode;
+        threadPool = new ThreadPool(4);
+        threadPool->initThreadPool();
+        fastForwardMode = false;
+        doCpuFastPathTest({ 1, 56, 56, 128 }, { 128, 3, 3, 128 });
+        delete threadPool;
+        threadPool = savedThreadPool;
+        fastForwardMode = savedFastForwardMode;
+    }
+}
+
+TEST_CASE_METHOD(SmvConvolutionOpTest,
+                 "Cpu pointwise convolution",
+                 "[smvconv]") {
+    SECTION("Only 1x1 stride-1 Cpu convolutions use the GEMM") {
+        auto convOp = new SmvConvolutionOp("conv", workspace());
+        convOp->setBackEnd(Cpu);
+        convOp->setWeightDims(1, 1, 8);
+        convOp->setStride(1, 1);
+        REQUIRE(convOp->usePointwiseGemm());
+        REQUIRE_FALSE(convOp->useWinograd());
+        convOp->setStride(2, 2);
+        REQUIRE_FALSE(convOp->usePointwiseGemm());
+        convOp->setStride(1, 1);
+        convOp->setBackEnd(Smv);
+        REQUIRE_FALSE(convOp->usePointwiseGemm());
+    }
+    SECTION("Blocking") {
+        auto convOp = new SmvConvolutionOp("conv", workspace());
+        convOp->setBackEnd(Cpu);
+        convOp->setNumCores(1);
+        convOp->setStride(1, 1);
+        convOp->setPadding(SamePadding);
+        TensorShape inputShape(
+                { 1, 32, 32, 1024 }, NHWC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("inputs", inputShape);
+        workspace()->addTensor(inputs);
+        convOp->setInput(inputs, 0);
+        convOp->setWeightDims(1, 1, 64);
+        convOp->createAllTensors();
+        smv::GemmBlocking blocking =
+                smv::conv::TilingOptimizer::computePointwiseGemmBlocking(
+                        convOp);
+        const CacheSizes& caches = getHostCacheSizes();
+        REQUIRE(blocking.chansPerBlock <= 1024);
+        REQUIRE(blocking.chansPerBlock % VECTOR_SIZE == 0);
+        REQUIRE(blocking.chansPerBlock * smv::kGemmNR * sizeof(float) <=
+                caches.l1d / 2);
+        REQUIRE(blocking.rowsPerBlock % smv::kGemmMR == 0);
+        REQUIRE(blocking.rowsPerBlock * blocking.chansPerBlock *
+                        sizeof(float) <=
+                caches.l2 / 2);
+        REQUIRE(blocking.colsPerBlock == 64);
+    }
+    SECTION("Single block") {
+        doCpuFastPathTest({ 1, 8, 8, 8 }, { 8, 1, 1, 8 });
+    }
+    SECTION("Sizes not multiples of the vector and row block sizes") {
+        doCpuFastPathTest({ 1, 7, 9, 12 }, { 20, 1, 1, 12 });
+    }
+    SECTION("Channel blocking with fused activation") {
+        doCpuFastPathTest({ 1, 16, 16, 1024 },
+                          { 64, 1, 1, 1024 },
+                          SamePadding,
+                          ActivationInfo(activation_type::RELU));
+    }
+    SECTION("Multithreaded") {
+        ThreadPool* savedThreadPool = threadPool;
+        bool savedFastForwardMode = fastForwardMode;
+        threadPool = new ThreadPool(4);
+        threadPool->initThreadPool();
+        fastForwardMode = false;
+        doCpuFastPathTest({ 1, 28, 28, 128 }, { 256, 1, 1, 128 });
+        delete threadPool;
+        threadPool = savedThreadPool;
+        fastForwardMode = savedFastForwardMode;
+    }
+}
+
+TEST_CASE_METHOD(SmvConvolutionOpTest,
+                 "Cpu specialized convolution kernels",
+                 "[smvconv]") {
+    SECTION("Kernel selection") {
+        using smv::conv::selectConv3dKernel;
+        smv::conv::Conv3dKernel* generic = smv::getCpuKernels().conv3d;
+        REQUIRE(selectConv3dKernel(3, 3, 2, 2) != generic);
+        REQUIRE(selectConv3dKernel(7, 7, 2, 2) != generic);
+        REQUIRE(selectConv3dKernel(3, 3, 2, 2) !=
+                selectConv3dKernel(3, 3, 1, 1));
+        REQUIRE(selectConv3dKernel(2, 2, 1, 1) == generic);
+        REQUIRE(selectConv3dKernel(5, 5, 2, 2) == generic);
+        REQUIRE(selectConv3dKernel(3, 3, 1, 2) == generic);
+        REQUIRE(selectConv3dKernel(3, 3, 2, 2, 16) !=
+                selectConv3dKernel(3, 3, 2, 2, 8));
+        REQUIRE(selectConv3dKernel(3, 3, 2, 2, 32) !=
+                selectConv3dKernel(3, 3, 2, 2, 16));
+        REQUIRE(selectConv3dKernel(3, 3, 2, 2, 24) == generic);
+    }
+    SECTION("Kernels match the generic kernel") {
+        SECTION("1x1, stride 1") {
+            doSpecializedKernelTest(
+                    { 1, 9, 7, 40 }, { 12, 1, 1, 40 }, 1, { 0, 0, 0, 0 });
+        }
+        SECTION("3x3, stride 1") {
+            doSpecializedKernelTest(
+                    { 1, 9, 7, 40 }, { 12, 3, 3, 40 }, 1, { 1, 1, 1, 1 });
+        }
+        SECTION("3x3, stride 2") {
+            doSpecializedKernelTest(
+                    { 1, 9, 7, 40 }, { 12, 3, 3, 40 }, 2, { 1, 1, 0, 1 });
+        }
+        SECTION("5x5, stride 1") {
+            doSpecializedKernelTest(
+                    { 1, 9, 7, 40 }, { 12, 5, 5, 40 }, 1, { 2, 2, 2, 2 });
+        }
+        SECTION("7x7, stride 2") {
+            doSpecializedKernelTest(
+                    { 1, 15, 13, 16 }, { 20, 7, 7, 16 }, 2, { 3, 3, 2, 3 });
+        }
+    }
+    SECTION("Kernels for 16 and 32 PEs match the generic kernel") {
+        SECTION("3x3, stride 1, 16 PEs") {
+            doSpecializedKernelTest(
+                    { 1, 9, 7, 40 }, { 36, 3, 3, 40 }, 1, { 1, 1, 1, 1 }, 16);
+        }
+        SECTION("5x5, stride 1, 16 PEs, fewer kernels than PEs") {
+            doSpecializedKernelTest(
+                    { 1, 9, 7, 24 }, { 12, 5, 5, 24 }, 1, { 2, 2, 2, 2 }, 16);
+        }
+        SECTION("7x7, stride 2, 32 PEs") {
+            doSpecializedKernelTest(
+                    { 1, 15, 13, 16 }, { 40, 7, 7, 16 }, 2, { 3, 3, 2, 3 }, 32);
+        }
+    }
+    SECTION("3x3 kernels with 2x2 strides") {
+        doCpuDirectTest({ 1, 64, 64, 32 }, { 16, 3, 3, 32 }, ValidPadding,
+                        { 2, 2 });
+    }
+    SECTION("5x5 kernels, weights DimN tiled") {
+        doCpuDirectTest({ 1, 32, 32, 32 }, { 128, 5, 5, 32 });
+    }
+    SECTION("5x5 kernels, DimNC tiled with fused activation") {
+        doCpuDirectTest({ 1, 16, 16, 512 }, { 32, 5, 5, 512 }, SamePadding,
+                        { 1, 1 }, ActivationInfo(activation_type::RELU));
+    }
+    SECTION("5x5 kernels on 16 PEs, weights DimN tiled") {
+        doCpuDirectTest({ 1, 32, 32, 32 }, { 128, 5, 5, 32 }, SamePadding,
+                        { 1, 1 }, ActivationInfo(), 16);
+    }
+    SECTION("7x7 kernels with 2x2 strides, inputs DimNH tiled") {
+        doCpuDirectTest({ 1, 225, 225, 8 }, { 64, 7, 7, 8 }, SamePadding,
+                        { 2, 2 });
+    }
+}
+
+TEST_CASE_METHOD(SmvConvolutionOpTest,
+                 "Cpu convolution on each instruction set",
+                 "[smvconv]") {
+    CpuIsa savedIsa = getCpuIsa();
+    for (CpuIsa isa : { Sse, Avx2, Avx512 }) {
+        if (isa > getHostCpuIsa())
+            break;
+        INFO("Instruction set: " << getCpuIsaName(isa));
+        REQUIRE(setCpuIsa(isa));
+        REQUIRE(smv::getCpuKernels().isa == isa);
+        doCpuFastPathTest({ 1, 13, 11, 20 }, { 10, 3, 3, 20 });
+        doCpuFastPathTest({ 1, 7, 9, 36 }, { 20, 1, 1, 36 });
+        doCpuDirectTest({ 1, 15, 13, 16 }, { 20, 7, 7, 16 }, SamePadding,
+                        { 2, 2 });
+        doCpuDirectTest({ 1, 9, 7, 40 }, { 12, 5, 5, 40 }, SamePadding,
+                        { 2, 2 });
+        doSpecializedKernelTest(
+                { 1, 9, 7, 40 }, { 12, 3, 3, 40 }, 1, { 1, 1, 1, 1 });
+    }
+    setCpuIsa(savedIsa);
+}
+
+// Not run by default. To run:
+//   smv_convolution_op_test "[benchmark]"
+TEST_CASE_METHOD(SmvConvolutionOpTest,
+                 "Cpu specialized convolution benchmark",
+                 "[.][benchmark]") {
+    const int kIters = 5;
+    doSpecializedKernelTest(
+            { 1, 28, 28, 64 }, { 32, 1, 1, 64 }, 1, { 0, 0, 0, 0 },
+            DEFAULT_NUM_PE_SMV, kIters);
+    doSpecializedKernelTest(
+            { 1, 28, 28, 64 }, { 32, 3, 3, 64 }, 1, { 1, 1, 1, 1 },
+            DEFAULT_NUM_PE_SMV, kIters);
+    doSpecializedKernelTest(
+            { 1, 28, 28, 64 }, { 32, 3, 3, 64 }, 1, { 1, 1, 1, 1 }, 16, kIters);
+    doSpecializedKernelTest(
+            { 1, 28, 28, 64 }, { 32, 3, 3, 64 }, 2, { 1, 1, 1, 1 },
+            DEFAULT_NUM_PE_SMV, kIters);
+    doSpecializedKernelTest(
+            { 1, 28, 28, 64 }, { 32, 5, 5, 64 }, 1, { 2, 2, 2, 2 },
+            DEFAULT_NUM_PE_SMV, kIters);
+    doSpecializedKernelTest(
+            { 1, 56, 56, 8 }, { 32, 7, 7, 8 }, 2, { 3, 3, 3, 3 },
+            DEFAULT_NUM_PE_SMV, kIters);
+}
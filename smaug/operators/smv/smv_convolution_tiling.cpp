@@ -58,7 +58,9 @@ TilingConfig TilingOptimizer::computeBasicTileShapes(SmvConvolutionOp* op) {
     Tensor* inputs = op->getInput(op->Inputs);
     Tensor* weights = op->getInput(op->Kernels);
     Tensor* outputs = op->getOutput(op->Outputs);
-    int maxTileSize = op->memSize / inputs->getDataTypeSize();
+    int elementSize =
+            op->isQuantized() ? sizeof(int8_t) : inputs->getDataTypeSize();
+    int maxTileSize = op->memSize / elementSize;
     std::array<TilingDims, 3> strategies =
             determineBestTilingDims(op, inputs, weights, outputs, maxTileSize);
     TilingDims inputTilingDims = strategies[0];
@@ -342,9 +344,47 @@ TiledTensor TilingOptimizer::generateRowwiseOutputTiledTensor(
     return outputTiledTensor;
 }
 
+int TilingOptimizer::computeWinogradTilesPerBlock(SmvConvolutionOp* op) {
+    const TensorShape& inputShape =
+            op->getInput(SmvConvolutionOp::Inputs)->getShape();
+    const TensorShape& outputShape =
+            op->getOutput(SmvConvolutionOp::Outputs)->getShape();
+    int numTiles = outputShape[0] * FRAC_CEIL(outputShape[1], 4) *
+                   FRAC_CEIL(outputShape[2], 4);
+    int transformedTileSize =
+            36 * (inputShape[3] + inputShape.getPadding(3) + outputShape[3] +
+                  outputShape.getPadding(3)) * sizeof(float);
+    int tilesPerBlock =
+            std::max(1, kWinogradWorkspaceSize / transformedTileSize);
+    int tilesPerCore = FRAC_CEIL(numTiles, std::max(1, op->numCores));
+    tilesPerBlock = std::min(tilesPerBlock, tilesPerCore);
+    dout(2) << "  Winograd tiles per block: " << tilesPerBlock << " of "
+            << numTiles << "\n";
+    return tilesPerBlock;
+}
+
+GemmBlocking TilingOptimizer::computePointwiseGemmBlocking(
+        SmvConvolutionOp* op) {
+    const TensorShape& inputShape =
+            op->getInput(SmvConvolutionOp::Inputs)->getShape();
+    const TensorShape& outputShape =
+            op->getOutput(SmvConvolutionOp::Outputs)->getShape();
+    int numRows = outputShape[0] * outputShape[1] * outputShape[2];
+    GemmBlocking blocking = computeGemmBlocking(
+            numRows, outputShape[3], inputShape.getStorageDim(3));
+    // The blocks of pixels are distributed across the cores.
+    int rowsPerCore = FRAC_CEIL(numRows, std::max(1, op->numCores));
+    blocking.rowsPerBlock =
+            std::min(blocking.rowsPerBlock,
+                     FRAC_CEIL(rowsPerCore, kGemmMR) * kGemmMR);
+    return blocking;
+}
+
 std::array<TiledTensor, 3> TilingOptimizer::doTiling(SmvConvolutionOp* op) {
     auto input = op->getInput(SmvConvolutionOp::Inputs);
-    auto kernels = op->getInput(SmvConvolutionOp::Kernels);
+    // The quantized copy of the weights is tiled in place of the original.
+    auto kernels = op->isQuantized() ? op->quantizedWeights
+                                     : op->getInput(SmvConvolutionOp::Kernels);
     auto output = op->getOutput(SmvConvolutionOp::Outputs);
     TilingConfig tileConfig = TilingOptimizer::computeBasicTileShapes(op);
     TiledTensor tiledInputs =
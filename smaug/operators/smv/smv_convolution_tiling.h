@@ -60,6 +60,28 @@ class TilingOptimizer : public TilingOptimizerBase {
             Tensor* outputTensor,
             bool copyData = false);
 
+    /**
+     * Determine the number of 4x4 output tiles that each block of the
+     * Winograd F(4x4, 3x3) convolution transforms at once.
+     *
+     * Rather than the scratchpads, the limit is the footprint of the
+     * transformed tiles: every tile is expanded to 6x6 points for each input
+     * channel and each output channel, held in fp32. A block is as large as
+     * fits in kWinogradWorkspaceSize, and no larger than an even split of all
+     * the tiles across the op's cores.
+     */
+    static int computeWinogradTilesPerBlock(SmvConvolutionOp* op);
+
+    /**
+     * Determine the cache blocking of a pointwise (1x1, stride 1)
+     * convolution, which runs as a GEMM of the pixels of the inputs with the
+     * transposed kernels.
+     *
+     * This is the blocking of computeGemmBlocking(), with blocks of pixels
+     * no larger than an even split of all the pixels across the op's cores.
+     */
+    static GemmBlocking computePointwiseGemmBlocking(SmvConvolutionOp* op);
+
    protected:
     /**
      * Determine the best tiling dimensions for running convolution on SMV.
@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <cmath>
+
+#include "smaug/core/backend.h"
+#include "smaug/core/globals.h"
+#include "smaug/operators/common.h"
+#include "smaug/operators/smv/kernels/cpu_kernels.h"
+#include "smaug/operators/smv/smv_depthwise_convolution_op.h"
+#include "smaug/operators/smv/smv_depthwise_convolution_tiling.h"
+#include "smaug/operators/smv/smv_kernels.h"
+#include "smaug/operators/smv/smv_accel_pool.h"
+#include "smaug/operators/smv/smv_perf_model.h"
+#include "smaug/utility/debug_stream.h"
+#include "smaug/utility/thread_pool.h"
+
+namespace smaug {
+namespace smv {
+namespace dwconv {
+
+const int kVectorSize = 8;
+
+}  // namespace dwconv
+}  // namespace smv
+
+// The tiles are iterated in the following order:
+// 1) N: batch-wise tiles in the inputs.
+// 2) H: rowwise tiles in the inputs.
+// 3) C: channelwise tiles in the inputs/weights/outputs.
+// Since every channel is convolved independently, all of the tile triplets
+// are independent from each other and can run in any order.
+void SmvDepthwiseConvolutionOp::runNHWC(TiledTensor& inputs,
+                                        TiledTensor& weights,
+                                        TiledTensor& outputs) {
+    int inputIfmapTiles = inputs.getShape()[0];
+    int inputRowTiles = inputs.getShape()[1];
+    int inputChanTiles = inputs.getShape()[3];
+    int weightChanTiles = weights.getShape()[3];
+    int outputRowTiles = outputs.getShape()[1];
+    int outputChanTiles = outputs.getShape()[3];
+    assert(inputChanTiles == weightChanTiles &&
+           inputChanTiles == outputChanTiles &&
+           "The inputs, weights and outputs must be tiled with the same "
+           "channels!");
+    auto inputIdx = inputs.startIndex();
+    auto weightIdx = weights.startIndex();
+    auto outputIdx = outputs.startIndex();
+    std::vector<int> inputPadding = getInputPadding();
+    int topPad = inputPadding[0];
+    int bottomPad = inputPadding[1];
+    int leftPad = inputPadding[2];
+    int rightPad = inputPadding[3];
+
+    std::vector<TileJob> jobs;
+    for (int N = 0; N < inputIfmapTiles; N++) {
+        for (int H = 0; H < outputRowTiles; H++) {
+            int currentTileTopPad = topPad;
+            int currentTileBottomPad = bottomPad;
+            if (inputRowTiles > 1) {
+                if (H == 0) {
+                    currentTileBottomPad = 0;
+                } else if (H == inputRowTiles - 1) {
+                    currentTileTopPad = 0;
+                } else {
+                    currentTileTopPad = 0;
+                    currentTileBottomPad = 0;
+                }
+            }
+            for (int C = 0; C < inputChanTiles; C++) {
+                int inputTileIdx = inputIdx(N, H, 0, C);
+                int weightTileIdx = weightIdx(0, 0, 0, C);
+                int outputTileIdx = outputIdx(N, H, 0, C);
+                dout(1) << "Input: " << inputTileIdx
+                        << ", weights: " << weightTileIdx
+                        << ", output: " << outputTileIdx << "\n";
+                TileJob job = { inputs.getTileWithData(inputTileIdx),
+                                weights.getTileWithData(weightTileIdx),
+                                outputs[outputTileIdx],
+                                weightTileIdx,
+                                { currentTileTopPad, currentTileBottomPad,
+                                  leftPad, rightPad } };
+                recordTileTransfer(job.inputs);
+                recordTileTransfer(job.weights);
+                recordTileTransfer(job.outputs);
+                jobs.push_back(job);
+            }
+        }
+    }
+
+    if (backEnd == Cpu) {
+        int numThreads = 1;
+        if (!fastForwardMode && threadPool)
+            numThreads = std::min(numCores, threadPool->size());
+        if (numThreads <= 1 || jobs.size() == 1) {
+            runCpuJobs(jobs, 0, jobs.size());
+            return;
+        }
+        int numJobsPerThread = std::ceil(jobs.size() * 1.0 / numThreads);
+        int remainingJobs = jobs.size();
+        while (remainingJobs > 0) {
+            int numJobs = std::min(numJobsPerThread, remainingJobs);
+            auto args = new CpuWorkerArgs{ this, &jobs,
+                                           (int)jobs.size() - remainingJobs,
+                                           numJobs };
+            int cpuid = threadPool->dispatchThread(cpuWorker, (void*)args);
+            assert(cpuid != -1 && "Failed to dispatch thread!");
+            remainingJobs -= numJobs;
+        }
+        threadPool->joinThreadPool();
+        return;
+    }
+
+    SmvAcceleratorPool accelPool(numCores);
+    std::vector<int> lastReadWeightTileIdx(numCores, -1);
+    for (int i = 0; i < numCores; i++) {
+        setArrayMemTypeIfSimulating(
+                smv::kConvolutionHw + i, "host_inputs", getInputsMemType());
+        setArrayMemTypeIfSimulating(
+                smv::kConvolutionHw + i, "host_weights", getWeightsMemType());
+        setArrayMemTypeIfSimulating(
+                smv::kConvolutionHw + i, "host_results", getOutputsMemType());
+    }
+    int currAccelIdx = 0;
+    for (auto& job : jobs) {
+        const TensorShape& inputShape = job.inputs->getShape();
+        const TensorShape& weightsShape = job.weights->getShape();
+        const TensorShape& outputShape = job.outputs->getShape();
+        int inputDims[4] = { inputShape[0], inputShape[1], inputShape[2],
+                             inputShape[3] };
+        int weightsDims[4] = { weightsShape[0], weightsShape[1],
+                               weightsShape[2], weightsShape[3] };
+        int outputDims[4] = { outputShape[0], outputShape[1], outputShape[2],
+                              outputShape[3] };
+        bool readWeights = false;
+        if (job.weightTileIdx != lastReadWeightTileIdx[currAccelIdx]) {
+            readWeights = true;
+            lastReadWeightTileIdx[currAccelIdx] = job.weightTileIdx;
+        }
+        std::unique_ptr<volatile int> finishFlag;
+        if (isEstimating()) {
+            // Each output element is a kernel-sized window reduction over a
+            // single channel, which is exactly the pooling cost model.
+            recordKernelEstimate(
+                    currAccelIdx,
+                    smv::model::poolingCycles(inputDims, outputDims,
+                                              getWeightRows(),
+                                              getWeightCols()));
+        } else {
+            unsigned accelId = smv::kConvolutionHw + currAccelIdx;
+            mapArrayToAccel(accelId, "host_inputs",
+                            job.inputs->data<float16>(),
+                            inputShape.storageSize() * sizeof(float16));
+            mapArrayToAccel(accelId, "host_weights",
+                            job.weights->data<float16>(),
+                            weightsShape.storageSize() * sizeof(float16));
+            mapArrayToAccel(accelId, "host_results",
+                            job.outputs->data<float16>(),
+                            outputShape.storageSize() * sizeof(float16));
+            finishFlag = invokeKernelNoBlock(
+                    currAccelIdx, accelId, smv_depthwise_conv_nhwc_vec_fxp,
+                    job.inputs->data<float16>(), job.weights->data<float16>(),
+                    job.outputs->data<float16>(), smv::spad0, smv::spad1,
+                    smv::spad2, inputDims, weightsDims, outputDims,
+                    inputShape.getPadding(3), weightsShape.getPadding(3),
+                    outputShape.getPadding(3), job.inputHaloPad,
+                    getRowStride(), getColStride(), readWeights,
+                    actInfo.function, actInfo.params, &sampling);
+        }
+        accelPool.addFinishFlag(currAccelIdx, std::move(finishFlag));
+        currAccelIdx = accelPool.getNextAvailableAccelerator(currAccelIdx);
+    }
+    // Before we leave, make sure all the accelerators have finished.
+    accelPool.joinAll();
+}
+
+void SmvDepthwiseConvolutionOp::runCpuJobs(const std::vector<TileJob>& jobs,
+                                           int start,
+                                           int numJobs) {
+    float* a = (float*)smaug::malloc_aligned(memSize * 2);
+    float* b = (float*)smaug::malloc_aligned(memSize * 2);
+    float* results = (float*)smaug::malloc_aligned(memSize * 2);
+    int lastReadWeightTileIdx = -1;
+    for (int i = start; i < start + numJobs; i++) {
+        const TileJob& job = jobs[i];
+        const TensorShape& inputShape = job.inputs->getShape();
+        const TensorShape& weightsShape = job.weights->getShape();
+        const TensorShape& outputShape = job.outputs->getShape();
+        int inputDims[4] = { inputShape[0], inputShape[1], inputShape[2],
+                             inputShape[3] };
+        int weightsDims[4] = { weightsShape[0], weightsShape[1],
+                               weightsShape[2], weightsShape[3] };
+        int outputDims[4] = { outputShape[0], outputShape[1], outputShape[2],
+                              outputShape[3] };
+        int inputHaloPad[4] = { job.inputHaloPad[0], job.inputHaloPad[1],
+                                job.inputHaloPad[2], job.inputHaloPad[3] };
+        bool readWeights = job.weightTileIdx != lastReadWeightTileIdx;
+        lastReadWeightTileIdx = job.weightTileIdx;
+        smv::getCpuKernels().depthwiseConv(
+                job.inputs->data<float16>(), job.weights->data<float16>(),
+                job.outputs->data<float16>(), a, b, results, inputDims,
+                weightsDims, outputDims, inputShape.getPadding(3),
+                weightsShape.getPadding(3), outputShape.getPadding(3),
+                inputHaloPad, getRowStride(), getColStride(), readWeights,
+                actInfo.function, actInfo.params, &sampling);
+    }
+    free(a);
+    free(b);
+    free(results);
+}
+
+void* SmvDepthwiseConvolutionOp::cpuWorker(void* _args) {
+    auto args = reinterpret_cast<CpuWorkerArgs*>(_args);
+    args->op->runCpuJobs(*args->jobs, args->start, args->numJobs);
+    delete args;
+    return nullptr;
+}
+
+void SmvDepthwiseConvolutionOp::tile() {
+    tiledTensors = smaug::smv::dwconv::TilingOptimizer::doTiling(this);
+}
+
+void SmvDepthwiseConvolutionOp::run() {
+    auto input = getInput(Inputs);
+    auto kernels = getInput(Kernels);
+    auto output = getOutput(Outputs);
+    const TensorShape& inputShape = input->getShape();
+    const TensorShape& kernelShape = kernels->getShape();
+    const TensorShape& outputShape = output->getShape();
+    assert(inputShape.getLayout() == DataLayout::NHWC);
+    assert(kernelShape.getLayout() == DataLayout::NHWC);
+    assert(outputShape.getLayout() == DataLayout::NHWC);
+    dout(2) << *kernels << "\n";
+
+    {
+        auto stats = gem5::ScopedStats(
+                stats::kTensorPrepStart, stats::kTensorPrepEnd);
+        tiledTensors[0].copyDataToAllTiles();
+        tiledTensors[1].copyDataToAllTiles();
+    }
+
+    runNHWC(tiledTensors[0], tiledTensors[1], tiledTensors[2]);
+
+    {
+        auto stats = gem5::ScopedStats(
+                stats::kTensorFinalStart, stats::kTensorFinalEnd);
+        tiledTensors[2].untile();
+    }
+}
+
+}  // namespace smaug
@@ -0,0 +1,68 @@
+#ifndef _OPERATORS_SMV_SMV_DEPTHWISE_CONVOLUTION_OP_H_
+#define _OPERATORS_SMV_SMV_DEPTHWISE_CONVOLUTION_OP_H_
+
+#include "smaug/core/backend.h"
+#include "smaug/operators/common.h"
+#include "smaug/operators/depthwise_convolution_op.h"
+
+namespace smaug {
+
+namespace smv {
+/** Contains depthwise convolution implementations and tiling optimizers. */
+namespace dwconv {
+
+extern const int kVectorSize;
+
+class TilingOptimizer;
+
+}  // namespace dwconv
+}  // namespace smv
+
+/**
+ * SMV backend implementation of depthwise convolution.
+ *
+ * Runs on the convolution accelerator on Smv. On the Cpu backend, the
+ * independent tiles are distributed across the thread pool, up to numCores
+ * workers.
+ */
+class SmvDepthwiseConvolutionOp : public DepthwiseConvolutionOp<SmvBackend> {
+   public:
+    using DepthwiseConvolutionOp<SmvBackend>::DepthwiseConvolutionOp;
+    void tile() override;
+    void run() override;
+    friend class smv::dwconv::TilingOptimizer;
+
+   protected:
+    /** A set of tiles consumed by one kernel invocation. */
+    struct TileJob {
+        Tensor* inputs;
+        Tensor* weights;
+        Tensor* outputs;
+        int weightTileIdx;
+        int inputHaloPad[4];
+    };
+
+    /** Arguments of a worker thread running a range of TileJobs on Cpu. */
+    struct CpuWorkerArgs {
+        SmvDepthwiseConvolutionOp* op;
+        const std::vector<TileJob>* jobs;
+        int start;
+        int numJobs;
+    };
+
+    /** Tiling scheduler for this operator. */
+    void runNHWC(TiledTensor& inputs,
+                 TiledTensor& weights,
+                 TiledTensor& outputs);
+
+    /** Runs TileJobs [start, start + numJobs) on the calling thread. */
+    void runCpuJobs(const std::vector<TileJob>& jobs, int start, int numJobs);
+
+    static void* cpuWorker(void* args);
+
+    std::array<TiledTensor, 3> tiledTensors;
+};
+
+}  // namespace smaug
+
+#endif
@@ -0,0 +1,191 @@
+#include <algorithm>
+
+#include "catch.hpp"
+#include "smaug/core/backend.h"
+#include "smaug/core/backend_config.h"
+#include "smaug/core/globals.h"
+#include "smaug/core/tensor.h"
+#include "smaug/core/smaug_test.h"
+#include "smaug/operators/smv/smv_test_common.h"
+#include "smaug/operators/smv/smv_depthwise_convolution_op.h"
+#include "smaug/operators/smv/smv_depthwise_convolution_tiling.h"
+#include "smaug/utility/thread_pool.h"
+
+using namespace smaug;
+using namespace smaug::smv;
+
+namespace smaug {
+
+class SmvDepthwiseConvolutionOpTest : public SmaugTest {
+   public:
+    using SmaugTest::SmaugTest;
+
+    // The reference depthwise convolution only supports NCHW, so the expected
+    // outputs are computed directly on the NHWC fp32 data here.
+    Tensor* getReferenceOutput(SmvDepthwiseConvolutionOp* convOp) {
+        auto input = convertFp16ToFp32Tensor(convOp->getInput(0), workspace());
+        auto kernels =
+                convertFp16ToFp32Tensor(convOp->getInput(1), workspace());
+        auto output = convOp->getOutput(0);
+        Tensor* expected = new Tensor("expected", output->getShape());
+        expected->allocateStorage<float>();
+        workspace()->addTensor(expected);
+        const TensorShape& inputShape = input->getShape();
+        const TensorShape& outputShape = output->getShape();
+        std::vector<int> padding = convOp->getInputPadding();
+        int rowStride = convOp->getRowStride();
+        int colStride = convOp->getColStride();
+        auto inputPtr = input->data<float>();
+        auto kernelPtr = kernels->data<float>();
+        auto expectedPtr = expected->data<float>();
+        auto inputIdx = input->startIndex();
+        auto kernelIdx = kernels->startIndex();
+        auto expectedIdx = expected->startIndex();
+        for (int n = 0; n < outputShape[0]; n++) {
+            for (int r = 0; r < outputShape[1]; r++) {
+                for (int c = 0; c < outputShape[2]; c++) {
+                    for (int ch = 0; ch < outputShape[3]; ch++) {
+                        float sum = 0;
+                        for (int kr = 0; kr < convOp->getWeightRows(); kr++) {
+                            for (int kc = 0; kc < convOp->getWeightCols();
+                                 kc++) {
+                                int row = r * rowStride - padding[0] + kr;
+                                int col = c * colStride - padding[2] + kc;
+                                if (row < 0 || row >= inputShape[1] ||
+                                    col < 0 || col >= inputShape[2])
+                                    continue;
+                                sum += inputPtr[inputIdx(n, row, col, ch)] *
+                                       kernelPtr[kernelIdx(0, kr, kc, ch)];
+                            }
+                        }
+                        if (convOp->getActivation().function ==
+                            activation_type::RELU)
+                            sum = std::max(sum, 0.0f);
+                        expectedPtr[expectedIdx(n, r, c, ch)] = sum;
+                    }
+                }
+            }
+        }
+        return convertFp32ToFp16Tensor(expected, workspace());
+    }
+
+    void doTest(std::vector<int> inputDims,
+                std::vector<int> kernelDims,
+                BackEndName_t backEnd = Smv,
+                PaddingType padding = SamePadding,
+                std::vector<int> strides = { 1, 1 },
+                ActivationInfo actInfo = ActivationInfo()) {
+        auto convOp = new SmvDepthwiseConvolutionOp("dw_conv", workspace());
+        convOp->setBackEnd(backEnd);
+        convOp->setNumCores(backEnd == Cpu ? 4 : 1);
+        convOp->setMemSize(DEFAULT_MEM_SIZE_SMV);
+        convOp->setNumPEs(DEFAULT_NUM_PE_SMV);
+        convOp->setNumMaccsPerPE(DEFAULT_NUM_MAC_PER_PE_SMV);
+        convOp->setActivation(actInfo);
+        convOp->setStride(strides[0], strides[1]);
+        convOp->setPadding(padding);
+        TensorShape inputShape(inputDims, NHWC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("input", inputShape);
+        inputs->allocateStorage<float16>();
+        workspace()->addTensor(inputs);
+        convOp->setInput(inputs, 0);
+        convOp->setWeightDims(kernelDims[1], kernelDims[2], kernelDims[3]);
+        createAndFillTensorsWithData<float16>(convOp, fillTensorWithRandomData);
+        convOp->tile();
+        convOp->run();
+        auto outputs = convOp->getOutput(0);
+        auto refOutputs = getReferenceOutput(convOp);
+        verifyOutputs<float16>(outputs, refOutputs);
+    }
+};
+
+}  // namespace smaug
+
+TEST_CASE_METHOD(SmvDepthwiseConvolutionOpTest,
+                 "Depthwise convolution tiling",
+                 "[smvdwconv]") {
+    auto convOp = new SmvDepthwiseConvolutionOp("dw_conv", workspace());
+    convOp->setMemSize(DEFAULT_MEM_SIZE_SMV);
+    convOp->setStride(1, 1);
+    convOp->setPadding(SamePadding);
+
+    SECTION("No tiling needed") {
+        TensorShape inputShape({ 1, 8, 8, 32 }, NHWC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("inputs", inputShape);
+        workspace()->addTensor(inputs);
+        convOp->setInput(inputs, 0);
+        convOp->setWeightDims(3, 3, 32);
+        convOp->createAllTensors();
+        allocateAllTensors<float16>(convOp);
+        TilingConfig config =
+                dwconv::TilingOptimizer::computeBasicTileShapes(convOp);
+        REQUIRE(config.inputs == inputShape);
+        REQUIRE(config.weights.dims() == std::vector<int>{ 1, 3, 3, 32 });
+        REQUIRE(config.outputs == inputShape);
+    }
+
+    SECTION("Channelwise and rowwise tiling share the same channels") {
+        TensorShape inputShape(
+                { 1, 48, 48, 256 }, NHWC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("inputs", inputShape);
+        workspace()->addTensor(inputs);
+        convOp->setInput(inputs, 0);
+        convOp->setWeightDims(3, 3, 256);
+        convOp->createAllTensors();
+        allocateAllTensors<float16>(convOp);
+        TilingConfig config =
+                dwconv::TilingOptimizer::computeBasicTileShapes(convOp);
+        REQUIRE(config.inputTilingDims == DimNCH);
+        REQUIRE(config.weightTilingDims == DimNC);
+        REQUIRE(config.inputs.storageSize() * sizeof(float16) <=
+                DEFAULT_MEM_SIZE_SMV);
+        REQUIRE(config.inputs[3] % dwconv::kVectorSize == 0);
+        REQUIRE(config.weights[3] == config.inputs[3]);
+        REQUIRE(config.outputs[3] == config.inputs[3]);
+    }
+}
+
+TEST_CASE_METHOD(SmvDepthwiseConvolutionOpTest,
+                 "SMV depthwise convolution",
+                 "[smvdwconv]") {
+    SECTION("No tiling") { doTest({ 1, 8, 8, 32 }, { 1, 3, 3, 32 }); }
+    SECTION("Channelwise tiling") {
+        doTest({ 1, 16, 16, 256 }, { 1, 3, 3, 256 });
+    }
+    SECTION("Rowwise tiling") { doTest({ 1, 64, 64, 64 }, { 1, 3, 3, 64 }); }
+    SECTION("Rowwise and channelwise tiling") {
+        doTest({ 1, 48, 48, 256 }, { 1, 3, 3, 256 });
+    }
+    SECTION("Stride 2") {
+        doTest({ 1, 32, 32, 64 }, { 1, 3, 3, 64 }, Smv, SamePadding,
+               { 2, 2 });
+    }
+    SECTION("Valid padding") {
+        doTest({ 1, 16, 16, 32 }, { 1, 5, 5, 32 }, Smv, ValidPadding);
+    }
+    SECTION("Channels not a multiple of the vector size") {
+        doTest({ 1, 8, 8, 12 }, { 1, 3, 3, 12 });
+    }
+}
+
+TEST_CASE_METHOD(SmvDepthwiseConvolutionOpTest,
+                 "Cpu depthwise convolution",
+                 "[smvdwconv]") {
+    SECTION("Fused ReLU") {
+        doTest({ 1, 16, 16, 32 }, { 1, 3, 3, 32 }, Cpu, SamePadding, { 1, 1 },
+               ActivationInfo(activation_type::RELU));
+    }
+    SECTION("Multithreaded rowwise and channelwise tiling") {
+        ThreadPool* savedThreadPool = threadPool;
+        bool savedFastForwardMode = fastForwardMode;
+        threadPool = new ThreadPool(4);
+        threadPool->initThreadPool();
+        fastForwardMode = false;
+        doTest({ 2, 64, 64, 64 }, { 1, 3, 3, 64 }, Cpu);
+        doTest({ 1, 32, 32, 64 }, { 1, 3, 3, 64 }, Cpu, SamePadding,
+               { 2, 2 });
+        delete threadPool;
+        threadPool = savedThreadPool;
+        fastForwardMode = savedFastForwardMode;
+    }
+}
@@ -0,0 +1,255 @@
+#include <algorithm>
+
+#include "smaug/core/backend.h"
+#include "smaug/operators/common.h"
+#include "smaug/operators/smv/smv_depthwise_convolution_op.h"
+#include "smaug/operators/smv/smv_depthwise_convolution_tiling.h"
+#include "smaug/utility/debug_stream.h"
+
+namespace smaug {
+namespace smv {
+namespace dwconv {
+
+std::array<TilingDims, 3> TilingOptimizer::determineBestTilingDims(
+        Tensor* inputs, Tensor* weights, int maxTileSize) {
+    const TensorShape& inputsShape = inputs->getShape();
+    const TensorShape& weightsShape = weights->getShape();
+    TilingDims bestInputTilingDims = findBestTilingDims(
+            inputsShape,
+            maxTileSize,
+            { 1, weightsShape[1], inputsShape[2], kVectorSize });
+    assert(!needsWwiseTiling(bestInputTilingDims) &&
+           "Inputs cannot be tiled columnwise!");
+    // The weights are tiled with the same channels as the inputs, so if they
+    // don't fit on their own, the inputs need channelwise tiling too.
+    if (weightsShape.storageSize() > maxTileSize &&
+        !needsCwiseTiling(bestInputTilingDims)) {
+        bestInputTilingDims =
+                needsHwiseTiling(bestInputTilingDims) ? DimNCH : DimNC;
+    }
+    TilingDims bestWeightTilingDims =
+            needsCwiseTiling(bestInputTilingDims) ? DimNC : None;
+    return { bestInputTilingDims, bestWeightTilingDims, bestInputTilingDims };
+}
+
+TilingConfig TilingOptimizer::computeBasicTileShapes(
+        SmvDepthwiseConvolutionOp* op) {
+    Tensor* inputs = op->getInput(op->Inputs);
+    Tensor* weights = op->getInput(op->Kernels);
+    Tensor* outputs = op->getOutput(op->Outputs);
+    int maxTileSize = op->memSize / inputs->getDataTypeSize();
+    std::array<TilingDims, 3> strategies =
+            determineBestTilingDims(inputs, weights, maxTileSize);
+    TilingDims inputTilingDims = strategies[0];
+    TilingDims weightTilingDims = strategies[1];
+    TilingDims outputTilingDims = strategies[2];
+
+    dout(2) << "  Tiling dimensions chosen:\n"
+            << "    input: " << inputTilingDims
+            << ", weight: " << weightTilingDims
+            << ", output: " << outputTilingDims << "\n";
+
+    TensorShape inputsShape = inputs->getShape();
+    TensorShape weightsShape = weights->getShape();
+    TensorShape outputsShape = outputs->getShape();
+
+    // There are three degrees of freedom: N (batch), H (rows) and C
+    // (channels). Only the input tile shapes are enumerated; the weight and
+    // output tile shapes are completely determined by them.
+    std::vector<TensorShape> inputConfigs;
+    if (inputTilingDims == DimN) {
+        std::vector<int> minShape = inputsShape.dims();
+        minShape[0] = 1;
+        enum4DTensorTilingConfigs(inputsShape,
+                                  maxTileSize,
+                                  minShape,
+                                  { 1, 1, 1, 1 },
+                                  inputConfigs);
+    } else if (inputTilingDims == DimNC) {
+        std::vector<int> minShape = inputsShape.dims();
+        minShape[0] = 1;
+        minShape[3] = kVectorSize;
+        enum4DTensorTilingConfigs(inputsShape,
+                                  maxTileSize,
+                                  minShape,
+                                  { 1, 1, 1, kVectorSize },
+                                  inputConfigs);
+    } else if (inputTilingDims == DimNH) {
+        std::vector<int> minShape = inputsShape.dims();
+        minShape[0] = 1;
+        minShape[1] = weightsShape[1];
+        enum4DTensorTilingConfigs(inputsShape,
+                                  maxTileSize,
+                                  minShape,
+                                  { 1, op->getRowStride(), 1, 1 },
+                                  inputConfigs);
+    } else if (inputTilingDims == DimNCH) {
+        std::vector<int> minShape = { 1, weightsShape[1], inputsShape[2],
+                                      kVectorSize };
+        std::vector<int> strides = { 1, op->getRowStride(), 1, kVectorSize };
+        enum4DTensorTilingConfigs(
+                inputsShape, maxTileSize, minShape, strides, inputConfigs);
+    } else {
+        inputConfigs.push_back(inputsShape);
+    }
+    assert(!inputConfigs.empty() && "No tiling configurations found!");
+
+    // Fill in weights and outputs.
+    std::vector<TilingConfig> fullConfigs;
+    for (auto it = inputConfigs.begin(); it != inputConfigs.end(); ++it) {
+        TilingConfig config(*it);
+        config.weights = weightsShape;
+        config.weights[3] = config.inputs[3];
+        config.outputs = outputsShape;
+        config.outputs[0] = config.inputs[0];
+        config.outputs[3] = config.inputs[3];
+        if (needsHwiseTiling(outputTilingDims)) {
+            int padding = op->getPadding() == SamePadding
+                                  ? FRAC_CEIL(config.weights[1] - 1, 2)
+                                  : 0;
+            config.outputs[1] = op->computeOutputDim(config.inputs[1],
+                                                     config.weights[1],
+                                                     op->getRowStride(),
+                                                     padding);
+        }
+        if (config.weights.storageSize() <= maxTileSize &&
+            config.outputs.storageSize() <= maxTileSize) {
+            fullConfigs.push_back(config);
+        }
+    }
+    dout(2) << "  Number of possible tiling configs: " << fullConfigs.size()
+            << "\n";
+    for (auto& config : fullConfigs)
+        dout(2) << "    " << config << "\n";
+    auto maxIt = std::max_element(
+            fullConfigs.begin(),
+            fullConfigs.end(),
+            [](const TilingConfig& c1, const TilingConfig& c2) {
+                return c1.getTotalSize() < c2.getTotalSize();
+            });
+    assert(maxIt != fullConfigs.end() && "Failed to get best tiling config!");
+    // Fill in the tiling dims.
+    maxIt->inputTilingDims = inputTilingDims;
+    maxIt->weightTilingDims = weightTilingDims;
+    maxIt->outputTilingDims = outputTilingDims;
+    return *maxIt;
+}
+
+TiledTensor TilingOptimizer::generateRowwiseOutputTiledTensor(
+        SmvDepthwiseConvolutionOp* op,
+        const TiledTensor& inputTiledTensor,
+        const TensorShape& maxOutputTileSize,
+        Tensor* outputTensor,
+        bool copyData) {
+    const TensorShape& inputShape = inputTiledTensor.getShape();
+    const TensorShape& outputShape = outputTensor->getShape();
+    int weightRows = op->getWeightRows();
+    int weightCols = op->getWeightCols();
+    std::vector<int> inputPadding = op->getInputPadding();
+    int topRowPad = inputPadding[0];
+    int bottomRowPad = inputPadding[1];
+    int leftColPad = inputPadding[2];
+    int rightColPad = inputPadding[3];
+    std::vector<int> numBlocksInDim{ inputShape[0], inputShape[1],
+                                     inputShape[2], inputShape[3] };
+    // Due to stride > 1, there is a case where the last rowwise tile doesn't
+    // have enough rows for convolution. If so, we need to decrease the row
+    // dimension by 1 in the output tiled tensor.
+    int lastTileRows =
+            inputTiledTensor[inputTiledTensor.size() - 1]->getShape()[1];
+    if (lastTileRows + bottomRowPad < weightRows)
+        numBlocksInDim[1]--;
+    TiledTensor outputTiledTensor(
+            TensorShape(numBlocksInDim, inputShape.getLayout()), outputTensor);
+    const int ndims = outputShape.ndims();
+    std::vector<int> currentOrigin(ndims, 0);
+    auto inputIndex = inputTiledTensor.startIndex();
+    auto outputIndex = outputTiledTensor.startIndex();
+    for (int n = 0; n < numBlocksInDim[0]; n++) {
+        for (int h = 0; h < numBlocksInDim[1]; h++) {
+            for (int w = 0; w < numBlocksInDim[2]; w++) {
+                for (int c = 0; c < numBlocksInDim[3]; c++) {
+                    const Tensor* inputTile =
+                            inputTiledTensor[inputIndex(n, h, w, c)];
+                    const TensorShape& inputTileShape = inputTile->getShape();
+                    int effInputRows = inputTileShape[1];
+                    if (h == 0)
+                        effInputRows += topRowPad;
+                    else if (h == numBlocksInDim[1] - 1)
+                        effInputRows += bottomRowPad;
+                    int effInputCols =
+                            inputTileShape[2] + leftColPad + rightColPad;
+                    int outputRows = op->computeOutputDim(effInputRows,
+                                                          weightRows,
+                                                          op->getRowStride(),
+                                                          ValidPadding);
+                    int outputCols = op->computeOutputDim(effInputCols,
+                                                          weightCols,
+                                                          op->getColStride(),
+                                                          ValidPadding);
+                    TensorShape outputTileShape(
+                            { inputTileShape[0], outputRows, outputCols,
+                              inputTileShape[3] },
+                            outputTensor->getShape().getLayout(),
+                            SmvBackend::Alignment);
+                    assert(outputTileShape.storageSize() <=
+                                   maxOutputTileSize.storageSize() &&
+                           "DimNH input tiling results in output tile sizes "
+                           "larger than the max tile size!");
+                    int oi = outputIndex(n, h, w, c);
+                    std::string tileName = op->getName() + ":" +
+                                           outputTensor->getName() +
+                                           "/tile:" + std::to_string((int)oi);
+                    Tensor* outputTile = new Tensor(tileName, outputTileShape);
+                    outputTile->allocateStorage(outputTensor->getDataType());
+                    outputTiledTensor.setTile(
+                            oi, currentOrigin, outputTile, copyData);
+                    for (int i = ndims - 1; i >= 0; i--) {
+                        currentOrigin[i] += outputTileShape[i];
+                        if (currentOrigin[i] >= outputShape[i])
+                            currentOrigin[i] = 0;
+                        else
+                            break;
+                    }
+                }
+            }
+        }
+    }
+    op->getWorkspace()->addTiledTensor(outputTiledTensor);
+    dout(1) << "  Tiled Tensor " << outputTensor->getName() << "(rowwise):\n"
+            << "    original tensor shape: " << outputTensor->getShape() << "\n"
+            << "    number of tiles: " << outputTiledTensor.size() << "\n";
+    return outputTiledTensor;
+}
+
+std::array<TiledTensor, 3> TilingOptimizer::doTiling(
+        SmvDepthwiseConvolutionOp* op) {
+    auto input = op->getInput(SmvDepthwiseConvolutionOp::Inputs);
+    auto kernels = op->getInput(SmvDepthwiseConvolutionOp::Kernels);
+    auto output = op->getOutput(SmvDepthwiseConvolutionOp::Outputs);
+    TilingConfig tileConfig = TilingOptimizer::computeBasicTileShapes(op);
+    TiledTensor tiledInputs =
+            generateTiledTensorWithStrideAndPadding(input,
+                                                    tileConfig.inputs,
+                                                    op,
+                                                    op->getWeightRows(),
+                                                    op->getWeightCols(),
+                                                    op->getRowStride(),
+                                                    op->getColStride(),
+                                                    op->getPadding());
+    // Copy data for the weight tiles since the data is read-only.
+    TiledTensor tiledWeights = generateTiledTensor(
+            kernels, tileConfig.weights, op, /* copyData */ true);
+    TiledTensor tiledOutputs;
+    if (needsHwiseTiling(tileConfig.outputTilingDims)) {
+        tiledOutputs = TilingOptimizer::generateRowwiseOutputTiledTensor(
+                op, tiledInputs, tileConfig.outputs, output);
+    } else {
+        tiledOutputs = generateTiledTensor(output, tileConfig.outputs, op);
+    }
+    return { tiledInputs, tiledWeights, tiledOutputs };
+}
+
+}  // namespace dwconv
+}  // namespace smv
+}  // namespace smaug
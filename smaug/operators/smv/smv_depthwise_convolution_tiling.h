@@ -0,0 +1,78 @@
+#ifndef _OPERATORS_SMV_SMV_DEPTHWISE_CONVOLUTION_TILING_H_
+#define _OPERATORS_SMV_SMV_DEPTHWISE_CONVOLUTION_TILING_H_
+
+#include "smaug/core/backend.h"
+#include "smaug/core/tensor.h"
+#include "smaug/operators/smv/smv_tiling_common.h"
+#include "smaug/operators/smv/smv_tiling_base.h"
+
+namespace smaug {
+
+class SmvDepthwiseConvolutionOp;
+
+namespace smv {
+namespace dwconv {
+
+/**
+ * Tiling optimizer for SMV depthwise convolution kernel.
+ *
+ * Since every channel is convolved independently, the inputs, weights and
+ * outputs are always tiled channelwise together: a tile triplet covers the
+ * same channels in all three tensors. The inputs can additionally be tiled
+ * rowwise, with halo rows shared between neighbouring tiles, in which case
+ * the outputs are tiled rowwise as well.
+ */
+class TilingOptimizer : public TilingOptimizerBase {
+   public:
+    static std::array<TiledTensor, 3> doTiling(SmvDepthwiseConvolutionOp* op);
+
+    /**
+     * Determine the best basic tiling shape for this depthwise convolution
+     * layer.
+     *
+     * Input tile shapes are enumerated along the chosen tiling dimensions
+     * (channels in multiples of kVectorSize, rows in multiples of the row
+     * stride). The weight and output tile shapes follow from each input tile
+     * shape. The TilingConfig that maximizes the total combined size of the
+     * three tiles, with each of them fitting in a scratchpad, is chosen.
+     *
+     * @param op The SMV depthwise convolution operator. All tensors must have
+     * been created with createAllTensors() prior to calling this function.
+     * @returns The TilingConfig that describes the best tiling shapes.
+     */
+    static TilingConfig computeBasicTileShapes(SmvDepthwiseConvolutionOp* op);
+
+    /**
+     * Generates the output TiledTensor for rowwise tiled inputs.
+     *
+     * Because of the halos and the zero-padding on the boundary tiles, the
+     * output tiles do not all have the same number of rows, so each one is
+     * derived from its input tile.
+     */
+    static TiledTensor generateRowwiseOutputTiledTensor(
+            SmvDepthwiseConvolutionOp* op,
+            const TiledTensor& inputTiledTensor,
+            const TensorShape& maxOutputTileSize,
+            Tensor* outputTensor,
+            bool copyData = false);
+
+   protected:
+    /**
+     * Determine the best tiling dimensions for running depthwise convolution
+     * on SMV.
+     *
+     * Only the inputs are considered, plus channelwise tiling if the weights
+     * don't fit; the weights and outputs follow the input tiling.
+     *
+     * @returns A 3-element array of TilingDims enums (inputs, weights,
+     * outputs).
+     */
+    static std::array<TilingDims, 3> determineBestTilingDims(
+            Tensor* inputs, Tensor* weights, int maxTileSize);
+};
+
+}  // namespace dwconv
+}  // namespace smv
+}  // namespace smaug
+
+#endif
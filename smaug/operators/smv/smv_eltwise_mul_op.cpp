@@ -2,6 +2,7 @@
 #include "smaug/core/backend.h"
 #include "smaug/operators/common.h"
 #include "smaug/operators/smv/smv_kernels.h"
+#include "smaug/operators/smv/smv_perf_model.h"
 #include "smaug/operators/smv/smv_unary_op_common.h"
 #include "smaug/utility/debug_stream.h"
 
@@ -36,7 +37,15 @@ void SmvEltwiseMulOp::runX(TiledTensor& inputs0,
         mapArrayToAccel(smv::kEltwiseOpHw, "host_results",
                         outputTile->data<float16>(),
                         outputShape.storageSize() * sizeof(float16));
+        recordTileTransfer(input0Tile);
+        recordTileTransfer(input1Tile);
+        recordTileTransfer(outputTile);
 
+        if (isEstimating()) {
+            recordKernelEstimate(
+                    0, smv::model::vectorCycles(inputShape.storageSize()));
+            continue;
+        }
         invokeKernel(smv::kEltwiseOpHw, smv_eltwise_mul_nc_vec_fxp,
                      input0Tile->data<float16>(), input1Tile->data<float16>(),
                      outputTile->data<float16>(), smv::spad0, smv::spad1,
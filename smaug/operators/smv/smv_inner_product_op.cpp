@@ -1,17 +1,26 @@
+#include <algorithm>
+#include <cmath>
+
 #include "smaug/core/backend.h"
+#include "smaug/core/globals.h"
 #include "smaug/operators/common.h"
+#include "smaug/operators/smv/kernels/cpu_kernels.h"
+#include "smaug/operators/smv/kernels/params.h"
 #include "smaug/operators/smv/smv_inner_product_op.h"
 #include "smaug/operators/smv/smv_inner_product_tiling.h"
 #include "smaug/operators/smv/smv_kernels.h"
 #include "smaug/operators/smv/smv_accel_pool.h"
+#include "smaug/operators/smv/smv_perf_model.h"
+#include "smaug/operators/smv/smv_quantize.h"
 #include "smaug/utility/debug_stream.h"
+#include "smaug/utility/thread_pool.h"
 
 namespace smaug {
 namespace smv {
 namespace fc {
 
-const int kNumPEs = 8;
-const int kNumMaccsPerPE = 32;
+const int kNumPEs = NUM_PE_INSTS;
+const int kNumMaccsPerPE = DATA_PE_ALIGNMENT;
 
 }  // namespace fc
 }  // namespace smv
@@ -44,7 +53,10 @@ void SmvInnerProductOp::runNWA(TiledTensor& inputs,
     if (backEnd == Cpu) {
         a = (float*)smaug::malloc_aligned(memSize * 2);
         b = (float*)smaug::malloc_aligned(memSize * 2);
-        results = (float*)smaug::malloc_aligned(memSize * 2);
+        // The int8 tiles hold twice as many elements, each accumulated in an
+        // int32.
+        results = (float*)smaug::malloc_aligned(
+                isQuantized() ? memSize * 4 : memSize * 2);
     }
 
     for (int i = 0; i < numCores; i++) {
@@ -98,9 +110,12 @@ void SmvInnerProductOp::runNWA(TiledTensor& inputs,
                 mapArrayToAccel(smv::kInnerProductHw + currAccelIdx, "host_a",
                                 inputTile->data<float16>(),
                                 inputShape.storageSize() * sizeof(float16));
-                mapArrayToAccel(smv::kInnerProductHw + currAccelIdx, "host_b",
-                                weightsTile->data<float16>(),
-                                weightsShape.storageSize() * sizeof(float16));
+                if (!isQuantized()) {
+                    mapArrayToAccel(
+                            smv::kInnerProductHw + currAccelIdx, "host_b",
+                            weightsTile->data<float16>(),
+                            weightsShape.storageSize() * sizeof(float16));
+                }
 
                 int inputDims[2] = { inputShape[0], inputShape[1] };
                 int weightsDims[2] = { weightsShape[0], weightsShape[1] };
@@ -125,7 +140,18 @@ void SmvInnerProductOp::runNWA(TiledTensor& inputs,
                 bool sendOutputs = (N == inputNumTiles - 1) &&
                                    (W == weightNeuronTiles - 1) &&
                                    (wC == weightActTiles - 1);
-                if (backEnd == Smv){
+                if (readInputs)
+                    recordTileTransfer(inputTile);
+                recordTileTransfer(weightsTile);
+                if (sendOutputs)
+                    recordTileTransfer(outputTile);
+                if (isEstimating()) {
+                    recordKernelEstimate(currAccelIdx,
+                                         smv::model::innerProductCycles(
+                                                 inputDims, weightsDims,
+                                                 numPEs, numMaccsPerPE));
+                    accelPool.addFinishFlag(currAccelIdx, std::move(nullptr));
+                } else if (backEnd == Smv){
                     std::unique_ptr<volatile int> finishFlag = invokeKernelNoBlock(
                             currAccelIdx, smv::kInnerProductHw + currAccelIdx,
                             smv_matrix_multiply_transpose_nc_vec_fxp,
@@ -138,6 +164,19 @@ void SmvInnerProductOp::runNWA(TiledTensor& inputs,
                             accumulate, readInputs, sendOutputs, actInfo.function,
                             actInfo.params, &sampling);
                     accelPool.addFinishFlag(currAccelIdx, std::move(finishFlag));
+                } else if (isQuantized()) {
+                    smv_matrix_multiply_transpose_nc_int8(
+                            inputTile->data<float16>(),
+                            weightsTile->data<int8_t>(),
+                            outputTile->data<float16>(), (int8_t*)a,
+                            (int8_t*)b, (int32_t*)results, inputDims,
+                            weightsDims, outputDims, inputShape.getPadding(1),
+                            weightsShape.getPadding(1),
+                            outputShape.getPadding(1), actStart,
+                            finishedNeurons, accumulate, readInputs,
+                            sendOutputs, inputScale, weightScales.data(),
+                            actInfo.function, actInfo.params);
+                    accelPool.addFinishFlag(currAccelIdx, std::move(nullptr));
                 } else if (backEnd == Cpu){
                     // cpu_inner_product_ab_times_cb_16(
                     //         inputTile->data<float16>(),
@@ -156,7 +195,7 @@ void SmvInnerProductOp::runNWA(TiledTensor& inputs,
                     //         outputShape.getPadding(1), actStart, finishedNeurons,
                     //         accumulate, readInputs, sendOutputs, actInfo.function,
                     //         actInfo.params, &sampling);
-                    smv_matrix_multiply_transpose_nc_vec_fxp(
+                    smv::getCpuKernels().matrixMultiply(
                             inputTile->data<float16>(),
                             weightsTile->data<float16>(),
                             outputTile->data<float16>(), a, b,
@@ -197,10 +236,91 @@ void SmvInnerProductOp::runNWA(TiledTensor& inputs,
     }
 }
 
+void SmvInnerProductOp::runPackedGemm() {
+    // The GEMM reads the untiled tensors in place, so every byte is only
+    // moved once.
+    recordTileTransfer(getInput(Inputs));
+    recordTileTransfer(getInput(Weights));
+    recordTileTransfer(getOutput(Outputs));
+    int numNeurons = getOutput(Outputs)->getShape()[1];
+    int numBlocks = FRAC_CEIL(numNeurons, gemmBlocking.colsPerBlock);
+    int numThreads = 1;
+    if (!fastForwardMode && threadPool)
+        numThreads = std::min(numCores, threadPool->size());
+    if (numThreads <= 1 || numBlocks == 1) {
+        runPackedGemmBlocks(0, numBlocks);
+        return;
+    }
+    int numBlocksPerThread = std::ceil(numBlocks * 1.0 / numThreads);
+    int remainingBlocks = numBlocks;
+    while (remainingBlocks > 0) {
+        int blocks = std::min(numBlocksPerThread, remainingBlocks);
+        auto args = new GemmWorkerArgs{ this, numBlocks - remainingBlocks,
+                                        blocks };
+        int cpuid = threadPool->dispatchThread(gemmWorker, (void*)args);
+        assert(cpuid != -1 && "Failed to dispatch thread!");
+        remainingBlocks -= blocks;
+    }
+    threadPool->joinThreadPool();
+}
+
+void SmvInnerProductOp::runPackedGemmBlocks(int start, int numBlocks) {
+    Tensor* inputs = getInput(Inputs);
+    Tensor* weights = getInput(Weights);
+    Tensor* outputs = getOutput(Outputs);
+    const TensorShape& inputShape = inputs->getShape();
+    const TensorShape& weightsShape = weights->getShape();
+    const TensorShape& outputShape = outputs->getShape();
+    int colStart = start * gemmBlocking.colsPerBlock;
+    int cols = std::min(numBlocks * gemmBlocking.colsPerBlock,
+                        outputShape[1] - colStart);
+    int inputDims[2] = { inputShape[0], inputShape[1] };
+    int weightsDims[2] = { weightsShape[0], weightsShape[1] };
+    int rowsPerBlock = gemmBlocking.rowsPerBlock;
+    int colsPerBlock = gemmBlocking.colsPerBlock;
+    int chansPerBlock = gemmBlocking.chansPerBlock;
+    float* packedA = (float*)smaug::malloc_aligned(
+            rowsPerBlock * chansPerBlock * sizeof(float));
+    float* packedB = (float*)smaug::malloc_aligned(
+            colsPerBlock * chansPerBlock * sizeof(float));
+    float* results = (float*)smaug::malloc_aligned(
+            FRAC_CEIL(inputShape[0], smv::kGemmMR) * smv::kGemmMR *
+            colsPerBlock * sizeof(float));
+    smv::getCpuKernels().packedGemm(
+            inputs->data<float16>(), weights->data<float16>(),
+            outputs->data<float16>(), packedA, packedB, results, inputDims,
+            weightsDims, inputShape.getPadding(1), weightsShape.getPadding(1),
+            outputShape.getPadding(1), 0, inputShape[0], colStart, cols,
+            rowsPerBlock, colsPerBlock, chansPerBlock, actInfo.function,
+            actInfo.params);
+    free(packedA);
+    free(packedB);
+    free(results);
+}
+
+void* SmvInnerProductOp::gemmWorker(void* _args) {
+    auto args = reinterpret_cast<GemmWorkerArgs*>(_args);
+    args->op->runPackedGemmBlocks(args->start, args->numBlocks);
+    delete args;
+    return nullptr;
+}
+
 void SmvInnerProductOp::tile() {
     // This function will tile (if necessary) the input/weight/output tensors
     // of the inner product operator into smaller tensor tiles so that each tile
     // can fit in the corresponding scratchpad of the accelerator.
+    if (isQuantized() && !quantizedWeights) {
+        quantizedWeights = smv::quant::quantizeWeightsPerChannel(
+                getInput(Weights), workspace, weightScales);
+    }
+    if (usePackedGemm()) {
+        // The GEMM blocks the whole tensors for the host caches instead of
+        // tiling them for the scratchpads.
+        gemmBlocking =
+                smaug::smv::fc::TilingOptimizer::computePackedGemmBlocking(
+                        this);
+        return;
+    }
     tiledTensors = smaug::smv::fc::TilingOptimizer::doTiling(this);
 }
 
@@ -216,6 +336,13 @@ void SmvInnerProductOp::run() {
     assert(outputsShape.getLayout() == DataLayout::NC);
     dout(2) << "Inputs for this Op: " << *inputs << "\n";
     dout(2) << "Weights for this Op: " << *weights << "\n";
+    if (isQuantized())
+        inputScale = smv::quant::computeInt8Scale(inputs);
+    if (usePackedGemm()) {
+        runPackedGemm();
+        dout(1) << "Outputs for this Op: " << *outputs << "\n";
+        return;
+    }
 
     {
         auto stats = gem5::ScopedStats(
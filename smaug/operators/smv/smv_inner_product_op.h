@@ -1,9 +1,12 @@
 #ifndef _OPERATORS_SMV_SMV_INNER_PRODUCT_OP_H_
 #define _OPERATORS_SMV_SMV_INNER_PRODUCT_OP_H_
 
+#include <vector>
+
 #include "smaug/core/backend.h"
 #include "smaug/operators/common.h"
 #include "smaug/operators/inner_product_op.h"
+#include "smaug/operators/smv/smv_tiling_common.h"
 
 namespace smaug {
 
@@ -32,10 +35,49 @@ class SmvInnerProductOp : public InnerProductOp<SmvBackend> {
     void run() override;
     friend class smv::fc::TilingOptimizer;
 
+    /**
+     * Returns true if this operator runs the int8 kernel, which is only
+     * implemented for the Cpu backend.
+     */
+    bool isQuantized() const { return useInt8WhenAvailable && backEnd == Cpu; }
+
+    /**
+     * Returns true if this operator runs the packed, cache-blocked GEMM
+     * instead of the accelerator kernel, which is the case for all the fp16
+     * inner products on the Cpu backend.
+     */
+    bool usePackedGemm() const { return backEnd == Cpu && !isQuantized(); }
+
   protected:
    void runNWA(TiledTensor& inputs, TiledTensor& weights, TiledTensor& outputs);
 
+   /** Arguments of a worker thread running a range of GEMM blocks. */
+   struct GemmWorkerArgs {
+       SmvInnerProductOp* op;
+       int start;
+       int numBlocks;
+   };
+
+   /**
+    * Runs the packed GEMM, splitting the neurons into blocks of
+    * gemmBlocking.colsPerBlock that are distributed across the thread pool.
+    */
+   void runPackedGemm();
+   /** Runs GEMM blocks [start, start + numBlocks) on the calling thread. */
+   void runPackedGemmBlocks(int start, int numBlocks);
+   static void* gemmWorker(void* args);
+
    std::array<TiledTensor, 3> tiledTensors;
+
+   /** The int8 copy of the weights, if isQuantized(). */
+   Tensor* quantizedWeights = nullptr;
+   /** The scale of each neuron of quantizedWeights. */
+   std::vector<float> weightScales;
+   /** The scale of the inputs, recomputed on every run. */
+   float inputScale = 1;
+
+   /** The cache blocking of the packed GEMM, if usePackedGemm(). */
+   smv::GemmBlocking gemmBlocking;
 };
 
 }  // namespace smaug
@@ -1,10 +1,18 @@
+#include <chrono>
+#include <iostream>
+
 #include "catch.hpp"
 #include "smaug/core/backend.h"
+#include "smaug/core/backend_config.h"
+#include "smaug/core/globals.h"
 #include "smaug/core/tensor.h"
 #include "smaug/core/smaug_test.h"
 #include "smaug/operators/smv/smv_test_common.h"
 #include "smaug/operators/smv/smv_inner_product_op.h"
 #include "smaug/operators/smv/smv_inner_product_tiling.h"
+#include "smaug/operators/smv/smv_kernels.h"
+#include "smaug/utility/cpu_info.h"
+#include "smaug/utility/thread_pool.h"
 
 using namespace smaug;
 
@@ -73,6 +81,35 @@ class SmvInnerProductOpTest : public SmaugTest {
         auto refOutputs = getReferenceOutput(fcOp);
         verifyOutputs<float16>(outputs, refOutputs);
     }
+
+    void doCpuTest(std::vector<int> inputDims,
+                   int numNeurons,
+                   ActivationInfo actInfo = ActivationInfo()) {
+        auto fcOp = new SmvInnerProductOp("fc", workspace());
+        fcOp->setBackEnd(Cpu);
+        fcOp->setNumCores(4);
+        fcOp->setMemSize(DEFAULT_MEM_SIZE_SMV);
+        fcOp->setNumPEs(DEFAULT_NUM_PE_SMV);
+        fcOp->setNumMaccsPerPE(DEFAULT_NUM_MAC_PER_PE_SMV);
+        fcOp->setActivation(actInfo);
+        TensorShape inputShape(
+                inputDims, DataLayout::NC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("input", inputShape);
+        workspace()->addTensor(inputs);
+        fcOp->setInput(inputs, 0);
+        fcOp->setNumOutputs(numNeurons);
+        inputs->allocateStorage<float16>();
+        createAndFillTensorsWithData<float16>(fcOp, fillTensorWithRandomData);
+        REQUIRE(fcOp->usePackedGemm());
+        fcOp->tile();
+        fcOp->run();
+        // The blocking reorders the accumulation, so compare the values in
+        // fp32 instead of the fp16 bit patterns, which diverge near zero.
+        auto outputs = convertFp16ToFp32Tensor(fcOp->getOutput(0), workspace());
+        auto refOutputs =
+                convertFp16ToFp32Tensor(getReferenceOutput(fcOp), workspace());
+        verifyOutputs<float>(outputs, refOutputs);
+    }
 };
 
 }  // namespace smaug
@@ -117,3 +154,144 @@ TEST_CASE_METHOD(SmvInnerProductOpTest,
         doFusionTest({ 1, 32768 }, 256);
     }
 }
+
+TEST_CASE_METHOD(SmvInnerProductOpTest,
+                 "Cpu packed GEMM inner product",
+                 "[smvfc]") {
+    SECTION("Blocking") {
+        auto fcOp = new SmvInnerProductOp("fc", workspace());
+        fcOp->setBackEnd(Cpu);
+        fcOp->setNumCores(4);
+        TensorShape inputShape(
+                { 2, 4096 }, DataLayout::NC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("input", inputShape);
+        workspace()->addTensor(inputs);
+        fcOp->setInput(inputs, 0);
+        fcOp->setNumOutputs(1000);
+        fcOp->createAllTensors();
+        smv::GemmBlocking blocking =
+                smv::fc::TilingOptimizer::computePackedGemmBlocking(fcOp);
+        // The batch fits in one block, while the neurons are split across
+        // the cores.
+        REQUIRE(blocking.rowsPerBlock == smv::kGemmMR);
+        REQUIRE(blocking.colsPerBlock == 256);
+        REQUIRE(blocking.chansPerBlock % VECTOR_SIZE == 0);
+        REQUIRE(blocking.chansPerBlock <= 4096);
+    }
+    SECTION("Single block") { doCpuTest({ 1, 256 }, 32); }
+    SECTION("Sizes not multiples of the micro-kernel") {
+        doCpuTest({ 5, 1000 }, 100);
+    }
+    SECTION("Channel blocking with fused activation") {
+        doCpuTest({ 3, 4096 }, 128, ActivationInfo(activation_type::ELU));
+    }
+    SECTION("Multithreaded") {
+        ThreadPool* savedThreadPool = threadPool;
+        bool savedFastForwardMode = fastForwardMode;
+        threadPool = new ThreadPool(4);
+        threadPool->initThreadPool();
+        fastForwardMode = false;
+        doCpuTest({ 8, 2048 }, 1000, ActivationInfo(activation_type::RELU));
+        delete threadPool;
+        threadPool = savedThreadPool;
+        fastForwardMode = savedFastForwardMode;
+    }
+}
+
+TEST_CASE_METHOD(SmvInnerProductOpTest,
+                 "Cpu inner product on each instruction set",
+                 "[smvfc]") {
+    CpuIsa savedIsa = getCpuIsa();
+    for (CpuIsa isa : { Sse, Avx2, Avx512 }) {
+        if (isa > getHostCpuIsa())
+            break;
+        INFO("Instruction set: " << getCpuIsaName(isa));
+        REQUIRE(setCpuIsa(isa));
+        doCpuTest({ 5, 1000 }, 100);
+        doCpuTest({ 3, 4096 }, 130, ActivationInfo(activation_type::ELU));
+    }
+    setCpuIsa(savedIsa);
+}
+
+// Not run by default. This compares the packed GEMM with the accelerator
+// kernel, both run untiled on a single thread of the host:
+//   smv_inner_product_op_test "[benchmark]"
+TEST_CASE_METHOD(SmvInnerProductOpTest,
+                 "Cpu packed GEMM benchmark",
+                 "[.][benchmark]") {
+    const int kIters = 10;
+    for (int batch : { 1, 16, 64 }) {
+        int chans = 1024, neurons = 1024;
+        TensorShape inputShape(
+                { batch, chans }, DataLayout::NC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("input", inputShape);
+        workspace()->addTensor(inputs);
+        auto fcOp = new SmvInnerProductOp("fc", workspace());
+        fcOp->setInput(inputs, 0);
+        fcOp->setNumOutputs(neurons);
+        inputs->allocateStorage<float16>();
+        createAndFillTensorsWithData<float16>(fcOp, fillTensorWithRandomData);
+        Tensor* weights = fcOp->getInput(1);
+        Tensor* outputs = fcOp->getOutput(0);
+        const TensorShape& weightsShape = weights->getShape();
+        const TensorShape& outputShape = outputs->getShape();
+        int inputDims[2] = { batch, chans };
+        int weightsDims[2] = { neurons, chans };
+        int outputDims[2] = { batch, neurons };
+        double flops = 2.0 * batch * chans * neurons * kIters;
+
+        float* a = (float*)malloc_aligned(inputShape.storageSize() * 4);
+        float* b = (float*)malloc_aligned(weightsShape.storageSize() * 4);
+        float* results = (float*)malloc_aligned(outputShape.storageSize() * 4);
+        SamplingInfo sampling = { NoSampling, 0 };
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kIters; i++) {
+            smv_matrix_multiply_transpose_nc_vec_fxp(
+                    inputs->data<float16>(), weights->data<float16>(),
+                    outputs->data<float16>(), a, b, results, inputDims,
+                    weightsDims, outputDims, inputShape.getPadding(1),
+                    weightsShape.getPadding(1), outputShape.getPadding(1), 0,
+                    0, false, true, true, activation_type::NO_ACTIVATION,
+                    activation_param_t(), &sampling);
+        }
+        std::chrono::duration<double> baseline =
+                std::chrono::steady_clock::now() - start;
+        auto expected = convertFp16ToFp32Tensor(outputs, workspace());
+        free(a);
+        free(b);
+        free(results);
+
+        smv::GemmBlocking blocking =
+                smv::computeGemmBlocking(batch, neurons, chans);
+        float* packedA = (float*)malloc_aligned(
+                blocking.rowsPerBlock * blocking.chansPerBlock * 4);
+        float* packedB = (float*)malloc_aligned(
+                blocking.colsPerBlock * blocking.chansPerBlock * 4);
+        results = (float*)malloc_aligned(FRAC_CEIL(batch, smv::kGemmMR) *
+                                         smv::kGemmMR *
+                                         blocking.colsPerBlock * 4);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kIters; i++) {
+            smv_packed_gemm_transpose_nc_vec_fxp(
+                    inputs->data<float16>(), weights->data<float16>(),
+                    outputs->data<float16>(), packedA, packedB, results,
+                    inputDims, weightsDims, inputShape.getPadding(1),
+                    weightsShape.getPadding(1), outputShape.getPadding(1), 0,
+                    batch, 0, neurons, blocking.rowsPerBlock,
+                    blocking.colsPerBlock, blocking.chansPerBlock,
+                    activation_type::NO_ACTIVATION, activation_param_t());
+        }
+        std::chrono::duration<double> packed =
+                std::chrono::steady_clock::now() - start;
+        free(packedA);
+        free(packedB);
+        free(results);
+
+        std::cout << "Batch " << batch << ", " << chans << " x " << neurons
+                  << ": accelerator kernel "
+                  << flops / baseline.count() / 1e9 << " GFLOP/s, packed GEMM "
+                  << flops / packed.count() / 1e9 << " GFLOP/s\n";
+        verifyOutputs<float>(
+                convertFp16ToFp32Tensor(outputs, workspace()), expected);
+    }
+}
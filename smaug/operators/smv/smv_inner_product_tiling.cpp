@@ -37,7 +37,9 @@ TilingConfig TilingOptimizer::computeBasicTileShapes(SmvInnerProductOp* op) {
     Tensor* weights = op->getInput(op->Weights);
     Tensor* outputs = op->getOutput(op->Outputs);
     // int maxTileSize = SmvBackend::SpadSize() / inputs->getDataTypeSize();
-    int maxTileSize = op->memSize / inputs->getDataTypeSize();
+    int elementSize =
+            op->isQuantized() ? sizeof(int8_t) : inputs->getDataTypeSize();
+    int maxTileSize = op->memSize / elementSize;
     std::array<TilingDims, 3> strategies =
             determineBestTilingDims(op, inputs, weights, outputs, maxTileSize);
     TilingDims inputTilingDims = strategies[0];
@@ -196,9 +198,27 @@ TilingConfig TilingOptimizer::computeBasicTileShapes(SmvInnerProductOp* op) {
     return *maxIt;
 }
 
+GemmBlocking TilingOptimizer::computePackedGemmBlocking(
+        SmvInnerProductOp* op) {
+    const TensorShape& inputShape =
+            op->getInput(SmvInnerProductOp::Inputs)->getShape();
+    const TensorShape& outputShape =
+            op->getOutput(SmvInnerProductOp::Outputs)->getShape();
+    GemmBlocking blocking = computeGemmBlocking(
+            inputShape[0], outputShape[1], inputShape.getStorageDim(1));
+    // The blocks of neurons are distributed across the cores.
+    int colsPerCore = FRAC_CEIL(outputShape[1], std::max(1, op->numCores));
+    blocking.colsPerBlock =
+            std::min(blocking.colsPerBlock,
+                     FRAC_CEIL(colsPerCore, kGemmNR) * kGemmNR);
+    return blocking;
+}
+
 std::array<TiledTensor, 3> TilingOptimizer::doTiling(SmvInnerProductOp* op) {
     auto input = op->getInput(SmvInnerProductOp::Inputs);
-    auto kernels = op->getInput(SmvInnerProductOp::Weights);
+    // The quantized copy of the weights is tiled in place of the original.
+    auto kernels = op->isQuantized() ? op->quantizedWeights
+                                     : op->getInput(SmvInnerProductOp::Weights);
     auto output = op->getOutput(SmvInnerProductOp::Outputs);
     TilingConfig tileConfig = TilingOptimizer::computeBasicTileShapes(op);
     TiledTensor tiledInputs =
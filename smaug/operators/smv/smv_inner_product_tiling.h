@@ -46,6 +46,15 @@ class TilingOptimizer : public TilingOptimizerBase {
      */
     static TilingConfig computeBasicTileShapes(SmvInnerProductOp* op);
 
+    /**
+     * Determine the cache blocking of the packed GEMM on the Cpu backend.
+     *
+     * This is the blocking of computeGemmBlocking(), with blocks of neurons
+     * no larger than an even split of all the neurons across the op's cores,
+     * since the batch is usually too small to split.
+     */
+    static GemmBlocking computePackedGemmBlocking(SmvInnerProductOp* op);
+
    protected:
     /**
      * Determine the best tiling dimensions for running inner product on SMV.
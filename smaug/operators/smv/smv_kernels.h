@@ -32,6 +32,26 @@ void smv_conv3d_nhwc_vec_fxp(float16* host_inputs,
                              activation_param_t act_params,
                              SamplingInfo* sampling);
 
+void smv_depthwise_conv_nhwc_vec_fxp(float16* host_inputs,
+                                     float16* host_weights,
+                                     float16* host_results,
+                                     float* inputs,
+                                     float* weights,
+                                     float* results,
+                                     int inputs_dims[4],
+                                     int weights_dims[4],
+                                     int results_dims[4],
+                                     int inputs_align_pad,
+                                     int weights_pad,
+                                     int results_pad,
+                                     int inputs_halo_pad[4],
+                                     int row_stride,
+                                     int col_stride,
+                                     bool read_weights,
+                                     activation_type act_function,
+                                     activation_param_t act_params,
+                                     SamplingInfo* sampling);
+
 void smv_matrix_multiply_transpose_nc_vec_fxp(float16* host_a,
                                               float16* host_b,
                                               float16* host_results,
@@ -83,6 +103,15 @@ void smv_avgpooling_nhwc_vec_fxp(float16* host_inputs,
                                  int ofmap_start,
                                  SamplingInfo* sampling);
 
+void smv_global_avgpooling_nhwc_vec_fxp(float16* host_inputs,
+                                        float* inputs,
+                                        float* results,
+                                        int inputs_dims[4],
+                                        int inputs_pad,
+                                        int pixel_start,
+                                        int num_pixels,
+                                        int block_pixels);
+
 void smv_batch_norm_post_fc_nc_vec_fxp(float16* host_inputs,
                                        float16* host_weights,
                                        float16* host_results,
@@ -126,6 +155,37 @@ void smv_batch_norm_post_conv_nhwc_vec_fxp(float16* host_inpits,
                                            activation_param_t act_params,
                                            SamplingInfo* sampling);
 
+void smv_batch_norm_scale_shift_post_fc_nc_vec_fxp(
+        float16* host_inputs,
+        float* host_weights,
+        float16* host_results,
+        float* inputs,
+        float* weights,
+        float* results,
+        int inputs_dims[2],
+        int weights_acts,
+        int inputs_pad,
+        int inputs_start,
+        int send_results,
+        activation_type act_function,
+        activation_param_t act_params);
+
+void smv_batch_norm_scale_shift_post_conv_nhwc_vec_fxp(
+        float16* host_inputs,
+        float* host_weights,
+        float16* host_results,
+        float* inputs,
+        float* weights,
+        float* results,
+        int inputs_dims[4],
+        int weights_chans,
+        int inputs_pad,
+        int weights_pad,
+        int weights_start,
+        activation_type act_function,
+        activation_param_t act_params,
+        SamplingInfo* sampling);
+
 void smv_activation_fun_nc_vec_fxp(float16* host_inputs,
                                    float16* host_results,
                                    float* inputs,
@@ -142,6 +202,23 @@ void smv_softmax_nc_vec_fxp(float16* host_inputs,
                             int input_size,
                             int input_pad);
 
+void smv_softmax_stats_nc_vec_fxp(float16* host_inputs,
+                                  float* inputs,
+                                  float* stats,
+                                  int input_num,
+                                  int input_size,
+                                  int input_pad,
+                                  bool init_stats);
+
+void smv_softmax_normalize_nc_vec_fxp(float16* host_inputs,
+                                      float16* host_results,
+                                      float* inputs,
+                                      float* results,
+                                      float* stats,
+                                      int input_num,
+                                      int input_size,
+                                      int input_pad);
+
 void smv_eltwise_add_nc_vec_fxp(float16* host_inputs0,
                                 float16* host_inputs1,
                                 float16* host_results,
@@ -189,6 +266,111 @@ void smv_greater_equal_nc_vec_fxp(float16* host_inputs0,
                                   float* inputs1,
                                   bool* results,
                                   int inputs_size);
+
+void smv_conv3d_nhwc_int8(float16* host_inputs,
+                          int8_t* host_weights,
+                          float16* host_results,
+                          int8_t* inputs,
+                          int8_t* weights,
+                          int32_t* results,
+                          int inputs_dims[4],
+                          int weights_dims[4],
+                          int results_dims[4],
+                          int inputs_align_pad,
+                          int weights_pad,
+                          int results_pad,
+                          int inputs_halo_pad[4],
+                          int row_stride,
+                          int col_stride,
+                          int ifmap_start,
+                          int kern_start,
+                          bool accumulate,
+                          bool read_inputs,
+                          bool read_weights,
+                          bool send_results,
+                          float input_scale,
+                          const float* weight_scales,
+                          activation_type act_function,
+                          activation_param_t act_params);
+
+void smv_matrix_multiply_transpose_nc_int8(float16* host_a,
+                                           int8_t* host_b,
+                                           float16* host_results,
+                                           int8_t* a,
+                                           int8_t* b,
+                                           int32_t* results,
+                                           int a_dims[2],
+                                           int b_dims[2],
+                                           int results_dims[2],
+                                           int a_pad,
+                                           int b_pad,
+                                           int results_pad,
+                                           int a_start,
+                                           int result_start,
+                                           bool accumulate,
+                                           bool read_inputs,
+                                           bool send_results,
+                                           float input_scale,
+                                           const float* weight_scales,
+                                           activation_type act_function,
+                                           activation_param_t act_params);
+
+void smv_winograd_filter_transform_f4x4_3x3(float16* host_weights,
+                                            float* weights,
+                                            float* transformed,
+                                            int weights_dims[4],
+                                            int weights_pad);
+
+void smv_winograd_input_transform_f4x4_3x3(float16* host_inputs,
+                                           float* patch,
+                                           float* transformed,
+                                           int inputs_dims[4],
+                                           int inputs_pad,
+                                           int inputs_halo_pad[4],
+                                           int tile_start,
+                                           int num_tiles,
+                                           int tile_rows,
+                                           int tile_cols);
+
+void smv_winograd_batched_gemm(float* transformed_inputs,
+                               float* transformed_weights,
+                               float* transformed_results,
+                               int num_tiles,
+                               int chans,
+                               int kernels);
+
+void smv_winograd_output_transform_f4x4_3x3(float* transformed_results,
+                                            float* patch,
+                                            float16* host_results,
+                                            int results_dims[4],
+                                            int results_pad,
+                                            int tile_start,
+                                            int num_tiles,
+                                            int tile_rows,
+                                            int tile_cols,
+                                            activation_type act_function,
+                                            activation_param_t act_params);
+
+void smv_packed_gemm_transpose_nc_vec_fxp(float16* host_a,
+                                          float16* host_b,
+                                          float16* host_results,
+                                          float* packed_a,
+                                          float* packed_b,
+                                          float* results,
+                                          int a_dims[2],
+                                          int b_dims[2],
+                                          int a_pad,
+                                          int b_pad,
+                                          int results_pad,
+                                          int row_start,
+                                          int num_rows,
+                                          int col_start,
+                                          int num_cols,
+                                          int row_block,
+                                          int col_block,
+                                          int chan_block,
+                                          activation_type act_function,
+                                          activation_param_t act_params);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,54 @@
+#include "smaug/operators/smv/smv_perf_model.h"
+
+namespace smaug {
+namespace smv {
+namespace model {
+
+namespace {
+
+int64_t ceilDiv(int64_t a, int64_t b) { return (a + b - 1) / b; }
+
+}  // namespace
+
+int64_t convCycles(const int inputDims[4],
+                   const int weightsDims[4],
+                   const int outputDims[4],
+                   int numPEs,
+                   int numMaccsPerPE) {
+    // The output tile, not the weight tile, determines the number of effective
+    // kernels: the weight tile may be consumed by several invocations (see
+    // kern_start). Likewise, the weight tile gives the effective channels.
+    int64_t kernelBlocks = ceilDiv(outputDims[3], numPEs);
+    int64_t chanBlocks = ceilDiv(weightsDims[3], numMaccsPerPE);
+    int64_t outputPixels =
+            static_cast<int64_t>(outputDims[0]) * outputDims[1] * outputDims[2];
+    return kernelBlocks * weightsDims[1] * weightsDims[2] * chanBlocks *
+           outputPixels;
+}
+
+int64_t innerProductCycles(const int inputDims[2],
+                           const int weightsDims[2],
+                           int numPEs,
+                           int numMaccsPerPE) {
+    int64_t neuronBlocks = ceilDiv(weightsDims[0], numPEs);
+    int64_t actBlocks = ceilDiv(weightsDims[1], numMaccsPerPE);
+    return inputDims[0] * neuronBlocks * actBlocks;
+}
+
+int64_t poolingCycles(const int inputDims[4],
+                      const int outputDims[4],
+                      int poolRowSize,
+                      int poolColSize) {
+    int64_t chanBlocks = ceilDiv(inputDims[3], kVectorSize);
+    int64_t outputPixels =
+            static_cast<int64_t>(outputDims[0]) * outputDims[1] * outputDims[2];
+    return outputPixels * chanBlocks * poolRowSize * poolColSize;
+}
+
+int64_t vectorCycles(int64_t numElems, int numPasses) {
+    return numPasses * ceilDiv(numElems, kVectorSize);
+}
+
+}  // namespace model
+}  // namespace smv
+}  // namespace smaug
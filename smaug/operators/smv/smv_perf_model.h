@@ -0,0 +1,64 @@
+#ifndef _OPERATORS_SMV_SMV_PERF_MODEL_H_
+#define _OPERATORS_SMV_SMV_PERF_MODEL_H_
+
+#include <cstdint>
+
+namespace smaug {
+namespace smv {
+
+/**
+ * Analytical cycle models of the SMV kernels, used by the tile dispatchers in
+ * --estimate mode in place of invoking the kernels.
+ *
+ * Each model counts the iterations of the innermost pipelined loop of the
+ * corresponding kernel in smv/kernels, assuming one iteration per cycle. The
+ * DMA time is not included here; it is derived from the tiles recorded by
+ * Operator::recordTileTransfer(). Fixed per-invocation overheads and the
+ * pipeline fill are left to the calibration factors in backend.cfg.
+ */
+namespace model {
+
+/** The width of the SMV vector datapath. This matches VECTOR_SIZE. */
+constexpr int kVectorSize = 8;
+
+/**
+ * smv_conv3d_nhwc_vec_fxp: each cycle, numPEs output channels consume
+ * numMaccsPerPE input channels at one output pixel.
+ */
+int64_t convCycles(const int inputDims[4],
+                   const int weightsDims[4],
+                   const int outputDims[4],
+                   int numPEs,
+                   int numMaccsPerPE);
+
+/**
+ * smv_matrix_multiply_transpose_nc_vec_fxp: each cycle, numPEs neurons
+ * consume numMaccsPerPE activations of one input.
+ */
+int64_t innerProductCycles(const int inputDims[2],
+                           const int weightsDims[2],
+                           int numPEs,
+                           int numMaccsPerPE);
+
+/**
+ * smv_{max,avg}pooling_nhwc_vec_fxp: each cycle reduces one vector of
+ * channels of one pooling window element.
+ */
+int64_t poolingCycles(const int inputDims[4],
+                      const int outputDims[4],
+                      int poolRowSize,
+                      int poolColSize);
+
+/**
+ * Elementwise kernels (batch norm, eltwise ops, activation functions): each
+ * cycle processes one vector. numPasses is the number of times the kernel
+ * streams over the data, e.g. 2 for softmax (running max and exp-sum, then
+ * normalize).
+ */
+int64_t vectorCycles(int64_t numElems, int numPasses = 1);
+
+}  // namespace model
+}  // namespace smv
+}  // namespace smaug
+
+#endif
@@ -0,0 +1,128 @@
+#include <cmath>
+
+#include "catch.hpp"
+#include "smaug/core/backend.h"
+#include "smaug/core/backend_config.h"
+#include "smaug/core/perf_estimate.h"
+#include "smaug/core/tensor.h"
+#include "smaug/core/smaug_test.h"
+#include "smaug/operators/smv/smv_test_common.h"
+#include "smaug/operators/smv/smv_convolution_op.h"
+#include "smaug/operators/smv/smv_perf_model.h"
+
+using namespace smaug;
+
+namespace smaug {
+
+class SmvPerfModelTest : public SmaugTest {
+   public:
+    using SmaugTest::SmaugTest;
+
+    SmvConvolutionOp* buildConvOp(std::vector<int> inputDims,
+                                  std::vector<int> kernelDims,
+                                  int numCores) {
+        auto convOp = new SmvConvolutionOp("conv", workspace());
+        convOp->setBackEnd(Smv);
+        convOp->setNumCores(numCores);
+        convOp->setMemSize(DEFAULT_MEM_SIZE_SMV);
+        convOp->setNumPEs(DEFAULT_NUM_PE_SMV);
+        convOp->setNumMaccsPerPE(DEFAULT_NUM_MAC_PER_PE_SMV);
+        convOp->setStride(1, 1);
+        convOp->setPadding(SamePadding);
+        TensorShape inputShape(inputDims, NHWC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("input", inputShape);
+        inputs->allocateStorage<float16>();
+        workspace()->addTensor(inputs);
+        convOp->setInput(inputs, 0);
+        convOp->setWeightDims(kernelDims[1], kernelDims[2], kernelDims[0]);
+        createAndFillTensorsWithData<float16>(convOp, fillTensorWithRandomData);
+        convOp->tile();
+        return convOp;
+    }
+};
+
+}  // namespace smaug
+
+TEST_CASE_METHOD(SmvPerfModelTest, "SMV kernel cycle models", "[smvperf]") {
+    SECTION("Convolution rounds channels up to PE and MACC groups") {
+        int inputDims[4] = { 1, 10, 10, 40 };
+        int weightsDims[4] = { 12, 3, 3, 40 };
+        int outputDims[4] = { 1, 8, 8, 12 };
+        // 2 kernel blocks * 3x3 * 2 channel blocks * 64 output pixels.
+        REQUIRE(smv::model::convCycles(
+                        inputDims, weightsDims, outputDims, 8, 32) ==
+                2 * 9 * 2 * 64);
+        // Doubling the PEs halves the kernel blocks.
+        REQUIRE(smv::model::convCycles(
+                        inputDims, weightsDims, outputDims, 16, 32) ==
+                9 * 2 * 64);
+    }
+
+    SECTION("Inner product and vector kernels") {
+        int inputDims[2] = { 2, 100 };
+        int weightsDims[2] = { 20, 100 };
+        REQUIRE(smv::model::innerProductCycles(inputDims, weightsDims, 8, 32) ==
+                2 * 3 * 4);
+        REQUIRE(smv::model::vectorCycles(17) == 3);
+        REQUIRE(smv::model::vectorCycles(16, 3) == 6);
+    }
+
+    SECTION("Pooling reduces one channel vector per window element") {
+        int inputDims[4] = { 1, 8, 8, 16 };
+        int outputDims[4] = { 1, 4, 4, 16 };
+        REQUIRE(smv::model::poolingCycles(inputDims, outputDims, 2, 2) ==
+                16 * 2 * 4);
+    }
+}
+
+TEST_CASE_METHOD(SmvPerfModelTest, "SMV latency estimation", "[smvperf]") {
+    estimateMode = true;
+    BackEndConfigurator backEndConfig(1, 1);
+
+    SECTION("Single tile convolution") {
+        auto convOp = buildConvOp({ 1, 8, 8, 8 }, { 8, 3, 3, 8 }, 1);
+        convOp->run();
+        const auto& accels = convOp->getAccelEstimates();
+        REQUIRE(accels.size() == 1);
+        REQUIRE(accels[0].numInvocations == 1);
+        REQUIRE(accels[0].computeCycles == 9 * 64);
+        REQUIRE(accels[0].dmaBytes == convOp->getBytesMoved());
+
+        LayerEstimate estimate = getLayerEstimate(convOp, &backEndConfig);
+        REQUIRE(estimate.modeled);
+        // 25.6 GB/s at 1 GHz moves 25.6 bytes per cycle.
+        REQUIRE(estimate.dmaCycles ==
+                std::llround(convOp->getBytesMoved() / 25.6));
+        REQUIRE(estimate.latency == Approx(estimate.getCycles() / 1e9));
+    }
+
+    SECTION("Tiles are distributed round-robin across accelerators") {
+        auto convOp = buildConvOp({ 1, 32, 32, 32 }, { 32, 3, 3, 32 }, 2);
+        convOp->run();
+        const auto& accels = convOp->getAccelEstimates();
+        REQUIRE(accels.size() == 2);
+        REQUIRE(accels[0].numInvocations > 0);
+        REQUIRE(accels[1].numInvocations > 0);
+        REQUIRE(accels[0].dmaBytes + accels[1].dmaBytes ==
+                convOp->getBytesMoved());
+
+        LayerEstimate estimate = getLayerEstimate(convOp, &backEndConfig);
+        REQUIRE(estimate.numAccels == 2);
+        // The layer is as slow as its busiest accelerator.
+        int64_t totalCompute =
+                accels[0].computeCycles + accels[1].computeCycles;
+        REQUIRE(estimate.computeCycles < totalCompute);
+        REQUIRE(estimate.computeCycles >= totalCompute / 2);
+    }
+
+    SECTION("Calibration scales the modeled cycles") {
+        auto convOp = buildConvOp({ 1, 8, 8, 8 }, { 8, 3, 3, 8 }, 1);
+        convOp->run();
+        BackEndConfig* config = backEndConfig.getBackEndConfig(Smv, 0);
+        config->computeCalibration = 2;
+        LayerEstimate estimate = getLayerEstimate(convOp, &backEndConfig);
+        REQUIRE(estimate.computeCycles == 2 * 9 * 64);
+    }
+
+    estimateMode = false;
+}
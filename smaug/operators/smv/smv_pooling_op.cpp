@@ -1,9 +1,17 @@
+#include <algorithm>
+#include <cmath>
+
 #include "smaug/core/backend.h"
+#include "smaug/core/globals.h"
 #include "smaug/operators/common.h"
+#include "smaug/operators/smv/kernels/cpu_kernels.h"
+#include "smaug/operators/smv/kernels/load_store_fp16_data.h"
 #include "smaug/operators/smv/smv_pooling_op.h"
 #include "smaug/operators/smv/smv_pooling_tiling.h"
 #include "smaug/operators/smv/smv_kernels.h"
+#include "smaug/operators/smv/smv_perf_model.h"
 #include "smaug/utility/debug_stream.h"
+#include "smaug/utility/thread_pool.h"
 
 namespace smaug {
 namespace smv {
@@ -21,6 +29,9 @@ const int kVectorSize = 8;
 // 2) H: Rowwise tiles in the inputs.
 // 3) W: column-wise tiles in the inputs.
 // 4) C: Channelwise tiles in the inputs/weights.
+// Only the channelwise tiles of the inputs that share an output tile depend on
+// each other, so on Cpu, the tile pairs are distributed across threads at the
+// granularity of output tiles.
 void SmvPoolingOp::runNHWC(TiledTensor& inputs, TiledTensor& outputs) {
     int inputIfmapTiles = inputs.getShape()[0];
     int inputRowTiles = inputs.getShape()[1];
@@ -29,17 +40,10 @@ void SmvPoolingOp::runNHWC(TiledTensor& inputs, TiledTensor& outputs) {
     int outputChanTiles = outputs.getShape()[3];
     auto inputIdx = inputs.startIndex();
     auto outputIdx = outputs.startIndex();
-    float * a;
-    float * b;
 
-    if (backEnd == Cpu) {
-        a = (float*)smaug::malloc_aligned(memSize * 2);
-        b = (float*)smaug::malloc_aligned(memSize * 2);
-    }
-    setArrayMemTypeIfSimulating(
-            smv::kPoolingHw, "host_inputs", getInputsMemType());
-    setArrayMemTypeIfSimulating(
-            smv::kPoolingHw, "host_results", getOutputsMemType());
+    std::vector<TileJob> jobs;
+    // The indices of the jobs that start a new output tile.
+    std::vector<int> outputTileStarts;
     for (int N = 0; N < inputIfmapTiles; N++) {
         for (int H = 0; H < inputRowTiles; H++) {
             for (int W = 0; W < inputColTiles; W++) {
@@ -57,55 +61,20 @@ void SmvPoolingOp::runNHWC(TiledTensor& inputs, TiledTensor& outputs) {
                             << ", output: " << outputTileIdx << "\n";
                     Tensor* inputTile = inputs.getTileWithData(inputTileIdx);
                     Tensor* outputTile = outputs[outputTileIdx];
-                    const TensorShape& inputShape = inputTile->getShape();
-                    const TensorShape& outputShape = outputTile->getShape();
-                    mapArrayToAccel(smv::kPoolingHw, "host_inputs",
-                                    inputTile->data<float16>(),
-                                    inputShape.storageSize() * sizeof(float16));
-                    mapArrayToAccel(
-                            smv::kPoolingHw, "host_results",
-                            outputTile->data<float16>(),
-                            outputShape.storageSize() * sizeof(float16));
-                    int inputDims[4] = { inputShape[0], inputShape[1],
-                                         inputShape[2], inputShape[3] };
-                    int outputDims[4] = { outputShape[0], outputShape[1],
-                                          outputShape[2], outputShape[3] };
                     // If the input and output tiles belong to the same channel
                     // group, then their data will be loaded at the same time
                     // into the spads, so we start from the beginning of the
                     // tile. Otherwise, we start from the last place we left off
                     // from.
                     int ofmapStart = (iC == oC) ? 0 : ofmapOffset;
-                    if (backEnd == Smv) {
-                        invokeKernel(
-                                smv::kPoolingHw,
-                                opType == MaxPooling ? smv_maxpooling_nhwc_vec_fxp
-                                                    : smv_avgpooling_nhwc_vec_fxp,
-                                inputTile->data<float16>(),
-                                outputTile->data<float16>(), smv::spad0, smv::spad1,
-                                inputDims, outputDims, inputShape.getPadding(3),
-                                outputShape.getPadding(3), getPoolingSize().first,
-                                getPoolingSize().second, getPoolingStride().first,
-                                getPoolingStride().second, ofmapStart, &sampling);
-                    } else if (backEnd == Cpu) {
-                        if (opType == MaxPooling) {
-                            smv_maxpooling_nhwc_vec_fxp(
-                                inputTile->data<float16>(),
-                                outputTile->data<float16>(), a, b,
-                                inputDims, outputDims, inputShape.getPadding(3),
-                                outputShape.getPadding(3), getPoolingSize().first,
-                                getPoolingSize().second, getPoolingStride().first,
-                                getPoolingStride().second, ofmapStart, &sampling);
-                        } else {
-                            smv_avgpooling_nhwc_vec_fxp(
-                                inputTile->data<float16>(),
-                                outputTile->data<float16>(), a, b,
-                                inputDims, outputDims, inputShape.getPadding(3),
-                                outputShape.getPadding(3), getPoolingSize().first,
-                                getPoolingSize().second, getPoolingStride().first,
-                                getPoolingStride().second, ofmapStart, &sampling);
-                        }
-                    }
+                    if (iC == oC)
+                        outputTileStarts.push_back(jobs.size());
+                    jobs.push_back({ inputTile, outputTile, ofmapStart });
+                    recordTileTransfer(inputTile);
+                    // The kernel only sends back the output tile after its
+                    // last channel group.
+                    if (iC == oC || iC == inputChanTiles - 1)
+                        recordTileTransfer(outputTile);
 
                     ofmapOffset += inputTile->getShape()[3];
                     if (inputChanTiles == outputChanTiles) {
@@ -124,13 +93,188 @@ void SmvPoolingOp::runNHWC(TiledTensor& inputs, TiledTensor& outputs) {
         }
     }
 
-    if (backEnd == Cpu){
-        free(a);
-        free(b);
-    }    
+    if (backEnd == Cpu) {
+        dispatchCpuJobs(jobs, outputTileStarts);
+        return;
+    }
+
+    setArrayMemTypeIfSimulating(
+            smv::kPoolingHw, "host_inputs", getInputsMemType());
+    setArrayMemTypeIfSimulating(
+            smv::kPoolingHw, "host_results", getOutputsMemType());
+    for (const TileJob& job : jobs) {
+        const TensorShape& inputShape = job.inputs->getShape();
+        const TensorShape& outputShape = job.outputs->getShape();
+        int inputDims[4] = { inputShape[0], inputShape[1], inputShape[2],
+                             inputShape[3] };
+        int outputDims[4] = { outputShape[0], outputShape[1], outputShape[2],
+                              outputShape[3] };
+        if (isEstimating()) {
+            recordKernelEstimate(
+                    0, smv::model::poolingCycles(inputDims, outputDims,
+                                                 getPoolingSize().first,
+                                                 getPoolingSize().second));
+            continue;
+        }
+        mapArrayToAccel(smv::kPoolingHw, "host_inputs",
+                        job.inputs->data<float16>(),
+                        inputShape.storageSize() * sizeof(float16));
+        mapArrayToAccel(smv::kPoolingHw, "host_results",
+                        job.outputs->data<float16>(),
+                        outputShape.storageSize() * sizeof(float16));
+        invokeKernel(smv::kPoolingHw,
+                     opType == MaxPooling ? smv_maxpooling_nhwc_vec_fxp
+                                          : smv_avgpooling_nhwc_vec_fxp,
+                     job.inputs->data<float16>(), job.outputs->data<float16>(),
+                     smv::spad0, smv::spad1, inputDims, outputDims,
+                     inputShape.getPadding(3), outputShape.getPadding(3),
+                     getPoolingSize().first, getPoolingSize().second,
+                     getPoolingStride().first, getPoolingStride().second,
+                     job.ofmapStart, &sampling);
+    }
+}
+
+void SmvPoolingOp::runCpuJobs(const std::vector<TileJob>& jobs,
+                              int start,
+                              int numJobs) {
+    float* a = (float*)smaug::malloc_aligned(memSize * 2);
+    float* b = (float*)smaug::malloc_aligned(memSize * 2);
+    auto kernel = opType == MaxPooling ? smv::getCpuKernels().maxPooling
+                                       : smv::getCpuKernels().avgPooling;
+    for (int i = start; i < start + numJobs; i++) {
+        const TileJob& job = jobs[i];
+        const TensorShape& inputShape = job.inputs->getShape();
+        const TensorShape& outputShape = job.outputs->getShape();
+        int inputDims[4] = { inputShape[0], inputShape[1], inputShape[2],
+                             inputShape[3] };
+        int outputDims[4] = { outputShape[0], outputShape[1], outputShape[2],
+                              outputShape[3] };
+        kernel(job.inputs->data<float16>(), job.outputs->data<float16>(), a, b,
+               inputDims, outputDims, inputShape.getPadding(3),
+               outputShape.getPadding(3), getPoolingSize().first,
+               getPoolingSize().second, getPoolingStride().first,
+               getPoolingStride().second, job.ofmapStart, &sampling);
+    }
+    free(a);
+    free(b);
+}
+
+bool SmvPoolingOp::isGlobalAvgPooling() {
+    if (backEnd != Cpu || opType != AveragePooling)
+        return false;
+    const TensorShape& inputShape = getInput(Inputs)->getShape();
+    return getPoolingSize().first == inputShape[1] &&
+           getPoolingSize().second == inputShape[2];
+}
+
+// The feature maps are reduced straight from the inputs tensor. Each feature
+// map is split into as many pixel ranges as needed to keep every thread busy,
+// and the partial sums of the ranges are merged once all of them are done.
+void SmvPoolingOp::runGlobalAvgPooling() {
+    Tensor* input = getInput(Inputs);
+    Tensor* output = getOutput(Outputs);
+    const TensorShape& inputShape = input->getShape();
+    int numImages = inputShape[0];
+    int numPixels = inputShape[1] * inputShape[2];
+    int pixelSize = inputShape.getStorageDim(3);
+    assert(output->getShape().getStorageDim(3) == pixelSize &&
+           "The inputs and outputs must have the same channel alignment!");
+    recordTileTransfer(input);
+    recordTileTransfer(output);
+
+    int numThreads = 1;
+    if (!fastForwardMode && threadPool)
+        numThreads = std::min(numCores, threadPool->size());
+    int rangesPerImage =
+            std::min(numPixels, FRAC_CEIL(numThreads, numImages));
+    int pixelsPerRange = FRAC_CEIL(numPixels, rangesPerImage);
+    std::vector<GlobalPoolJob> jobs;
+    std::vector<int> splits;
+    for (int n = 0; n < numImages; n++) {
+        for (int p = 0; p < numPixels; p += pixelsPerRange) {
+            splits.push_back(jobs.size());
+            float* sums = (float*)smaug::malloc_aligned(
+                    pixelSize * sizeof(float), true);
+            jobs.push_back({ n, p, std::min(pixelsPerRange, numPixels - p),
+                             sums });
+        }
+    }
+    dispatchCpuJobs(jobs, splits);
+
+    // The kernels transfer whole cachelines, so the results are padded.
+    float* results = (float*)smaug::malloc_aligned(
+            (numImages * pixelSize + 2 * VECTOR_SIZE) * sizeof(float), true);
+    float scale = 1.0 / numPixels;
+    for (const GlobalPoolJob& job : jobs) {
+        float* imageResults = results + job.image * pixelSize;
+        for (int c = 0; c < pixelSize; c++)
+            imageResults[c] += job.sums[c] * scale;
+        free(job.sums);
+    }
+    host_store_fp16(results, output->data<float16>(), numImages * pixelSize,
+                    0, 0);
+    free(results);
+}
+
+void SmvPoolingOp::runCpuJobs(const std::vector<GlobalPoolJob>& jobs,
+                              int start,
+                              int numJobs) {
+    Tensor* input = getInput(Inputs);
+    const TensorShape& inputShape = input->getShape();
+    int inputDims[4] = { inputShape[0], inputShape[1], inputShape[2],
+                         inputShape[3] };
+    int pixelSize = inputShape.getStorageDim(3);
+    int imageSize = inputShape[1] * inputShape[2] * pixelSize;
+    // Load as many pixels at a time as fit in a scratchpad.
+    int blockPixels =
+            std::max(1, (int)(memSize / (pixelSize * sizeof(float16))));
+    float* a = (float*)smaug::malloc_aligned(
+            (blockPixels * pixelSize + 2 * VECTOR_SIZE) * sizeof(float));
+    for (int i = start; i < start + numJobs; i++) {
+        const GlobalPoolJob& job = jobs[i];
+        smv::getCpuKernels().globalAvgPooling(
+                input->data<float16>() + job.image * imageSize, a, job.sums,
+                inputDims, inputShape.getPadding(3), job.pixelStart,
+                job.numPixels, blockPixels);
+    }
+    free(a);
+}
+
+template <typename Job>
+void SmvPoolingOp::dispatchCpuJobs(const std::vector<Job>& jobs,
+                                   const std::vector<int>& splits) {
+    int numThreads = 1;
+    if (!fastForwardMode && threadPool)
+        numThreads = std::min(numCores, threadPool->size());
+    if (numThreads <= 1 || splits.size() <= 1) {
+        runCpuJobs(jobs, 0, jobs.size());
+        return;
+    }
+    int numSplitsPerThread = std::ceil(splits.size() * 1.0 / numThreads);
+    for (int i = 0; i < splits.size(); i += numSplitsPerThread) {
+        int start = splits[i];
+        int end = i + numSplitsPerThread < splits.size()
+                          ? splits[i + numSplitsPerThread]
+                          : jobs.size();
+        auto args = new CpuWorkerArgs<Job>{ this, &jobs, start, end - start };
+        int cpuid = threadPool->dispatchThread(cpuWorker<Job>, (void*)args);
+        assert(cpuid != -1 && "Failed to dispatch thread!");
+    }
+    threadPool->joinThreadPool();
+}
+
+template <typename Job>
+void* SmvPoolingOp::cpuWorker(void* _args) {
+    auto args = reinterpret_cast<CpuWorkerArgs<Job>*>(_args);
+    args->op->runCpuJobs(*args->jobs, args->start, args->numJobs);
+    delete args;
+    return nullptr;
 }
 
 void SmvPoolingOp::tile() {
+    // A global average pooling on Cpu reads the inputs tensor directly.
+    if (isGlobalAvgPooling())
+        return;
     // This function will tile (if necessary) the input/output tensors
     // of the pooling operator into smaller tensor tiles so that each tile
     // can fit in the corresponding scratchpad of the accelerator.
@@ -144,6 +288,12 @@ void SmvPoolingOp::run() {
     const TensorShape& outputShape = output->getShape();
     assert(inputShape.getLayout() == DataLayout::NHWC);
     assert(outputShape.getLayout() == DataLayout::NHWC);
+    dout(1) << "Running on backend: " << backEnd << "\n";
+
+    if (isGlobalAvgPooling()) {
+        runGlobalAvgPooling();
+        return;
+    }
 
     {
         auto stats = gem5::ScopedStats(
@@ -152,7 +302,6 @@ void SmvPoolingOp::run() {
     }
 
     runNHWC(tiledTensors[0], tiledTensors[1]);
-    dout(1) << "Running on backend: " << backEnd << "\n"; 
 
     {
         auto stats = gem5::ScopedStats(
@@ -1,6 +1,8 @@
 #ifndef _OPERATORS_SMV_SMV_POOLING_OP_H_
 #define _OPERATORS_SMV_SMV_POOLING_OP_H_
 
+#include <vector>
+
 #include "smaug/core/backend.h"
 #include "smaug/operators/common.h"
 #include "smaug/operators/pooling_op.h"
@@ -19,7 +21,15 @@ class TilingOptimizer;
 }  // namespace pool
 }  // namespace smv
 
-/** Base class for SMV pooling oeprators */
+/**
+ * Base class for SMV pooling oeprators
+ *
+ * On the Cpu backend, the tiles of different feature maps, rows and columns
+ * are distributed across the thread pool, up to numCores workers. A global
+ * average pooling, whose window covers the whole feature map, is not tiled at
+ * all on Cpu: the feature maps are streamed from the host and reduced in
+ * place.
+ */
 class SmvPoolingOp : public PoolingOp<SmvBackend> {
    public:
     using PoolingOp<SmvBackend>::PoolingOp;
@@ -28,8 +38,64 @@ class SmvPoolingOp : public PoolingOp<SmvBackend> {
     friend class smv::pool::TilingOptimizer;
 
    protected:
+    /** An input/output tile pair consumed by one kernel invocation. */
+    struct TileJob {
+        Tensor* inputs;
+        Tensor* outputs;
+        int ofmapStart;
+    };
+
+    /**
+     * A range of pixels of one feature map reduced by a global average
+     * pooling, into its own per-channel sums.
+     */
+    struct GlobalPoolJob {
+        int image;
+        int pixelStart;
+        int numPixels;
+        float* sums;
+    };
+
+    /** Arguments of a worker thread running a range of jobs on Cpu. */
+    template <typename Job>
+    struct CpuWorkerArgs {
+        SmvPoolingOp* op;
+        const std::vector<Job>* jobs;
+        int start;
+        int numJobs;
+    };
+
+    /** Tiling scheduler for this operator. */
     void runNHWC(TiledTensor& inputs, TiledTensor& outputs);
 
+    /**
+     * Returns true if this runs as a global average pooling, which the Cpu
+     * backend does without tiling.
+     */
+    bool isGlobalAvgPooling();
+
+    /** Runs a global average pooling on Cpu. */
+    void runGlobalAvgPooling();
+
+    /** Runs TileJobs [start, start + numJobs) on the calling thread. */
+    void runCpuJobs(const std::vector<TileJob>& jobs, int start, int numJobs);
+
+    /** Runs GlobalPoolJobs [start, start + numJobs) on the calling thread. */
+    void runCpuJobs(const std::vector<GlobalPoolJob>& jobs,
+                    int start,
+                    int numJobs);
+
+    /**
+     * Splits jobs across the thread pool. A thread's range of jobs may only
+     * start at one of the given job indices.
+     */
+    template <typename Job>
+    void dispatchCpuJobs(const std::vector<Job>& jobs,
+                         const std::vector<int>& splits);
+
+    template <typename Job>
+    static void* cpuWorker(void* args);
+
     std::array<TiledTensor, 2> tiledTensors;
 };
 
@@ -2,6 +2,8 @@
 #include "smaug/core/backend.h"
 #include "smaug/core/tensor.h"
 #include "smaug/core/smaug_test.h"
+#include "smaug/core/globals.h"
+#include "smaug/utility/thread_pool.h"
 #include "smaug/operators/smv/smv_test_common.h"
 #include "smaug/operators/smv/smv_pooling_op.h"
 #include "smaug/operators/smv/smv_pooling_tiling.h"
@@ -38,7 +40,10 @@ class SmvPoolingOpTest : public SmaugTest {
         return convertFp32ToFp16Tensor(refPoolOp->getOutput(0), workspace());
     }
 
-    void doTest(PoolingOp<SmvBackend>* poolOp, std::vector<int> inputDims) {
+    void doTest(PoolingOp<SmvBackend>* poolOp,
+                std::vector<int> inputDims,
+                BackEndName_t backEnd = Smv) {
+        poolOp->setBackEnd(backEnd);
         TensorShape inputShape(inputDims, NHWC, SmvBackend::Alignment);
         Tensor* inputs = new Tensor("input", inputShape);
         inputs->allocateStorage<float16>();
@@ -125,3 +130,54 @@ TEST_CASE_METHOD(SmvPoolingOpTest, "SMV Tiled Pooling", "[smvpool]") {
     }
 }
 
+
+TEST_CASE_METHOD(SmvPoolingOpTest, "Cpu pooling", "[smvpool]") {
+    ThreadPool* savedThreadPool = threadPool;
+    bool savedFastForwardMode = fastForwardMode;
+    threadPool = new ThreadPool(4);
+    threadPool->initThreadPool();
+    fastForwardMode = false;
+    SECTION("Multithreaded max pooling") {
+        SECTION("Rowwise tiles") {
+            auto poolOp = new SmvMaxPoolingOp("pool", workspace());
+            poolOp->setNumCores(4);
+            poolOp->setPoolingSize(2, 2);
+            poolOp->setPoolingStride(2, 2);
+            doTest(poolOp, { 2, 64, 64, 32 }, Cpu);
+        }
+        SECTION("Channelwise input tiles that share an output tile") {
+            auto poolOp = new SmvMaxPoolingOp("pool", workspace());
+            poolOp->setNumCores(4);
+            poolOp->setPoolingSize(2, 2);
+            poolOp->setPoolingStride(2, 2);
+            doTest(poolOp, { 1, 32, 32, 32 }, Cpu);
+        }
+    }
+    SECTION("Multithreaded average pooling") {
+        auto poolOp = new SmvAvgPoolingOp("pool", workspace());
+        poolOp->setNumCores(4);
+        poolOp->setPoolingSize(2, 2);
+        poolOp->setPoolingStride(2, 2);
+        doTest(poolOp, { 1, 32, 32, 128 }, Cpu);
+    }
+    SECTION("Global average pooling") {
+        int numCores = 1;
+        SECTION("Single thread") { numCores = 1; }
+        SECTION("Multithreaded") { numCores = 4; }
+        auto poolOp = new SmvAvgPoolingOp("pool", workspace());
+        poolOp->setNumCores(numCores);
+        SECTION("Several feature maps") {
+            poolOp->setPoolingSize(7, 7);
+            poolOp->setPoolingStride(1, 1);
+            doTest(poolOp, { 2, 7, 7, 200 }, Cpu);
+        }
+        SECTION("Feature map larger than a scratchpad") {
+            poolOp->setPoolingSize(14, 14);
+            poolOp->setPoolingStride(1, 1);
+            doTest(poolOp, { 1, 14, 14, 1024 }, Cpu);
+        }
+    }
+    delete threadPool;
+    threadPool = savedThreadPool;
+    fastForwardMode = savedFastForwardMode;
+}
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <cmath>
+
+#include "fp16.h"
+#include "smaug/operators/smv/smv_quantize.h"
+
+namespace smaug {
+namespace smv {
+namespace quant {
+
+namespace {
+
+float computeScale(float maxAbs) {
+    return maxAbs > 0 ? maxAbs / kInt8Max : 1;
+}
+
+}  // namespace
+
+float computeInt8Scale(Tensor* tensor) {
+    const float16* data = tensor->data<float16>();
+    float maxAbs = 0;
+    for (int i = 0; i < tensor->getShape().storageSize(); i++)
+        maxAbs = std::max(maxAbs, std::fabs(fp16_ieee_to_fp32_value(data[i])));
+    return computeScale(maxAbs);
+}
+
+Tensor* quantizeWeightsPerChannel(Tensor* weights,
+                                  Workspace* workspace,
+                                  std::vector<float>& scales) {
+    const TensorShape& shape = weights->getShape();
+    Tensor* quantized = new Tensor(weights->getName() + "/int8", shape);
+    workspace->addTensor(quantized);
+    int8_t* dest = quantized->allocateStorage<int8_t>();
+    const float16* src = weights->data<float16>();
+    // The outermost dimension is never padded, so every output channel is a
+    // contiguous run of storage elements (including its alignment padding,
+    // which is zero and stays zero).
+    int numChannels = shape[0];
+    int channelSize = shape.storageSize() / numChannels;
+    scales.resize(numChannels);
+    for (int c = 0; c < numChannels; c++) {
+        const float16* channel = src + c * channelSize;
+        float maxAbs = 0;
+        for (int i = 0; i < channelSize; i++) {
+            maxAbs = std::max(maxAbs,
+                              std::fabs(fp16_ieee_to_fp32_value(channel[i])));
+        }
+        scales[c] = computeScale(maxAbs);
+        for (int i = 0; i < channelSize; i++) {
+            float value = std::round(fp16_ieee_to_fp32_value(channel[i]) /
+                                     scales[c]);
+            value = std::min<float>(std::max<float>(value, -kInt8Max),
+                                    kInt8Max);
+            dest[c * channelSize + i] = static_cast<int8_t>(value);
+        }
+    }
+    return quantized;
+}
+
+}  // namespace quant
+}  // namespace smv
+}  // namespace smaug
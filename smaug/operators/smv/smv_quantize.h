@@ -0,0 +1,48 @@
+#ifndef _OPERATORS_SMV_SMV_QUANTIZE_H_
+#define _OPERATORS_SMV_SMV_QUANTIZE_H_
+
+#include <vector>
+
+#include "smaug/core/tensor.h"
+#include "smaug/core/workspace.h"
+
+namespace smaug {
+namespace smv {
+
+/**
+ * Helpers for the int8 path of the Cpu backend (see useInt8WhenAvailable).
+ *
+ * Quantization is symmetric: a real value x is represented as round(x /
+ * scale), clamped to [-kInt8Max, kInt8Max]. Weights get one scale per output
+ * channel, computed once at tiling time; activations get one scale per
+ * tensor, computed before every run.
+ */
+namespace quant {
+
+constexpr int kInt8Max = 127;
+
+/**
+ * Returns the scale that maps the largest magnitude of an fp16 tensor to
+ * kInt8Max. A tensor of all zeros gets a scale of 1.
+ */
+float computeInt8Scale(Tensor* tensor);
+
+/**
+ * Quantizes an fp16 weight tensor to int8, with one scale per slice of the
+ * outermost dimension (the output channels of convolution kernels, or the
+ * neurons of the transposed inner product weights).
+ *
+ * @param weights The fp16 weights.
+ * @param workspace The new Int8 tensor is added to this workspace.
+ * @param scales Filled with one scale per output channel.
+ * @return The quantized weights, with the same shape as the original.
+ */
+Tensor* quantizeWeightsPerChannel(Tensor* weights,
+                                  Workspace* workspace,
+                                  std::vector<float>& scales);
+
+}  // namespace quant
+}  // namespace smv
+}  // namespace smaug
+
+#endif
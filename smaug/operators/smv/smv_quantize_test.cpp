@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cmath>
+
+#include "catch.hpp"
+#include "fp16.h"
+#include "smaug/core/backend.h"
+#include "smaug/core/backend_config.h"
+#include "smaug/core/tensor.h"
+#include "smaug/core/smaug_test.h"
+#include "smaug/operators/smv/smv_test_common.h"
+#include "smaug/operators/smv/smv_convolution_op.h"
+#include "smaug/operators/smv/smv_inner_product_op.h"
+#include "smaug/operators/smv/smv_quantize.h"
+
+using namespace smaug;
+
+namespace smaug {
+
+class SmvQuantizeTest : public SmaugTest {
+   public:
+    using SmaugTest::SmaugTest;
+
+    void setCpuConfig(Operator* op) {
+        op->setBackEnd(Cpu);
+        op->setNumCores(1);
+        op->setMemSize(DEFAULT_MEM_SIZE_SMV);
+        op->setNumPEs(DEFAULT_NUM_PE_SMV);
+        op->setNumMaccsPerPE(DEFAULT_NUM_MAC_PER_PE_SMV);
+    }
+
+    // Int8 results are compared against the fp32 reference with a tolerance
+    // relative to the largest reference output, since the quantization error
+    // of a dot product scales with the magnitude of its operands rather than
+    // with the magnitude of its result.
+    void verifyQuantizedOutputs(Tensor* output, Tensor* expected) {
+        auto outputPtr = output->data<float16>();
+        auto expectedPtr = expected->data<float>();
+        auto outputIdx = output->startIndex();
+        auto expectedIdx = expected->startIndex();
+        float maxAbs = 0, maxError = 0;
+        for (; !outputIdx.end(); ++outputIdx, ++expectedIdx) {
+            float actual = fp16_ieee_to_fp32_value(outputPtr[outputIdx]);
+            float reference = expectedPtr[expectedIdx];
+            maxAbs = std::max(maxAbs, std::fabs(reference));
+            maxError = std::max(maxError, std::fabs(actual - reference));
+        }
+        REQUIRE(maxAbs > 0);
+        REQUIRE(maxError <= 0.03 * maxAbs);
+    }
+
+    void doConvTest(std::vector<int> inputDims, std::vector<int> kernelDims) {
+        auto convOp = new SmvConvolutionOp("conv", workspace());
+        setCpuConfig(convOp);
+        convOp->setStride(1, 1);
+        convOp->setPadding(SamePadding);
+        TensorShape inputShape(inputDims, NHWC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("input", inputShape);
+        inputs->allocateStorage<float16>();
+        workspace()->addTensor(inputs);
+        convOp->setInput(inputs, 0);
+        convOp->setWeightDims(kernelDims[1], kernelDims[2], kernelDims[0]);
+        createAndFillTensorsWithData<float16>(convOp, fillTensorWithRandomData);
+        convOp->tile();
+        convOp->run();
+
+        auto refConvOp =
+                new ConvolutionOp<ReferenceBackend>("ref_conv", workspace());
+        refConvOp->setPadding(SamePadding);
+        refConvOp->setWeightDims(
+                kernelDims[1], kernelDims[2], kernelDims[0]);
+        refConvOp->setStride(1, 1);
+        refConvOp->setInput(convertFp16ToFp32Tensor(inputs, workspace()), 0);
+        refConvOp->setInput(
+                convertFp16ToFp32Tensor(convOp->getInput(1), workspace()), 1);
+        refConvOp->createAllTensors();
+        refConvOp->getOutput(0)->allocateStorage<float>();
+        refConvOp->run();
+        verifyQuantizedOutputs(convOp->getOutput(0), refConvOp->getOutput(0));
+    }
+
+    void doFcTest(std::vector<int> inputDims, int numNeurons) {
+        auto fcOp = new SmvInnerProductOp("fc", workspace());
+        setCpuConfig(fcOp);
+        TensorShape inputShape(
+                inputDims, DataLayout::NC, SmvBackend::Alignment);
+        Tensor* inputs = new Tensor("input", inputShape);
+        inputs->allocateStorage<float16>();
+        workspace()->addTensor(inputs);
+        fcOp->setInput(inputs, 0);
+        fcOp->setNumOutputs(numNeurons);
+        createAndFillTensorsWithData<float16>(fcOp, fillTensorWithRandomData);
+        fcOp->tile();
+        fcOp->run();
+
+        auto refFcOp =
+                new InnerProductOp<ReferenceBackend>("ref_fc", workspace());
+        refFcOp->setInput(convertFp16ToFp32Tensor(inputs, workspace()), 0);
+        refFcOp->setInput(
+                convertFp16ToFp32Tensor(fcOp->getInput(1), workspace()), 1);
+        refFcOp->setNumOutputs(numNeurons);
+        refFcOp->createAllTensors();
+        refFcOp->getOutput(0)->allocateStorage<float>();
+        refFcOp->run();
+        verifyQuantizedOutputs(fcOp->getOutput(0), refFcOp->getOutput(0));
+    }
+};
+
+}  // namespace smaug
+
+TEST_CASE_METHOD(SmvQuantizeTest, "Int8 quantization", "[smvquant]") {
+    TensorShape shape({ 2, 1, 1, 8 }, NHWC, SmvBackend::Alignment);
+    Tensor* weights = new Tensor("weights", shape);
+    weights->allocateStorage<float16>();
+    workspace()->addTensor(weights);
+    // The first channel spans [-2.54, 2.54], the second one is all zeros.
+    std::vector<float16> values(16, fp16(0));
+    for (int i = 0; i < 8; i++)
+        values[i] = fp16((i % 2 ? -1 : 1) * 0.3175 * (i + 1));
+    weights->fillData(values.data(), values.size());
+
+    SECTION("Per-channel scales map the largest magnitude to 127") {
+        std::vector<float> scales;
+        Tensor* quantized = smv::quant::quantizeWeightsPerChannel(
+                weights, workspace(), scales);
+        REQUIRE(quantized->getDataType() == Int8);
+        REQUIRE(quantized->getShape().dims() == shape.dims());
+        REQUIRE(scales.size() == 2);
+        REQUIRE(scales[0] == Approx(0.3175 * 8 / 127).epsilon(0.001));
+        REQUIRE(scales[1] == 1);
+        const int8_t* data = quantized->data<int8_t>();
+        REQUIRE(data[7] == -127);
+        for (int i = 0; i < 8; i++) {
+            REQUIRE(data[i] * scales[0] ==
+                    Approx(fp16_ieee_to_fp32_value(values[i]))
+                            .margin(scales[0] / 2));
+            REQUIRE(data[8 + i] == 0);
+        }
+    }
+
+    SECTION("Per-tensor activation scale") {
+        REQUIRE(smv::quant::computeInt8Scale(weights) ==
+                Approx(0.3175 * 8 / 127).epsilon(0.001));
+    }
+}
+
+TEST_CASE_METHOD(SmvQuantizeTest, "Int8 Cpu convolution", "[smvquant]") {
+    useInt8WhenAvailable = true;
+    SECTION("No tiling") { doConvTest({ 1, 8, 8, 16 }, { 8, 3, 3, 16 }); }
+    SECTION("Weights tiled by output channels") {
+        doConvTest({ 1, 16, 16, 64 }, { 64, 3, 3, 64 });
+    }
+    SECTION("Channelwise tiling accumulates int32 partial sums") {
+        doConvTest({ 1, 8, 8, 512 }, { 16, 3, 3, 512 });
+    }
+    useInt8WhenAvailable = false;
+}
+
+TEST_CASE_METHOD(SmvQuantizeTest, "Int8 Cpu inner product", "[smvquant]") {
+    useInt8WhenAvailable = true;
+    SECTION("No tiling") { doFcTest({ 1, 256 }, 32); }
+    SECTION("Activation-wise and neuron-wise tiling") {
+        doFcTest({ 2, 1024 }, 64);
+    }
+    useInt8WhenAvailable = false;
+}
@@ -1,5 +1,7 @@
+#include "smaug/operators/smv/kernels/cpu_kernels.h"
 #include "smaug/operators/smv/smv_softmax_op.h"
 #include "smaug/operators/smv/smv_kernels.h"
+#include "smaug/operators/smv/smv_perf_model.h"
 #include "smaug/utility/debug_stream.h"
 
 namespace smaug {
@@ -8,22 +10,104 @@ void SmvSoftmaxOp::tile() {
     auto inputs = getInput(0);
     auto outputs = getOutput(0);
     const TensorShape& shape = inputs->getShape();
-    if (shape.getStorageDim(1) >
-        SmvBackend::SpadSize() / inputs->getDataTypeSize()) {
-        assert(false && "For softmax, a single tile must fit in the local "
-                        "scratchpad size!");
+    int maxTileSize = SmvBackend::SpadSize() / inputs->getDataTypeSize();
+    TensorShape tileShape;
+    if (shape.getStorageDim(1) <= maxTileSize) {
+        // Tile on the N dimension.
+        int maxInputs =
+                std::min(maxTileSize / shape.getStorageDim(1), shape[0]);
+        tileShape = TensorShape(
+                { maxInputs, shape[1] }, DataLayout::NC, SmvBackend::Alignment);
+    } else {
+        // A row does not fit in the scratchpad, so each row is split along C.
+        // The softmax state of a row is merged across its tiles.
+        int maxChans = maxTileSize / SmvBackend::Alignment *
+                       SmvBackend::Alignment;
+        tileShape = TensorShape(
+                { 1, maxChans }, DataLayout::NC, SmvBackend::Alignment);
     }
-    // We can only tile on the N dimension.
-    int maxInputs =
-            std::min(SmvBackend::SpadSize() / inputs->getDataTypeSize() /
-                             shape.getStorageDim(1),
-                     shape[0]);
-    TensorShape tileShape(
-            { maxInputs, shape[1] }, DataLayout::NC, SmvBackend::Alignment);
     tiledTensors[0] = generateTiledTensor(inputs, tileShape, this);
     tiledTensors[1] = generateTiledTensor(outputs, tileShape, this);
 }
 
+void SmvSoftmaxOp::runTile(Tensor* inputTile, Tensor* outputTile) {
+    const TensorShape& inputShape = inputTile->getShape();
+    const TensorShape& outputShape = outputTile->getShape();
+    mapArrayToAccel(smv::kEltwiseOpHw, "host_inputs",
+                    inputTile->data<float16>(),
+                    inputShape.storageSize() * sizeof(float16));
+    mapArrayToAccel(smv::kEltwiseOpHw, "host_results",
+                    outputTile->data<float16>(),
+                    outputShape.storageSize() * sizeof(float16));
+    recordTileTransfer(inputTile);
+    recordTileTransfer(outputTile);
+    if (isEstimating()) {
+        // Softmax streams over each row twice: running max and sum of
+        // exponentials, then normalization.
+        recordKernelEstimate(
+                0, smv::model::vectorCycles(inputShape.storageSize(), 2));
+    } else if (backEnd == Smv) {
+        invokeKernel(smv::kEltwiseOpHw, smv_softmax_nc_vec_fxp,
+                     inputTile->data<float16>(), outputTile->data<float16>(),
+                     smv::spad0, smv::spad1, inputShape[0], inputShape[1],
+                     inputShape.getPadding(1));
+    } else if (backEnd == Cpu) {
+        smv::getCpuKernels().softmax(
+                inputTile->data<float16>(), outputTile->data<float16>(),
+                smv::spad0, smv::spad1, inputShape[0], inputShape[1],
+                inputShape.getPadding(1));
+    }
+}
+
+void SmvSoftmaxOp::runStats(Tensor* inputTile, bool initStats) {
+    const TensorShape& inputShape = inputTile->getShape();
+    mapArrayToAccel(smv::kEltwiseOpHw, "host_inputs",
+                    inputTile->data<float16>(),
+                    inputShape.storageSize() * sizeof(float16));
+    recordTileTransfer(inputTile);
+    if (isEstimating()) {
+        recordKernelEstimate(
+                0, smv::model::vectorCycles(inputShape.storageSize()));
+    } else if (backEnd == Smv) {
+        invokeKernel(smv::kEltwiseOpHw, smv_softmax_stats_nc_vec_fxp,
+                     inputTile->data<float16>(), smv::spad0, smv::spad2,
+                     inputShape[0], inputShape[1], inputShape.getPadding(1),
+                     initStats);
+    } else if (backEnd == Cpu) {
+        smv::getCpuKernels().softmaxStats(
+                inputTile->data<float16>(), smv::spad0, smv::spad2,
+                inputShape[0], inputShape[1], inputShape.getPadding(1),
+                initStats);
+    }
+}
+
+void SmvSoftmaxOp::runNormalize(Tensor* inputTile, Tensor* outputTile) {
+    const TensorShape& inputShape = inputTile->getShape();
+    const TensorShape& outputShape = outputTile->getShape();
+    mapArrayToAccel(smv::kEltwiseOpHw, "host_inputs",
+                    inputTile->data<float16>(),
+                    inputShape.storageSize() * sizeof(float16));
+    mapArrayToAccel(smv::kEltwiseOpHw, "host_results",
+                    outputTile->data<float16>(),
+                    outputShape.storageSize() * sizeof(float16));
+    recordTileTransfer(inputTile);
+    recordTileTransfer(outputTile);
+    if (isEstimating()) {
+        recordKernelEstimate(
+                0, smv::model::vectorCycles(inputShape.storageSize()));
+    } else if (backEnd == Smv) {
+        invokeKernel(smv::kEltwiseOpHw, smv_softmax_normalize_nc_vec_fxp,
+                     inputTile->data<float16>(), outputTile->data<float16>(),
+                     smv::spad0, smv::spad1, smv::spad2, inputShape[0],
+                     inputShape[1], inputShape.getPadding(1));
+    } else if (backEnd == Cpu) {
+        smv::getCpuKernels().softmaxNormalize(
+                inputTile->data<float16>(), outputTile->data<float16>(),
+                smv::spad0, smv::spad1, smv::spad2, inputShape[0],
+                inputShape[1], inputShape.getPadding(1));
+    }
+}
+
 void SmvSoftmaxOp::run() {
     TiledTensor& inputs = tiledTensors[0];
     TiledTensor& outputs = tiledTensors[1];
@@ -32,28 +116,27 @@ void SmvSoftmaxOp::run() {
             smv::kEltwiseOpHw, "host_inputs", getInputsMemType());
     setArrayMemTypeIfSimulating(
             smv::kEltwiseOpHw, "host_results", getOutputsMemType());
-    for (int i = 0; i < inputs.size(); i++) {
-        dout(1) << "Input: " << i << ", output: " << i << "\n";
-        Tensor* inputTile = inputs.getTileWithData(i);
-        Tensor* outputTile = outputs[i];
-        const TensorShape& inputShape = inputTile->getShape();
-        const TensorShape& outputShape = outputTile->getShape();
-        mapArrayToAccel(smv::kEltwiseOpHw, "host_inputs",
-                        inputTile->data<float16>(),
-                        inputShape.storageSize() * sizeof(float16));
-        mapArrayToAccel(smv::kEltwiseOpHw, "host_results",
-                        outputTile->data<float16>(),
-                        outputShape.storageSize() * sizeof(float16));
-        if (backEnd == Smv) {
-                invokeKernel(smv::kEltwiseOpHw, smv_softmax_nc_vec_fxp,
-                        inputTile->data<float16>(), outputTile->data<float16>(),
-                        smv::spad0, smv::spad1, inputShape[0], inputShape[1],
-                        inputShape.getPadding(1));
-        } else if (backEnd == Cpu) {
-                smv_softmax_nc_vec_fxp(
-                        inputTile->data<float16>(), outputTile->data<float16>(),
-                        smv::spad0, smv::spad1, inputShape[0], inputShape[1],
-                        inputShape.getPadding(1));
+    int numRowTiles = inputs.getShape()[0];
+    int numChanTiles = inputs.getShape()[1];
+    auto inputIdx = inputs.startIndex();
+    for (int n = 0; n < numRowTiles; n++) {
+        if (numChanTiles == 1) {
+            dout(1) << "Input: " << n << ", output: " << n << "\n";
+            runTile(inputs.getTileWithData(n), outputs[n]);
+            continue;
+        }
+        // The rows are split along C: the first pass over the tiles computes
+        // the softmax state of the rows, and the second one writes the
+        // results.
+        for (int c = 0; c < numChanTiles; c++) {
+            int index = inputIdx(n, c);
+            dout(1) << "Input: " << index << ", softmax state\n";
+            runStats(inputs.getTileWithData(index), c == 0);
+        }
+        for (int c = 0; c < numChanTiles; c++) {
+            int index = inputIdx(n, c);
+            dout(1) << "Input: " << index << ", output: " << index << "\n";
+            runNormalize(inputs.getTileWithData(index), outputs[index]);
         }
     }
     {
@@ -7,7 +7,14 @@
 
 namespace smaug {
 
-/** Softmax operator on SMV. */
+/**
+ * Softmax operator on SMV.
+ *
+ * Tiles hold whole rows when a row fits in the scratchpad. Longer rows are
+ * split along C: their softmax state (running maximum and sum of
+ * exponentials) is accumulated over the tiles of a row first, and the tiles
+ * are normalized with it in a second pass.
+ */
 class SmvSoftmaxOp : public SoftmaxOp<SmvBackend> {
    public:
     using SoftmaxOp<SmvBackend>::SoftmaxOp;
@@ -15,6 +22,13 @@ class SmvSoftmaxOp : public SoftmaxOp<SmvBackend> {
     void run() override;
 
    protected:
+    /** Runs the softmax on a tile that holds whole rows. */
+    void runTile(Tensor* inputTile, Tensor* outputTile);
+    /** Merges a tile into the softmax state of its rows. */
+    void runStats(Tensor* inputTile, bool initStats);
+    /** Normalizes a tile with the softmax state of its rows. */
+    void runNormalize(Tensor* inputTile, Tensor* outputTile);
+
     std::array<TiledTensor, 2> tiledTensors;
 };
 
@@ -1,9 +1,20 @@
+#include <algorithm>
+
 #include "smaug/operators/smv/smv_tiling_common.h"
 #include "smaug/core/tensor_utils.h"
+#include "smaug/operators/common.h"
+#include "smaug/utility/cpu_info.h"
+#include "smaug/utility/debug_stream.h"
 
 namespace smaug {
 namespace smv {
 
+// These match GEMM_MR of the GEMM kernel and the widest GEMM_NR of its
+// variants (see kernels/cpu_kernels.h), so that a block of B is a whole
+// number of panels for every instruction set.
+const int kGemmMR = 4;
+const int kGemmNR = 16;
+
 std::ostream& operator<<(std::ostream& os, const TilingDims& dims) {
   switch (dims) {
       case None:
@@ -67,5 +78,29 @@ bool needsWwiseTiling(TilingDims dim) {
     return (dim == DimNW) || (dim == DimNHW) || (dim == DimNCW);
 }
 
+GemmBlocking computeGemmBlocking(int rows, int cols, int chans) {
+    const CacheSizes& caches = getHostCacheSizes();
+    GemmBlocking blocking;
+    // The kernel unpacks the fp16 data a vector at a time.
+    int chansPerBlock = caches.l1d / 2 / (kGemmNR * sizeof(float));
+    chansPerBlock =
+            std::max(VECTOR_SIZE, chansPerBlock / VECTOR_SIZE * VECTOR_SIZE);
+    blocking.chansPerBlock = std::min(chans, chansPerBlock);
+    int rowsPerBlock =
+            caches.l2 / 2 / (blocking.chansPerBlock * sizeof(float));
+    rowsPerBlock = std::max(kGemmMR, rowsPerBlock / kGemmMR * kGemmMR);
+    blocking.rowsPerBlock =
+            std::min(rowsPerBlock, FRAC_CEIL(rows, kGemmMR) * kGemmMR);
+    int colsPerBlock =
+            caches.l3 / 2 / (blocking.chansPerBlock * sizeof(float));
+    colsPerBlock = std::max(kGemmNR, colsPerBlock / kGemmNR * kGemmNR);
+    blocking.colsPerBlock =
+            std::min(colsPerBlock, FRAC_CEIL(cols, kGemmNR) * kGemmNR);
+    dout(2) << "  GEMM blocking: " << blocking.rowsPerBlock << " x "
+            << blocking.colsPerBlock << " x " << blocking.chansPerBlock
+            << ", of " << rows << " x " << cols << " x " << chans << "\n";
+    return blocking;
+}
+
 }  // namespace smv
 }  // namespace smaug
@@ -46,6 +46,39 @@ struct TilingConfig {
     TilingDims outputTilingDims;
 };
 
+/** The number of rows of A in a block of the GEMM micro-kernel. */
+extern const int kGemmMR;
+/**
+ * The number of rows of B in a block of the GEMM micro-kernel, for the
+ * widest of its instruction sets.
+ */
+extern const int kGemmNR;
+
+/**
+ * Cache blocking of a GEMM that runs natively on the Cpu backend, i.e.
+ * results = A x B^T with A and B in NC layout.
+ */
+struct GemmBlocking {
+    /** The number of rows of A unpacked at a time. */
+    int rowsPerBlock = 0;
+    /** The number of rows of B unpacked at a time. */
+    int colsPerBlock = 0;
+    /** The number of columns of A and B unpacked at a time. */
+    int chansPerBlock = 0;
+};
+
+/**
+ * Determine the cache blocking of a GEMM of a rows x chans A with the
+ * transpose of a cols x chans B, from the detected cache sizes of the host.
+ *
+ * The columns are blocked so that a kGemmNR-row panel of B fits in half of
+ * the L1 cache, the rows so that a block of A fits in half of the L2 cache,
+ * and the rows of B so that a block of B fits in half of the L3 cache.
+ *
+ * @param chans The padded number of columns of A and B.
+ */
+GemmBlocking computeGemmBlocking(int rows, int cols, int chans);
+
 std::ostream& operator<<(std::ostream& os, const TilingDims& dims);
 std::ostream& operator<<(std::ostream& os, const TilingConfig& config);
 
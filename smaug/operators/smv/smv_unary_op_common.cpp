@@ -1,12 +1,14 @@
 #include "smaug/core/backend.h"
 #include "smaug/core/tensor_utils.h"
 #include "smaug/operators/common.h"
+#include "smaug/operators/smv/kernels/cpu_kernels.h"
 #include "smaug/operators/smv/smv_unary_op_common.h"
 #include "smaug/operators/smv/smv_relu_op.h"
 #include "smaug/operators/smv/smv_elu_op.h"
 #include "smaug/operators/smv/smv_tanh_op.h"
 #include "smaug/operators/smv/smv_sigmoid_op.h"
 #include "smaug/operators/smv/smv_kernels.h"
+#include "smaug/operators/smv/smv_perf_model.h"
 #include "smaug/utility/debug_stream.h"
 
 namespace smaug {
@@ -69,7 +71,21 @@ void runX(UnaryOp<SmvBackend>* op, TiledTensor& inputs, TiledTensor& outputs) {
         mapArrayToAccel(smv::kEltwiseOpHw, "host_results",
                         outputTile->data<float16>(),
                         outputShape.storageSize() * sizeof(float16));
+        op->recordTileTransfer(inputTile);
+        op->recordTileTransfer(outputTile);
+        if (op->isEstimating()) {
+            op->recordKernelEstimate(
+                    0, smv::model::vectorCycles(inputShape.storageSize()));
+            continue;
+        }
 
+        if (op->getBackEnd() == Cpu) {
+            getCpuKernels().activation(
+                    inputTile->data<float16>(), outputTile->data<float16>(),
+                    smv::spad0, smv::spad1, inputShape.storageSize(),
+                    actParams.first, actParams.second);
+            continue;
+        }
         invokeKernel(smv::kEltwiseOpHw, smv_activation_fun_nc_vec_fxp,
                      inputTile->data<float16>(), outputTile->data<float16>(),
                      smv::spad0, smv::spad1, inputShape.storageSize(),
@@ -13,6 +13,15 @@ using namespace smaug;
 
 namespace smaug {
 
+// Fills the tensor with inputs around 100 and a standard deviation of 10,
+// whose exponentials overflow unless the maximum of a row is subtracted.
+void fillTensorWithLargeRandomData(Tensor* tensor) {
+    fillTensorWithRandomData(tensor);
+    float16* dataPtr = tensor->data<float16>();
+    for (int i = 0; i < tensor->getShape().storageSize(); i++)
+        dataPtr[i] = fp16(fp32(dataPtr[i]) * 100 + 100);
+}
+
 class SmvUnaryOpTest : public SmaugTest {
    public:
     using SmaugTest::SmaugTest;
@@ -65,7 +74,10 @@ class SmvUnaryOpTest : public SmaugTest {
         return convertFp32ToFp16Tensor(refUnaryOp->getOutput(0), workspace());
     }
 
-    void doTest(OpType opType, std::vector<int> dims) {
+    void doTest(OpType opType,
+                std::vector<int> dims,
+                BackEndName_t backEnd = Smv,
+                FillTensorDataFunc fillFunc = fillTensorWithRandomData) {
         UnaryOp<SmvBackend>* unaryOp;
         if (opType == OpType::ReLU) {
             unaryOp = new SmvReluOp("relu", workspace());
@@ -95,8 +107,8 @@ class SmvUnaryOpTest : public SmaugTest {
         inputs->allocateStorage<float16>();
         workspace()->addTensor(inputs);
         unaryOp->setInput(inputs, 0);
-        createAndFillTensorsWithData<float16>(
-                unaryOp, fillTensorWithRandomData);
+        unaryOp->setBackEnd(backEnd);
+        createAndFillTensorsWithData<float16>(unaryOp, fillFunc);
         unaryOp->tile();
         unaryOp->run();
         auto outputs = unaryOp->getOutput(0);
@@ -167,3 +179,25 @@ TEST_CASE_METHOD(SmvUnaryOpTest, "SMV Tiled 2D Activations", "[smvunary]") {
     }
 }
 
+
+TEST_CASE_METHOD(SmvUnaryOpTest, "SMV softmax", "[smvunary]") {
+    SECTION("Sizes not multiples of the vector size") {
+        for (BackEndName_t backEnd : { Smv, Cpu })
+            doTest(OpType::Softmax, { 3, 1001 }, backEnd);
+    }
+    SECTION("Large inputs") {
+        for (BackEndName_t backEnd : { Smv, Cpu }) {
+            doTest(OpType::Softmax, { 4, 2048 }, backEnd,
+                   fillTensorWithLargeRandomData);
+        }
+    }
+    SECTION("Rows split along C") {
+        // Each row is split into 3 and 2 tiles, the last one being partial.
+        for (BackEndName_t backEnd : { Smv, Cpu }) {
+            doTest(OpType::Softmax, { 2, 40000 }, backEnd,
+                   fillTensorWithLargeRandomData);
+            doTest(OpType::Softmax, { 1, 20001 }, backEnd,
+                   fillTensorWithLargeRandomData);
+        }
+    }
+}
@@ -71,17 +71,33 @@ class SplitOp : public Operator {
         }
     }
 
+    /**
+     * Makes the outputs views into their slices of the input wherever the
+     * slices are contiguous (see getSliceViewOffset()).
+     */
+    void aliasOutputs() override {
+        int start = 0;
+        for (int i = 0; i < getOutputs().size(); i++) {
+            aliasTensorSlice(getOutput(i), getInput(0), splitAxis, start);
+            start += splits[i];
+        }
+    }
+
     void run() override {
         Tensor* input = getInput(0);
         int ndims = input->ndims();
-        std::vector<int> srcOrigin(ndims, 0);
+        TensorDims srcOrigin(ndims, 0);
         for (int i = 0; i < getOutputs().size(); i++) {
             Tensor* output = getOutput(i);
-            copyTensorRegion(output,
-                             input,
-                             std::vector<int>(ndims, 0),
-                             srcOrigin,
-                             output->getShape().dims());
+            int offset = getSliceViewOffset(
+                    input, output, splitAxis, srcOrigin[splitAxis]);
+            if (offset < 0 || !output->isViewOf(input, offset)) {
+                parallelCopyTensorRegion(output,
+                                         input,
+                                         TensorDims(ndims, 0),
+                                         srcOrigin,
+                                         output->getShape().dims());
+            }
             srcOrigin[splitAxis] += output->dim(splitAxis);
         }
     }
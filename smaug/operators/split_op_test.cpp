@@ -138,3 +138,57 @@ TEST_CASE_METHOD(SmaugTest, "Split a 2D tensor", "[refop]") {
         verifyOutputs(output1, expectedValues1);
     }
 }
+
+TEST_CASE_METHOD(SmaugTest, "Split into views of the input", "[refop]") {
+    auto splitOp = new SplitOp<ReferenceBackend>("split", workspace());
+    TensorShape inputShape({ 4, 8 }, DataLayout::NC);
+    Tensor* input = new Tensor("input", inputShape);
+    input->allocateStorage<float>();
+    std::vector<float> inputValues(32);
+    for (int i = 0; i < 32; i++)
+        inputValues[i] = i;
+    input->fillData(inputValues.data(), inputValues.size());
+    workspace()->addTensor(input);
+    splitOp->setInput(input, 0);
+
+    SECTION("Split axis 0, N dimension") {
+        splitOp->setSplitAxis(0);
+        splitOp->setSplits({ 1, 3 });
+        splitOp->createAllTensors();
+        allocateAllTensors<float>(splitOp);
+        splitOp->aliasOutputs();
+        auto output0 = splitOp->getOutput(0);
+        auto output1 = splitOp->getOutput(1);
+        // Each row takes a whole cacheline, so both splits are views.
+        REQUIRE(output0->isViewOf(input, 0));
+        REQUIRE(output1->isViewOf(input, 8));
+        splitOp->run();
+        verifyOutputs(output0, std::vector<float>(inputValues.begin(),
+                                                  inputValues.begin() + 8));
+        verifyOutputs(output1, std::vector<float>(inputValues.begin() + 8,
+                                                  inputValues.end()));
+    }
+
+    SECTION("Split axis 1, C dimension") {
+        splitOp->setSplitAxis(1);
+        splitOp->setSplits({ 2, 6 });
+        splitOp->createAllTensors();
+        allocateAllTensors<float>(splitOp);
+        // The splits are not contiguous, so they are copied.
+        splitOp->aliasOutputs();
+        auto output0 = splitOp->getOutput(0);
+        auto output1 = splitOp->getOutput(1);
+        REQUIRE_FALSE(output0->isView());
+        REQUIRE_FALSE(output1->isView());
+        splitOp->run();
+        std::vector<float> expectedValues0, expectedValues1;
+        for (int i = 0; i < 32; i++) {
+            if (i % 8 < 2)
+                expectedValues0.push_back(i);
+            else
+                expectedValues1.push_back(i);
+        }
+        verifyOutputs(output0, expectedValues0);
+        verifyOutputs(output1, expectedValues1);
+    }
+}
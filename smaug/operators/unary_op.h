@@ -40,6 +40,10 @@ class UnaryOp : public Operator {
         outputs[Outputs] = output;
     }
 
+    int64_t getNumFlops() const override {
+        return outputs.at(Outputs)->getShape().size();
+    }
+
     enum { Inputs, kNumInputs };
     enum { Outputs, kNumOutputs };
 };
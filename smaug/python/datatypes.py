@@ -9,6 +9,7 @@ np_to_smaug_type = {
     np.int32: types_pb2.Int32,
     np.int64: types_pb2.Int64,
     np.bool_: types_pb2.Bool,
+    np.int8: types_pb2.Int8,
 }
 
 class LayoutSet:
@@ -146,6 +146,14 @@ class Tensor:
         if self._tensor_data.size % 2 != 0:
           self._tensor_data = np.append(self._tensor_data, np.float16(0))
         self._tensor_data = self._tensor_data.view(np.int32)
+      # Likewise, we pack four int8 elements into one int32.
+      elif self._data_type == types_pb2.Int8:
+        self._tensor_data = self._tensor_data.flatten()
+        if self._tensor_data.size % 4 != 0:
+          self._tensor_data = np.append(
+              self._tensor_data,
+              np.zeros(4 - self._tensor_data.size % 4, dtype=np.int8))
+        self._tensor_data = self._tensor_data.view(np.int32)
 
       # Serialize the data into the proto.
       tensor_data_proto = tensor_data_array.data_array.add()
@@ -163,3 +171,5 @@ class Tensor:
         tensor_data_proto.int64_data.extend(data_list)
       elif self._data_type == types_pb2.Bool:
         tensor_data_proto.bool_data.extend(data_list)
+      elif self._data_type == types_pb2.Int8:
+        tensor_data_proto.int8_data.extend(data_list)
@@ -9,7 +9,10 @@
 #include "core/network_builder.h"
 #include "core/network_config.h"
 #include "core/backend_config.h"
+#include "core/roofline.h"
+#include "core/perf_estimate.h"
 #include "operators/common.h"
+#include "utility/cpu_info.h"
 #include "utility/debug_stream.h"
 #include "utility/utils.h"
 #include "utility/thread_pool.h"
@@ -27,13 +30,16 @@ int main(int argc, char* argv[]) {
     int debugLevel = -1;
     std::string lastOutputFile;
     bool dumpGraph = false;
+    bool printRoofline = false;
     runningInSimulation = false;
     SamplingInfo sampling;
     std::string samplingLevel = "no";
+    std::string cpuIsaName = "auto";
     sampling.num_sample_iterations = 1;
     numAcceleratorsAvailable = 1;
     numThreads = -1;
     useSystolicArrayWhenAvailable = false;
+    useInt8WhenAvailable = false;
     po::options_description options(
             "SMAUG Usage:  ./smaug model_topo.pbtxt model_params.pb [options]");
     // clang-format off
@@ -75,12 +81,31 @@ int main(int argc, char* argv[]) {
         ("use-systolic-array",
          po::value(&useSystolicArrayWhenAvailable)->implicit_value(true),
          "If the backend contains a systolic array, use it whenever possible.")
+        ("use-int8",
+         po::value(&useInt8WhenAvailable)->implicit_value(true),
+         "Run the convolution and inner product layers on the Cpu backend "
+         "with int8 weights (one scale per output channel) and int8 "
+         "activations (one scale per tensor).")
         ("network-config", 
          po::value<string>(&network_config_file)->default_value("layers.cfg"),
          "Configuration file for specifying hardware backends for different layers.")
         ("backend-config", 
          po::value<string>(&backend_config_file)->default_value("backend.cfg"),
          "Configuration file for specifying hardware backends properties.")
+        ("roofline", po::value(&printRoofline)->implicit_value(true),
+         "Print a per-layer roofline report (FLOPs, compulsory and actual "
+         "bytes moved, arithmetic intensity, achieved vs. peak throughput) "
+         "after the network finishes.")
+        ("estimate", po::value(&estimateMode)->implicit_value(true),
+         "Estimate the latency of the SMV layers with an analytical cycle and "
+         "DMA bandwidth model instead of running the kernels. The tiled "
+         "schedule is walked as in a real run, but the network output is "
+         "meaningless. The model can be calibrated with the computeCalibration "
+         "and dmaCalibration keys of the [smv] section of the backend config.")
+        ("cpu-isa",
+         po::value<string>(&cpuIsaName)->default_value("auto"),
+         "Instruction set of the kernels run by the Cpu backend. Options are "
+         "auto (detected from CPUID), sse, avx2 and avx512.")
         ;
     // clang-format on
 
@@ -154,6 +179,22 @@ int main(int argc, char* argv[]) {
                      "by 1.\n";
     }
 
+    if (estimateMode && runningInSimulation) {
+        std::cout << "--estimate cannot be used in gem5 simulation!\n";
+        exit(1);
+    }
+
+    if (cpuIsaName != "auto") {
+        CpuIsa cpuIsa;
+        if (!parseCpuIsa(cpuIsaName, &cpuIsa)) {
+            std::cout << "Doesn't support the specified Cpu instruction set: "
+                      << cpuIsaName << "\n";
+            exit(1);
+        }
+        setCpuIsa(cpuIsa);
+    }
+    std::cout << "Cpu kernels: " << getCpuIsaName(getCpuIsa()) << "\n";
+
     if (numThreads > 1) {
         std::cout << "Using a thread pool, size: " << numThreads << ".\n";
         threadPool = new ThreadPool(numThreads);
@@ -184,6 +225,11 @@ int main(int argc, char* argv[]) {
     Scheduler scheduler(network, workspace);
     Tensor* output = scheduler.runNetwork();
 
+    if (printRoofline)
+        printRooflineReport(network, backend_config);
+    if (estimateMode)
+        printEstimateReport(network, backend_config);
+
     if (!lastOutputFile.empty()) {
         if (lastOutputFile == "stdout") {
             std::cout << "Final network output:\n" << *output << "\n";
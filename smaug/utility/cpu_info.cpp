@@ -0,0 +1,132 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+#include "smaug/utility/cpu_info.h"
+
+namespace smaug {
+
+namespace {
+
+const CacheSizes kDefaultCacheSizes = { 32 * 1024, 1024 * 1024,
+                                        8 * 1024 * 1024 };
+
+// Reads the size of a data or unified cache level from sysfs. Returns 0 if
+// no such cache is described.
+int readSysfsCacheSize(int level) {
+    const std::string base = "/sys/devices/system/cpu/cpu0/cache/index";
+    for (int index = 0;; index++) {
+        std::ifstream levelFile(base + std::to_string(index) + "/level");
+        if (!levelFile)
+            return 0;
+        int cacheLevel = 0;
+        levelFile >> cacheLevel;
+        std::string type;
+        std::ifstream(base + std::to_string(index) + "/type") >> type;
+        if (cacheLevel != level || type == "Instruction")
+            continue;
+        std::string size;
+        std::ifstream(base + std::to_string(index) + "/size") >> size;
+        if (size.empty())
+            return 0;
+        int bytes = std::stoi(size);
+        if (size.back() == 'K')
+            bytes *= 1024;
+        else if (size.back() == 'M')
+            bytes *= 1024 * 1024;
+        return bytes;
+    }
+}
+
+int detectCacheSize(int level, int sysconfName, int defaultSize) {
+    long bytes = sysconfName >= 0 ? sysconf(sysconfName) : 0;
+    if (bytes <= 0)
+        bytes = readSysfsCacheSize(level);
+    return bytes > 0 ? bytes : defaultSize;
+}
+
+CacheSizes detectCacheSizes() {
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    const int l1Name = _SC_LEVEL1_DCACHE_SIZE;
+    const int l2Name = _SC_LEVEL2_CACHE_SIZE;
+    const int l3Name = _SC_LEVEL3_CACHE_SIZE;
+#else
+    const int l1Name = -1, l2Name = -1, l3Name = -1;
+#endif
+    CacheSizes sizes;
+    sizes.l1d = detectCacheSize(1, l1Name, kDefaultCacheSizes.l1d);
+    sizes.l2 = detectCacheSize(2, l2Name, kDefaultCacheSizes.l2);
+    sizes.l3 = detectCacheSize(3, l3Name, kDefaultCacheSizes.l3);
+    return sizes;
+}
+
+CpuIsa detectHostCpuIsa() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512vl") &&
+        __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512dq"))
+        return Avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+        __builtin_cpu_supports("f16c"))
+        return Avx2;
+    return Sse;
+}
+
+// The instruction set in use, which is the one of the host until it is
+// overridden.
+CpuIsa& activeCpuIsa() {
+    static CpuIsa isa = getHostCpuIsa();
+    return isa;
+}
+
+}  // namespace
+
+const CacheSizes& getHostCacheSizes() {
+    static const CacheSizes sizes = detectCacheSizes();
+    return sizes;
+}
+
+CpuIsa getHostCpuIsa() {
+    static const CpuIsa isa = detectHostCpuIsa();
+    return isa;
+}
+
+CpuIsa getCpuIsa() { return activeCpuIsa(); }
+
+bool setCpuIsa(CpuIsa isa) {
+    if (isa > getHostCpuIsa()) {
+        std::cerr << "[WARNING]: The host does not support "
+                  << getCpuIsaName(isa) << ", using "
+                  << getCpuIsaName(getHostCpuIsa()) << " instead.\n";
+        activeCpuIsa() = getHostCpuIsa();
+        return false;
+    }
+    activeCpuIsa() = isa;
+    return true;
+}
+
+const char* getCpuIsaName(CpuIsa isa) {
+    switch (isa) {
+        case Sse:
+            return "sse";
+        case Avx2:
+            return "avx2";
+        case Avx512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+bool parseCpuIsa(const std::string& name, CpuIsa* isa) {
+    for (CpuIsa candidate : { Sse, Avx2, Avx512 }) {
+        if (name == getCpuIsaName(candidate)) {
+            *isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace smaug
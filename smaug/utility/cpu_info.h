@@ -0,0 +1,61 @@
+#ifndef _UTILITY_CPU_INFO_H_
+#define _UTILITY_CPU_INFO_H_
+
+#include <string>
+
+namespace smaug {
+
+/**
+ * The data cache sizes of the host, in bytes.
+ *
+ * The L1 and L2 sizes are per core, while the L3 is shared by all the cores.
+ */
+struct CacheSizes {
+    int l1d;
+    int l2;
+    int l3;
+};
+
+/**
+ * Returns the data cache sizes of the host, which are detected on the first
+ * call. Any level that cannot be detected (e.g. when running in simulation)
+ * falls back to a typical size for a server core.
+ */
+const CacheSizes& getHostCacheSizes();
+
+/**
+ * The instruction sets that the kernels of the Cpu backend are built for.
+ *
+ * Sse is the baseline that the whole binary is compiled for. Avx2 also
+ * requires FMA and F16C, and Avx512 requires the F, VL, BW and DQ subsets.
+ */
+enum CpuIsa { Sse, Avx2, Avx512 };
+
+/** Returns the best instruction set of the host, detected from CPUID. */
+CpuIsa getHostCpuIsa();
+
+/**
+ * Returns the instruction set the Cpu backend runs its kernels with. This is
+ * the one of the host, unless it was overridden with setCpuIsa().
+ */
+CpuIsa getCpuIsa();
+
+/**
+ * Overrides the instruction set the Cpu backend runs its kernels with, e.g.
+ * to test every variant on one host. If the host does not support it, its
+ * own instruction set is used instead and false is returned.
+ */
+bool setCpuIsa(CpuIsa isa);
+
+/** Returns the name of an instruction set, as accepted by parseCpuIsa(). */
+const char* getCpuIsaName(CpuIsa isa);
+
+/**
+ * Parses the name of an instruction set ("sse", "avx2" or "avx512"). Returns
+ * false if the name is not recognized.
+ */
+bool parseCpuIsa(const std::string& name, CpuIsa* isa);
+
+}  // namespace smaug
+
+#endif
@@ -179,11 +179,16 @@ static inline __smaug256 __smaug_vcvtph2ps256(__m128i a) {
     _SW_CVT_PS_PH_256(p8_fp32_data, rounding_mode)
 #define _CVT_PH_PS_256(p8_fp16_data) _SW_CVT_PH_PS_256(p8_fp16_data)
 
-#elif defined(__F16C__)
+#elif defined(__F16C__) || defined(SMAUG_F16C)
 
+// SMAUG_F16C is defined by code built for F16C with a target pragma, under
+// which the C++ front end does not define __F16C__. The casts let C++
+// convert between the generic vectors of the kernels and those of the
+// intrinsics.
 #define _CVT_PS_PH_256(p8_fp32_data, rounding_mode)                    \
-    _mm256_cvtps_ph(p8_fp32_data, rounding_mode)
-#define _CVT_PH_PS_256(p8_fp16_data) _mm256_cvtph_ps(p8_fp16_data)
+    ((__v8hu)_mm256_cvtps_ph((__m256)(p8_fp32_data), rounding_mode))
+#define _CVT_PH_PS_256(p8_fp16_data)                                   \
+    ((__v8sf)_mm256_cvtph_ps((__m128i)(p8_fp16_data)))
 
 #elif defined(__USE_F16C_ANYWAYS__)
 